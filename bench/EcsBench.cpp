@@ -0,0 +1,82 @@
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "MicroBench.h"
+
+#include "../src/EcsSystems.h"
+#include "../src/GameObject.h"
+
+constexpr std::size_t ENTITY_COUNT = 100'000;
+constexpr glm::vec3 STEP(0.001f, 0.0f, 0.0f);
+
+static std::vector<glm::vec3> spawnPositions() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution coordinate(-500.0f, 500.0f);
+  std::vector<glm::vec3> positions(ENTITY_COUNT);
+
+  for (glm::vec3 &position : positions) {
+    position = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+  }
+
+  return positions;
+}
+
+/// The current path: every object owns its Transform and is updated through its methods.
+static void BM_GameObjectUpdate100k(Bench::State &state) {
+  std::vector<GameObject> objects(ENTITY_COUNT);
+  const std::vector<glm::vec3> positions = spawnPositions();
+
+  for (std::size_t i = 0; i < ENTITY_COUNT; i++) {
+    objects[i].getTransform().SetLocalPosition(positions[i]);
+  }
+
+  state.setItemsPerIteration(ENTITY_COUNT);
+
+  while (state.keepRunning()) {
+    for (GameObject &object : objects) {
+      object.getTransform().Translate(STEP);
+      Bench::doNotOptimize(object.getTransform().GetModelMatrix());
+    }
+  }
+}
+BENCHMARK(BM_GameObjectUpdate100k);
+
+static void BM_EcsUpdate100k(Bench::State &state) {
+  App::JobSystem jobs;
+  App::Ecs::Registry registry;
+
+  for (const glm::vec3 &position : spawnPositions()) {
+    registry.create(App::Ecs::Transform{.position = position});
+  }
+
+  state.setItemsPerIteration(ENTITY_COUNT);
+
+  while (state.keepRunning()) {
+    registry.query<App::Ecs::Transform>().parallelEach(
+        jobs, [](App::Ecs::Transform &transform) { transform.position += STEP; });
+    App::Ecs::updateTransforms(registry, jobs);
+  }
+}
+BENCHMARK(BM_EcsUpdate100k);
+
+/// What skeleton.vert used to do for every vertex, now done once per visible object before drawing.
+static void BM_ComputeDrawMatrices100k(Bench::State &state) {
+  const glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+  std::vector<App::Ecs::MeshDraw> draws;
+  draws.reserve(ENTITY_COUNT);
+
+  for (const glm::vec3 &position : spawnPositions()) {
+    const glm::mat4 world = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(1.0f, 2.0f, 0.5f));
+    draws.push_back({.mesh = nullptr, .material = nullptr, .renderMode = GL_TRIANGLES, .world = world});
+  }
+
+  state.setItemsPerIteration(ENTITY_COUNT);
+
+  while (state.keepRunning()) {
+    App::Ecs::computeDrawMatrices(draws, viewProjection);
+    Bench::doNotOptimize(draws.back().normalMatrix);
+  }
+}
+BENCHMARK(BM_ComputeDrawMatrices100k);
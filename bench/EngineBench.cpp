@@ -0,0 +1,222 @@
+#include <array>
+#include <cmath>
+#include <memory>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "MicroBench.h"
+
+#include "../src/Cache.h"
+#include "../src/ClusteredLighting.h"
+#include "../src/ModelLoader.h"
+#include "../src/Transform.h"
+
+#include "../src/Config.h"
+
+constexpr int HIERARCHY_DEPTH = 64;
+constexpr int FOREST_ROOTS = 1000;
+constexpr int FOREST_CHILDREN = 9;
+constexpr unsigned int SPHERE_SEGMENTS = 256; // ~66k vertices and ~130k triangles
+
+/// Cheap to build, so the cache benchmarks only measure the key building and the lookup.
+struct CachedResource {
+  explicit CachedResource(const std::string &vertexName, const std::string &fragmentName = {})
+      : name(vertexName + fragmentName) {
+  }
+
+  std::string name;
+};
+
+/// Every frame looks its shaders up like this: `g_shaderCache.get("chunk")`.
+static void BM_CacheGetHit(Bench::State &state) {
+  Cache<CachedResource> cache;
+  cache.get("chunk");
+
+  while (state.keepRunning()) {
+    Bench::doNotOptimize(cache.get("chunk"));
+  }
+}
+BENCHMARK(BM_CacheGetHit);
+
+/// Materials look their shader up with two arguments, the key grows with each of them.
+static void BM_CacheGetHitTwoArguments(Bench::State &state) {
+  Cache<CachedResource> cache;
+  cache.get(App::Config::Renderer::DEFAULT_VERTEX_SHADER, App::Config::Renderer::DEFAULT_FRAGMENT_SHADER);
+
+  while (state.keepRunning()) {
+    Bench::doNotOptimize(
+        cache.get(App::Config::Renderer::DEFAULT_VERTEX_SHADER, App::Config::Renderer::DEFAULT_FRAGMENT_SHADER));
+  }
+}
+BENCHMARK(BM_CacheGetHitTwoArguments);
+
+/// A chain of transforms, each a child of the previous one.
+static std::vector<std::unique_ptr<Transform>> transformChain() {
+  std::vector<std::unique_ptr<Transform>> chain;
+
+  for (int i = 0; i < HIERARCHY_DEPTH; i++) {
+    auto transform = std::make_unique<Transform>();
+    transform->SetLocalPosition(glm::vec3(1.0f, 0.5f, 0.0f));
+    transform->SetLocalEulerAngles(glm::vec3(0.0f, 10.0f, 5.0f));
+
+    if (!chain.empty()) {
+      transform->SetParent(chain.back().get(), false);
+    }
+
+    chain.push_back(std::move(transform));
+  }
+
+  return chain;
+}
+
+/// Moving the root dirties the whole chain, the leaf then recomputes every matrix above it.
+static void BM_TransformDeepHierarchyDirty(Bench::State &state) {
+  const auto chain = transformChain();
+  Transform &root = *chain.front();
+  const Transform &leaf = *chain.back();
+
+  state.setItemsPerIteration(HIERARCHY_DEPTH);
+
+  while (state.keepRunning()) {
+    root.Translate(glm::vec3(0.001f, 0.0f, 0.0f));
+    Bench::doNotOptimize(leaf.GetModelMatrix());
+  }
+}
+BENCHMARK(BM_TransformDeepHierarchyDirty);
+
+static void BM_TransformDeepHierarchyCached(Bench::State &state) {
+  const auto chain = transformChain();
+  const Transform &leaf = *chain.back();
+  Bench::doNotOptimize(leaf.GetModelMatrix());
+
+  while (state.keepRunning()) {
+    Bench::doNotOptimize(leaf.GetModelMatrix());
+  }
+}
+BENCHMARK(BM_TransformDeepHierarchyCached);
+
+/// Scene graph sized like a busy level: every root moves each frame, the system then refreshes all 10k transforms.
+static void BM_TransformSystemUpdate(Bench::State &state) {
+  std::vector<std::unique_ptr<Transform>> roots;
+  std::vector<std::unique_ptr<Transform>> children;
+
+  for (int i = 0; i < FOREST_ROOTS; i++) {
+    Transform *parent = roots.emplace_back(std::make_unique<Transform>()).get();
+    parent->SetLocalPosition(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+
+    for (int j = 0; j < FOREST_CHILDREN; j++) {
+      Transform &child = *children.emplace_back(std::make_unique<Transform>());
+      child.SetLocalPosition(glm::vec3(0.0f, 1.0f, 0.0f));
+      child.SetParent(parent, false);
+      parent = &child;
+    }
+  }
+
+  state.setItemsPerIteration(FOREST_ROOTS * (FOREST_CHILDREN + 1));
+
+  while (state.keepRunning()) {
+    for (const auto &root : roots) {
+      root->Rotate(glm::vec3(0.0f, 1.0f, 0.0f), 1.0f);
+    }
+
+    TransformSystem::getInstance().update();
+    Bench::doNotOptimize(children.back()->GetModelMatrix());
+  }
+}
+BENCHMARK(BM_TransformSystemUpdate);
+
+/// Torches on a 32 x 32 grid spanning the view, each reaching about 24 blocks: the clustered lighting target.
+static std::vector<Light> torchField() {
+  std::vector<Light> torches;
+
+  for (int z = 0; z < 32; z++) {
+    for (int x = 0; x < 32; x++) {
+      const glm::vec3 position(static_cast<float>(x - 16) * 8.0f, 2.0f, -static_cast<float>(z) * 8.0f);
+      torches.push_back(Light::Point(position, glm::vec4(1.0f, 0.6f, 0.25f, 1.0f), 1.0f, 1.0f, 0.35f, 0.44f));
+    }
+  }
+
+  return torches;
+}
+
+static void BM_AssignLightClusters1k(Bench::State &state) {
+  const std::vector<Light> torches = torchField();
+  const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 16.0f, 16.0f), glm::vec3(0.0f, 0.0f, -64.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+  const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, App::Config::Renderer::NEAR_PLANE,
+                                                App::Config::Renderer::FAR_PLANE);
+  App::FrameArena arena(App::Config::Renderer::FRAME_ARENA_BYTES);
+  state.setItemsPerIteration(torches.size());
+
+  while (state.keepRunning()) {
+    arena.reset();
+    Bench::doNotOptimize(App::assignLightClusters(torches, view, projection, glm::vec2(1920.0f, 1080.0f), arena));
+  }
+}
+BENCHMARK(BM_AssignLightClusters1k);
+
+/// UV sphere with everything an imported model has: normals, texture coordinates and tangents.
+static std::unique_ptr<aiMesh> sphereMesh() {
+  constexpr unsigned int rowVertices = SPHERE_SEGMENTS + 1;
+  auto mesh = std::make_unique<aiMesh>();
+
+  mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+  mesh->mNumVertices = rowVertices * rowVertices;
+  mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+  mesh->mNormals = new aiVector3D[mesh->mNumVertices];
+  mesh->mTangents = new aiVector3D[mesh->mNumVertices];
+  mesh->mBitangents = new aiVector3D[mesh->mNumVertices];
+  mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+  mesh->mNumUVComponents[0] = 2;
+
+  for (unsigned int row = 0; row < rowVertices; row++) {
+    const float v = static_cast<float>(row) / SPHERE_SEGMENTS;
+    const float theta = v * std::numbers::pi_v<float>;
+
+    for (unsigned int column = 0; column < rowVertices; column++) {
+      const float u = static_cast<float>(column) / SPHERE_SEGMENTS;
+      const float phi = u * 2.0f * std::numbers::pi_v<float>;
+      const aiVector3D normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+      const unsigned int index = row * rowVertices + column;
+
+      mesh->mVertices[index] = normal;
+      mesh->mNormals[index] = normal;
+      mesh->mTangents[index] = aiVector3D(-std::sin(phi), 0.0f, std::cos(phi));
+      mesh->mBitangents[index] = normal ^ mesh->mTangents[index];
+      mesh->mTextureCoords[0][index] = aiVector3D(u, v, 0.0f);
+    }
+  }
+
+  mesh->mNumFaces = SPHERE_SEGMENTS * SPHERE_SEGMENTS * 2;
+  mesh->mFaces = new aiFace[mesh->mNumFaces];
+
+  for (unsigned int row = 0, face = 0; row < SPHERE_SEGMENTS; row++) {
+    for (unsigned int column = 0; column < SPHERE_SEGMENTS; column++) {
+      const unsigned int corner = row * rowVertices + column;
+
+      for (const std::array<unsigned int, 3> triangle :
+           {std::array{corner, corner + rowVertices, corner + 1},
+            std::array{corner + 1, corner + rowVertices, corner + rowVertices + 1}}) {
+        aiFace &target = mesh->mFaces[face++];
+        target.mNumIndices = 3;
+        target.mIndices = new unsigned int[3]{triangle[0], triangle[1], triangle[2]};
+      }
+    }
+  }
+
+  return mesh;
+}
+
+static void BM_ModelLoaderProcessMesh(Bench::State &state) {
+  const auto mesh = sphereMesh();
+  const aiScene scene;
+  state.setItemsPerIteration(mesh->mNumVertices);
+
+  while (state.keepRunning()) {
+    Bench::doNotOptimize(ModelLoader::processMesh(mesh.get(), &scene));
+  }
+}
+BENCHMARK(BM_ModelLoaderProcessMesh);
@@ -0,0 +1,128 @@
+#include "HeadlessContext.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <spdlog/spdlog.h>
+
+#include "../src/Config.h"
+#include "../src/StreamBuffer.h"
+
+namespace Bench {
+
+static bool hasExtension(const char *extensions, const std::string_view name) {
+  if (!extensions) {
+    return false;
+  }
+
+  for (std::string_view list(extensions); !list.empty();) {
+    const std::size_t end = std::min(list.find(' '), list.size());
+
+    if (list.substr(0, end) == name) {
+      return true;
+    }
+
+    list.remove_prefix(std::min(end + 1, list.size()));
+  }
+
+  return false;
+}
+
+HeadlessContext::~HeadlessContext() {
+  if (m_display == EGL_NO_DISPLAY) {
+    return;
+  }
+
+  eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+  if (m_context != EGL_NO_CONTEXT) {
+    eglDestroyContext(m_display, m_context);
+  }
+
+  if (m_surface != EGL_NO_SURFACE) {
+    eglDestroySurface(m_display, m_surface);
+  }
+
+  eglTerminate(m_display);
+}
+
+bool HeadlessContext::create() {
+  const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+  if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+    const auto getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay) {
+      m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+  }
+
+  if (m_display == EGL_NO_DISPLAY) {
+    m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr)) {
+    SPDLOG_CRITICAL("Couldn't initialize an EGL display (error 0x{:x})", eglGetError());
+    m_display = EGL_NO_DISPLAY;
+    return false;
+  }
+
+  const bool surfaceless = hasExtension(eglQueryString(m_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+
+  const EGLint configAttributes[] = {
+      EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE,
+  };
+
+  EGLConfig config = nullptr;
+  EGLint configCount = 0;
+
+  if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(m_display, configAttributes, &config, 1, &configCount) ||
+      configCount == 0) {
+    SPDLOG_CRITICAL("No EGL config supports desktop OpenGL (error 0x{:x})", eglGetError());
+    return false;
+  }
+
+  const EGLint contextAttributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION,
+      App::Config::Core::OPENGL_VERSION_MAJOR,
+      EGL_CONTEXT_MINOR_VERSION,
+      App::Config::Core::OPENGL_VERSION_MINOR,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK,
+      EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE,
+  };
+
+  m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttributes);
+
+  if (m_context == EGL_NO_CONTEXT) {
+    SPDLOG_CRITICAL("Couldn't create an OpenGL {}.{} core context (error 0x{:x})",
+                    App::Config::Core::OPENGL_VERSION_MAJOR, App::Config::Core::OPENGL_VERSION_MINOR, eglGetError());
+    return false;
+  }
+
+  if (!surfaceless) {
+    constexpr EGLint pbufferAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+    m_surface = eglCreatePbufferSurface(m_display, config, pbufferAttributes);
+  }
+
+  if (!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+    SPDLOG_CRITICAL("Couldn't make the EGL context current (error 0x{:x})", eglGetError());
+    return false;
+  }
+
+  if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+    SPDLOG_CRITICAL("Couldn't load the OpenGL functions");
+    return false;
+  }
+
+  App::StreamBuffer::loadExtensions(reinterpret_cast<GLADloadproc>(eglGetProcAddress));
+
+  m_current = true;
+  return true;
+}
+
+} // namespace Bench
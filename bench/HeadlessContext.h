@@ -0,0 +1,32 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+namespace Bench {
+
+/// OpenGL core context without a window, for benchmarks running on machines without a display (Mesa llvmpipe on CI).
+/// Prefers Mesa's surfaceless platform and falls back to the default display with a 1x1 pbuffer when the driver
+/// cannot make a context current without a surface.
+class HeadlessContext {
+public:
+  HeadlessContext() = default;
+  ~HeadlessContext();
+
+  HeadlessContext(const HeadlessContext &) = delete;
+  HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+  /// Creates the context, makes it current and loads the OpenGL functions. Returns false (and logs why) on failure.
+  bool create();
+
+  [[nodiscard]] bool isCurrent() const {
+    return m_current;
+  }
+
+private:
+  EGLDisplay m_display = EGL_NO_DISPLAY;
+  EGLSurface m_surface = EGL_NO_SURFACE;
+  EGLContext m_context = EGL_NO_CONTEXT;
+  bool m_current = false;
+};
+
+} // namespace Bench
@@ -0,0 +1,67 @@
+// Chunk meshing with and without baked ambient occlusion, the CPU side of what BM_ScreenSpaceAmbientOcclusion
+// (RenderBench) spends on the GPU every frame instead.
+
+#include <cstdlib>
+#include <vector>
+
+#include "MicroBench.h"
+
+#include "../src/ChunkMesher.h"
+#include "../src/TerrainGenerator.h"
+
+constexpr int MESHING_RADIUS = 3; // In chunks around the origin
+
+static const ChunkMap &meshingWorld() {
+  static const ChunkMap chunks = [] {
+    ChunkMap map;
+    const TerrainGenerator generator(App::Config::World::SEED);
+
+    // One ring more than is meshed, so the meshed chunks see neighbours on every side
+    for (int z = -MESHING_RADIUS - 1; z <= MESHING_RADIUS + 1; z++) {
+      for (int x = -MESHING_RADIUS - 1; x <= MESHING_RADIUS + 1; x++) {
+        for (int y = App::Config::World::MIN_CHUNK_Y; y <= App::Config::World::MAX_CHUNK_Y; y++) {
+          generator.generate(map.getOrCreate({x, y, z}));
+        }
+      }
+    }
+
+    return map;
+  }();
+
+  return chunks;
+}
+
+/// Chunks with blocks within MESHING_RADIUS, the ones the world would mesh at full resolution.
+static std::vector<const Chunk *> meshedChunks() {
+  std::vector<const Chunk *> chunks;
+
+  for (const auto &[coord, chunk] : meshingWorld()) {
+    if (!chunk->isEmpty() && std::abs(coord.x) <= MESHING_RADIUS && std::abs(coord.z) <= MESHING_RADIUS) {
+      chunks.push_back(chunk.get());
+    }
+  }
+
+  return chunks;
+}
+
+static void meshChunks(Bench::State &state, const bool ambientOcclusion) {
+  const ChunkMap &world = meshingWorld();
+  const std::vector<const Chunk *> chunks = meshedChunks();
+  state.setItemsPerIteration(chunks.size());
+
+  while (state.keepRunning()) {
+    for (const Chunk *chunk : chunks) {
+      Bench::doNotOptimize(ChunkMesher::build(world, *chunk, 0, 0, ambientOcclusion));
+    }
+  }
+}
+
+static void BM_ChunkMeshing(Bench::State &state) {
+  meshChunks(state, false);
+}
+BENCHMARK(BM_ChunkMeshing);
+
+static void BM_ChunkMeshingBakedAmbientOcclusion(Bench::State &state) {
+  meshChunks(state, true);
+}
+BENCHMARK(BM_ChunkMeshingBakedAmbientOcclusion);
@@ -0,0 +1,131 @@
+#include "MicroBench.h"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+#include <spdlog/spdlog.h>
+
+namespace Bench {
+
+struct Benchmark {
+  std::string name;
+  Function function;
+};
+
+struct Result {
+  std::string name;
+  std::size_t iterations;
+  double nsPerIteration;
+  double itemsPerSecond;
+  std::string error; // Set when the benchmark was skipped
+};
+
+static std::vector<Benchmark> &registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+bool registerBenchmark(const std::string &name, Function function) {
+  registry().push_back({name, std::move(function)});
+  return true;
+}
+
+/// Grows the iteration count until a run lasts long enough to be measured reliably.
+static Result run(const Benchmark &benchmark, const double minSeconds) {
+  std::size_t iterations = 1;
+
+  while (true) {
+    State state(iterations);
+    benchmark.function(state);
+
+    if (!state.error().empty()) {
+      return {benchmark.name, 0, 0.0, 0.0, state.error()};
+    }
+
+    const double seconds = std::chrono::duration<double>(state.elapsed()).count();
+
+    if (seconds >= minSeconds || iterations >= 1'000'000'000) {
+      const double nsPerIteration = seconds * 1e9 / static_cast<double>(iterations);
+      const double itemsPerSecond =
+          seconds > 0.0 ? static_cast<double>(iterations * state.itemsPerIteration()) / seconds : 0.0;
+      return {benchmark.name, iterations, nsPerIteration, itemsPerSecond, {}};
+    }
+
+    // Aim 40% past the target to avoid another round, without growing more than 10x at once
+    const double predicted = seconds > 0.0 ? minSeconds * 1.4 / seconds * static_cast<double>(iterations)
+                                           : static_cast<double>(iterations) * 10.0;
+    iterations = std::clamp(static_cast<std::size_t>(predicted), iterations + 1, iterations * 10);
+  }
+}
+
+} // namespace Bench
+
+int main(const int argc, char *argv[]) {
+  bool json = false;
+  std::string filter;
+  double minSeconds = 0.25;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      minSeconds = std::stod(argv[++i]);
+    } else {
+      std::cerr << "Usage: " << argv[0] << " [--json] [--filter <substring>] [--min-time <seconds>]\n";
+      return 1;
+    }
+  }
+
+  spdlog::set_level(spdlog::level::warn);
+
+  std::vector<Bench::Result> results;
+
+  for (const Bench::Benchmark &benchmark : Bench::registry()) {
+    if (!filter.empty() && !benchmark.name.contains(filter)) {
+      continue;
+    }
+
+    results.push_back(Bench::run(benchmark, minSeconds));
+
+    if (!json) {
+      const auto &[name, iterations, nsPerIteration, itemsPerSecond, error] = results.back();
+
+      if (!error.empty()) {
+        std::cout << std::format("{:<48} skipped: {}\n", name, error);
+        continue;
+      }
+
+      std::cout << std::format("{:<48} {:>14.1f} ns {:>12} it {:>16.0f} items/s\n", name, nsPerIteration, iterations,
+                               itemsPerSecond);
+    }
+  }
+
+  if (json) {
+    // One object per benchmark so results can be diffed between commits
+    std::cout << "[\n";
+
+    for (std::size_t i = 0; i < results.size(); i++) {
+      const auto &[name, iterations, nsPerIteration, itemsPerSecond, error] = results[i];
+      const char *separator = i + 1 < results.size() ? "," : "";
+
+      if (!error.empty()) {
+        std::cout << std::format(R"(  {{"name": "{}", "skipped": true, "error": "{}"}}{})", name, error, separator)
+                  << "\n";
+        continue;
+      }
+
+      std::cout << std::format(R"(  {{"name": "{}", "iterations": {}, "ns_per_iteration": {:.3f}, )"
+                               R"("items_per_second": {:.3f}}}{})",
+                               name, iterations, nsPerIteration, itemsPerSecond, separator)
+                << "\n";
+    }
+
+    std::cout << "]\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Minimal in-tree micro benchmark harness, modelled on Google Benchmark:
+///
+///   void BM_Something(Bench::State &state) {
+///     // setup, not timed
+///     while (state.keepRunning()) {
+///       Bench::doNotOptimize(work());
+///     }
+///   }
+///   BENCHMARK(BM_Something);
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+class State {
+public:
+  explicit State(const std::size_t iterations) : m_iterations(iterations), m_remaining(iterations) {
+  }
+
+  /// Times everything between its first and its last call.
+  bool keepRunning() {
+    if (!m_error.empty()) {
+      return false;
+    }
+
+    if (!m_started) {
+      m_started = true;
+      m_start = Clock::now();
+    }
+
+    if (m_remaining == 0) {
+      m_elapsed = Clock::now() - m_start;
+      return false;
+    }
+
+    m_remaining--;
+    return true;
+  }
+
+  [[nodiscard]] std::size_t iterations() const {
+    return m_iterations;
+  }
+
+  /// Work items handled by one iteration (e.g. rays per batch), reported as items per second.
+  void setItemsPerIteration(const std::size_t items) {
+    m_itemsPerIteration = items;
+  }
+
+  [[nodiscard]] std::size_t itemsPerIteration() const {
+    return m_itemsPerIteration;
+  }
+
+  [[nodiscard]] Clock::duration elapsed() const {
+    return m_elapsed;
+  }
+
+  /// Reports the benchmark as skipped instead of timing it, e.g. when it needs an OpenGL context that isn't there.
+  void skipWithError(std::string error) {
+    m_error = std::move(error);
+  }
+
+  [[nodiscard]] const std::string &error() const {
+    return m_error;
+  }
+
+private:
+  std::size_t m_iterations;
+  std::size_t m_remaining;
+  std::size_t m_itemsPerIteration = 1;
+  bool m_started = false;
+  Clock::time_point m_start{};
+  Clock::duration m_elapsed{};
+  std::string m_error;
+};
+
+using Function = std::function<void(State &)>;
+
+bool registerBenchmark(const std::string &name, Function function);
+
+/// Keeps the compiler from optimizing away a value that is otherwise unused.
+template <class T> void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+} // namespace Bench
+
+#define BENCHMARK(function) static const bool function##Registered = Bench::registerBenchmark(#function, function)
@@ -0,0 +1,355 @@
+// Renders the regular scene offscreen along a scripted camera path and reports frame statistics as JSON. Runs
+// without a display server through EGL, so Mesa's llvmpipe on a CI machine is enough. With --pacing it also measures
+// the input to submit latency of a presentation mode, presenting to a simulated display. With --pipelined each frame
+// is prepared on the pipeline's thread while the one before is submitted, as in the game.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include "HeadlessContext.h"
+
+#include "../src/Container.h"
+#include "../src/MemoryAccounting.h"
+
+using namespace App;
+
+struct Options {
+  int frames = 600;
+  int warmupFrames = 60;
+  int width = 1280;
+  int height = 720;
+  std::string tracePath;  // Chrome trace of the last frames, skipped when empty
+  std::string memoryPath; // Memory totals by subsystem once the path is flown, skipped when empty
+  bool pipelined = false;
+  // Paced like the game instead of finishing every frame, presenting to a simulated display
+  std::optional<PresentMode> pacing;
+  int refreshRate = 60;
+};
+
+/// Color and depth targets the frames are rendered into, in place of a window's default framebuffer.
+class OffscreenTarget {
+public:
+  OffscreenTarget(const int width, const int height) {
+    glGenFramebuffers(1, &m_framebuffer);
+    glGenRenderbuffers(2, m_renderbuffers);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_renderbuffers[1]);
+  }
+
+  ~OffscreenTarget() {
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(2, m_renderbuffers);
+  }
+
+  OffscreenTarget(const OffscreenTarget &) = delete;
+  OffscreenTarget &operator=(const OffscreenTarget &) = delete;
+
+  [[nodiscard]] bool isComplete() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+  }
+
+private:
+  GLuint m_framebuffer = 0;
+  GLuint m_renderbuffers[2] = {};
+};
+
+/// Circles above the origin while looking down at the terrain ahead, so the view sweeps over new chunks and LODs.
+static void placeCamera(const int frame, const int frameCount) {
+  constexpr float radius = 96.0f;
+  constexpr float height = 40.0f;
+  const float angle = 2.0f * std::numbers::pi_v<float> * static_cast<float>(frame) / static_cast<float>(frameCount);
+
+  const glm::vec3 position(radius * std::cos(angle), height, radius * std::sin(angle));
+  const glm::vec3 ahead(radius * std::cos(angle + 0.3f), 0.0f, radius * std::sin(angle + 0.3f));
+  g_camera.lookAt(position, ahead);
+}
+
+static void drawFrame(const Options &options) {
+  // Until the packet prepared last frame is acquired, the world belongs to the pipeline's thread
+  const FramePacket *acquired = options.pipelined ? g_framePipeline.acquire() : nullptr;
+  g_world.update(g_camera.getPosition());
+
+  const auto [r, g, b] = Config::Window::CLEAR_COLOR;
+  glViewport(0, 0, options.width, options.height);
+  glClearColor(r, g, b, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  if (options.pipelined) {
+    Window::renderPipelinedOpenGlData(acquired);
+  } else {
+    Window::renderOpenGlData();
+  }
+}
+
+static void renderFrame(const Options &options) {
+  drawFrame(options);
+
+  // Software rasterizers work asynchronously too, the frame is only done once its pixels are
+  glFinish();
+}
+
+/// Stands in for a swap on a display refreshing at `refreshRate`, there is no window to present to. With a swap
+/// interval the frame waits for the next vertical blank, adaptive vsync only when it made the blank it was aiming
+/// for. Drivers only block once their queue is full, but once it is this is where the wait ends up every frame.
+class SimulatedDisplay {
+public:
+  using Clock = FramePacer::Clock;
+
+  explicit SimulatedDisplay(const int refreshRate)
+      : m_period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / refreshRate))) {
+  }
+
+  void present(const PresentMode mode) {
+    glFlush();
+
+    const int interval = FramePacer::swapInterval(mode);
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point blank = m_start + (now - m_start + m_period - Clock::duration(1)) / m_period * m_period;
+    const bool late = blank - m_lastBlank > m_period;
+
+    if (interval > 0 || (interval < 0 && !late)) {
+      std::this_thread::sleep_until(blank);
+    }
+
+    m_lastBlank = blank;
+  }
+
+private:
+  Clock::duration m_period;
+  Clock::time_point m_start = Clock::now();
+  Clock::time_point m_lastBlank = m_start;
+};
+
+/// Input to submit latency of each frame under `options.pacing`: the camera moves as if by input, the frame is drawn
+/// and presented, the latency is taken once the present returns and the pacer holds the next frame back.
+static std::vector<double> measurePacing(const Options &options) {
+  SimulatedDisplay display(options.refreshRate);
+  g_framePacer.setMode(*options.pacing);
+  g_framePacer.resetLatency();
+
+  std::vector<double> latenciesMs;
+
+  for (int frame = -options.warmupFrames; frame < options.frames; frame++) {
+    placeCamera(std::max(frame, 0), options.frames);
+    drawFrame(options);
+    display.present(*options.pacing);
+
+    const FramePacket *packet = g_framePipeline.getLastPacket();
+    g_framePacer.endFrame(packet ? std::optional(packet->view.inputTime) : std::nullopt);
+    g_framePacer.waitForNextFrame();
+
+    if (frame >= 0) {
+      latenciesMs.push_back(g_framePacer.getLatency(*options.pacing).lastMs);
+    }
+  }
+
+  glFinish();
+  return latenciesMs;
+}
+
+static std::optional<PresentMode> parsePresentMode(const std::string_view name) {
+  constexpr std::array<std::pair<std::string_view, PresentMode>, PRESENT_MODE_COUNT> names{{
+      {"vsync", PresentMode::Vsync},
+      {"adaptive", PresentMode::AdaptiveVsync},
+      {"uncapped", PresentMode::Uncapped},
+      {"limited", PresentMode::Limited},
+      {"low-latency", PresentMode::LowLatency},
+  }};
+
+  for (const auto &[candidate, mode] : names) {
+    if (candidate == name) {
+      return mode;
+    }
+  }
+
+  return std::nullopt;
+}
+
+template <class T> static T percentile(std::vector<T> sorted, const double fraction) {
+  std::ranges::sort(sorted);
+  const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+  return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+template <class T> static double mean(const std::vector<T> &values) {
+  double sum = 0.0;
+
+  for (const T value : values) {
+    sum += static_cast<double>(value);
+  }
+
+  return values.empty() ? 0.0 : sum / static_cast<double>(values.size());
+}
+
+static std::optional<Options> parseOptions(const int argc, char *argv[]) {
+  Options options;
+
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+
+    if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+      options.frames = std::max(std::stoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+      options.warmupFrames = std::max(std::stoi(argv[++i]), 0);
+    } else if (std::strcmp(argv[i], "--width") == 0 && hasValue) {
+      options.width = std::max(std::stoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--height") == 0 && hasValue) {
+      options.height = std::max(std::stoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--trace") == 0 && hasValue) {
+      options.tracePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--memory") == 0 && hasValue) {
+      options.memoryPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--pacing") == 0 && hasValue) {
+      options.pacing = parsePresentMode(argv[++i]);
+
+      if (!options.pacing) {
+        std::cerr << "Unknown pacing mode: " << argv[i] << "\n";
+        return std::nullopt;
+      }
+    } else if (std::strcmp(argv[i], "--refresh") == 0 && hasValue) {
+      options.refreshRate = std::max(std::stoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--pipelined") == 0) {
+      options.pipelined = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--frames <n>] [--warmup <n>] [--width <px>] [--height <px>] [--trace <file>]"
+                   " [--memory <file>] [--pacing vsync|adaptive|uncapped|limited|low-latency] [--refresh <hz>]"
+                   " [--pipelined]\n";
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+
+int main(const int argc, char *argv[]) {
+  const std::optional<Options> options = parseOptions(argc, argv);
+
+  if (!options) {
+    return 1;
+  }
+
+  spdlog::set_level(spdlog::level::warn);
+
+  Bench::HeadlessContext headless;
+
+  if (!headless.create()) {
+    return 1;
+  }
+
+  g_container.init();
+  g_framePipeline.setPipelined(options->pipelined);
+  g_imguiManager.setupHeadless(static_cast<float>(options->width), static_cast<float>(options->height));
+
+  glEnable(GL_DEPTH_TEST);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  Window::setupScene();
+
+  const OffscreenTarget target(options->width, options->height);
+
+  if (!target.isComplete()) {
+    SPDLOG_CRITICAL("The offscreen framebuffer is incomplete");
+    return 1;
+  }
+
+  // Streaming and meshing would otherwise dominate the first frames, let the world around the start settle first
+  placeCamera(0, options->frames);
+
+  for (int update = 0; update < 100'000 && !g_world.isSettled(); update++) {
+    g_world.update(g_camera.getPosition());
+  }
+
+  for (int frame = 0; frame < options->warmupFrames; frame++) {
+    renderFrame(*options);
+  }
+
+  std::vector<double> frameTimesMs;
+  std::vector<std::size_t> drawCalls;
+  std::vector<std::size_t> triangles;
+
+  for (int frame = 0; frame < options->frames; frame++) {
+    placeCamera(frame, options->frames);
+    Mesh::drawStats() = {};
+
+    g_profiler.beginFrame();
+    const auto start = std::chrono::steady_clock::now();
+
+    {
+      PROFILE_SCOPE("Frame");
+      renderFrame(*options);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    g_profiler.endFrame();
+
+    frameTimesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    drawCalls.push_back(Mesh::drawStats().drawCalls);
+    triangles.push_back(Mesh::drawStats().triangles);
+  }
+
+  if (!options->tracePath.empty()) {
+    g_profiler.exportChromeTrace(options->tracePath);
+  }
+
+  if (!options->memoryPath.empty()) {
+    MemoryAccounting::exportJson(options->memoryPath);
+  }
+
+  const std::vector<double> latenciesMs = options->pacing ? measurePacing(*options) : std::vector<double>{};
+
+  const auto *renderer = reinterpret_cast<const char *>(glGetString(GL_RENDERER));
+
+  std::cout << "{\n";
+  std::cout << std::format("  \"renderer\": \"{}\",\n", renderer ? renderer : "unknown");
+  std::cout << std::format("  \"width\": {},\n  \"height\": {},\n  \"frames\": {},\n", options->width,
+                           options->height, options->frames);
+  std::cout << std::format("  \"pipelined\": {},\n", options->pipelined);
+  std::cout << std::format("  \"frame_ms\": {{\"mean\": {:.3f}, \"p50\": {:.3f}, \"p90\": {:.3f}, \"p95\": {:.3f}, "
+                           "\"p99\": {:.3f}, \"max\": {:.3f}}},\n",
+                           mean(frameTimesMs), percentile(frameTimesMs, 0.5), percentile(frameTimesMs, 0.9),
+                           percentile(frameTimesMs, 0.95), percentile(frameTimesMs, 0.99),
+                           std::ranges::max(frameTimesMs));
+  std::cout << std::format("  \"draw_calls\": {{\"mean\": {:.1f}, \"max\": {}}},\n", mean(drawCalls),
+                           std::ranges::max(drawCalls));
+  std::cout << std::format("  \"triangles\": {{\"mean\": {:.1f}, \"max\": {}}}{}\n", mean(triangles),
+                           std::ranges::max(triangles), options->pacing ? "," : "");
+
+  if (options->pacing) {
+    std::cout << std::format("  \"pacing\": \"{}\",\n  \"refresh_hz\": {},\n", presentModeName(*options->pacing),
+                             options->refreshRate);
+    std::cout << std::format("  \"input_to_submit_ms\": {{\"mean\": {:.3f}, \"p50\": {:.3f}, \"p99\": {:.3f}, "
+                             "\"max\": {:.3f}}}\n",
+                             mean(latenciesMs), percentile(latenciesMs, 0.5), percentile(latenciesMs, 0.99),
+                             std::ranges::max(latenciesMs));
+  }
+  std::cout << "}\n";
+
+  // GL objects owned by the container go away with the context
+  g_container.dispose();
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <random>
+
+#include "MicroBench.h"
+
+#include "../src/TerrainGenerator.h"
+#include "../src/VoxelRaycaster.h"
+
+constexpr int WORLD_RADIUS = 4; // In chunks around the origin
+constexpr std::size_t RAYS_PER_BATCH = 1024;
+
+static const ChunkMap &benchWorld() {
+  static const ChunkMap chunks = [] {
+    ChunkMap map;
+    const TerrainGenerator generator(App::Config::World::SEED);
+
+    for (int z = -WORLD_RADIUS; z <= WORLD_RADIUS; z++) {
+      for (int x = -WORLD_RADIUS; x <= WORLD_RADIUS; x++) {
+        for (int y = App::Config::World::MIN_CHUNK_Y; y <= App::Config::World::MAX_CHUNK_Y; y++) {
+          generator.generate(map.getOrCreate({x, y, z}));
+        }
+      }
+    }
+
+    return map;
+  }();
+
+  return chunks;
+}
+
+/// Line-of-sight rays between random pairs of points a few blocks above the terrain, like mobs looking at each other.
+static std::vector<Ray> lineOfSightRays() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution horizontal(-WORLD_RADIUS * 16.0f + 8.0f, WORLD_RADIUS * 16.0f - 8.0f);
+  std::uniform_real_distribution vertical(-8.0f, 16.0f);
+  std::uniform_real_distribution offset(-24.0f, 24.0f);
+
+  std::vector<Ray> rays;
+  rays.reserve(RAYS_PER_BATCH);
+
+  for (std::size_t i = 0; i < RAYS_PER_BATCH; i++) {
+    const glm::vec3 from(horizontal(rng), vertical(rng), horizontal(rng));
+    const glm::vec3 to = from + glm::vec3(offset(rng), offset(rng) * 0.25f, offset(rng));
+    rays.push_back({from, to - from, glm::length(to - from)});
+  }
+
+  return rays;
+}
+
+static void BM_RaycastPick(Bench::State &state) {
+  const ChunkMap &chunks = benchWorld();
+  const Ray ray{{0.5f, 20.0f, 0.5f}, {0.3f, -1.0f, 0.2f}, 64.0f};
+
+  while (state.keepRunning()) {
+    Bench::doNotOptimize(VoxelRaycaster::cast(chunks, ray));
+  }
+}
+BENCHMARK(BM_RaycastPick);
+
+static void BM_RaycastLineOfSight(Bench::State &state) {
+  const ChunkMap &chunks = benchWorld();
+  const std::vector<Ray> rays = lineOfSightRays();
+  state.setItemsPerIteration(rays.size());
+
+  while (state.keepRunning()) {
+    for (const Ray &ray : rays) {
+      Bench::doNotOptimize(VoxelRaycaster::cast(chunks, ray));
+    }
+  }
+}
+BENCHMARK(BM_RaycastLineOfSight);
+
+static void BM_RaycastLineOfSightBatched(Bench::State &state) {
+  const ChunkMap &chunks = benchWorld();
+  const std::vector<Ray> rays = lineOfSightRays();
+  std::vector<std::optional<RaycastHit>> hits(rays.size());
+  state.setItemsPerIteration(rays.size());
+
+  while (state.keepRunning()) {
+    VoxelRaycaster::castBatch(chunks, rays, hits);
+    Bench::doNotOptimize(hits);
+  }
+}
+BENCHMARK(BM_RaycastLineOfSightBatched);
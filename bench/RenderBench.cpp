@@ -0,0 +1,639 @@
+// Benchmarks of the uniform upload and shading paths, they need an OpenGL context and are skipped when none can be created.
+
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "HeadlessContext.h"
+#include "MicroBench.h"
+
+#include "../src/ClusteredLighting.h"
+#include "../src/DeferredRenderer.h"
+#include "../src/DepthPrepass.h"
+#include "../src/DummyVAO.h"
+#include "../src/EcsSystems.h"
+#include "../src/GameObject.h"
+#include "../src/Model.h"
+#include "../src/StreamBuffer.h"
+
+#include "../src/Config.h"
+
+constexpr int TORCH_COUNT = 1024;
+
+static glm::mat4 perspective() {
+  return glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, App::Config::Renderer::NEAR_PLANE,
+                          App::Config::Renderer::FAR_PLANE);
+}
+
+/// The shader every imported model renders with, compiled once in a context shared by all benchmarks of this file.
+static App::Shader *standardShader(Bench::State &state) {
+  static Bench::HeadlessContext context;
+  static const bool created = context.create();
+  static const std::unique_ptr<App::Shader> shader =
+      created ? std::make_unique<App::Shader>(App::Config::Renderer::DEFAULT_VERTEX_SHADER,
+                                              App::Config::Renderer::DEFAULT_FRAGMENT_SHADER)
+              : nullptr;
+
+  if (!shader) {
+    state.skipWithError("no OpenGL context");
+    return nullptr;
+  }
+
+  shader->use();
+  return shader.get();
+}
+
+static void BM_ShaderSetMat4(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+  const glm::mat4 model(1.0f);
+
+  while (state.keepRunning()) {
+    shader->set("uModel", model);
+  }
+}
+BENCHMARK(BM_ShaderSetMat4);
+
+static void BM_ShaderSetFloat(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  while (state.keepRunning()) {
+    shader->set(SHININESS_UNIFORM_NAME, 32.0f);
+  }
+}
+BENCHMARK(BM_ShaderSetFloat);
+
+/// Names the program doesn't have are cached as -1 too, but still pay for the lookup.
+static void BM_ShaderSetUnknownUniform(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  while (state.keepRunning()) {
+    shader->set("uDoesNotExist", 1.0f);
+  }
+}
+BENCHMARK(BM_ShaderSetUnknownUniform);
+
+/// The defaults ModelLoader gives every material plus the colors a typical OBJ file sets.
+static void BM_MaterialApplyUniforms(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  Material material;
+  material.setShader(std::shared_ptr<App::Shader>(shader, [](App::Shader *) {}));
+  material.setUniform(DIFFUSE_COLOR_UNIFORM_NAME, glm::vec4(1.0f));
+  material.setUniform(AMBIENT_COLOR_UNIFORM_NAME, glm::vec4(0.2f));
+  material.setUniform(SPECULAR_COLOR_UNIFORM_NAME, glm::vec4(1.0f));
+  material.setUniform(SHININESS_UNIFORM_NAME, 32.0f);
+  material.setUniform(OPACITY_UNIFORM_NAME, 1.0f);
+  material.setUniform(REFRACTION_INDEX_UNIFORM_NAME, 1.45f);
+  material.setIntUniform(DIFFUSE_TEXTURE_UNIFORM_NAME, DIFFUSE_TEXTURE_INDEX);
+  material.setIntUniform(SPECULAR_TEXTURE_UNIFORM_NAME, SPECULAR_TEXTURE_INDEX);
+  material.setIntUniform(NORMAL_TEXTURE_UNIFORM_NAME, NORMAL_TEXTURE_INDEX);
+
+  while (state.keepRunning()) {
+    material.applyUniforms(*shader);
+  }
+}
+BENCHMARK(BM_MaterialApplyUniforms);
+
+/// Light clusters of a thousand torches, as the renderer uploads them every frame.
+static void BM_ClusteredLightUpload(Bench::State &state) {
+  if (!standardShader(state)) {
+    return;
+  }
+
+  std::vector<Light> torches;
+
+  for (int i = 0; i < TORCH_COUNT; i++) {
+    const glm::vec3 position(static_cast<float>(i % 32 - 16) * 8.0f, 2.0f, -static_cast<float>(i / 32) * 8.0f);
+    torches.push_back(Light::Point(position, glm::vec4(1.0f), 1.0f, 1.0f, 0.35f, 0.44f));
+  }
+
+  const glm::mat4 view =
+      glm::lookAt(glm::vec3(0.0f, 16.0f, 16.0f), glm::vec3(0.0f, 0.0f, -64.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+  const glm::mat4 projection = perspective();
+
+  App::FrameArena arena(App::Config::Renderer::FRAME_ARENA_BYTES);
+  const App::LightClusters clusters =
+      App::assignLightClusters(torches, view, projection, glm::vec2(1920.0f, 1080.0f), arena);
+
+  App::ClusteredLighting lighting;
+  lighting.setup();
+  state.setItemsPerIteration(torches.size());
+
+  while (state.keepRunning()) {
+    lighting.upload(clusters);
+  }
+
+  glFinish();
+}
+BENCHMARK(BM_ClusteredLightUpload);
+
+/// Small quads scattered over the screen, drawn through the old per object path or the ECS.
+class EntityScene {
+public:
+  static constexpr std::size_t ENTITY_COUNT = 100'000;
+
+  explicit EntityScene(App::Shader *shader) {
+    const Vertex corner{.color = glm::vec4(1.0f), .normal = glm::vec3(0.0f, 0.0f, 1.0f)};
+    std::vector<Vertex> vertices(4, corner);
+    vertices[1].position = glm::vec3(1.0f, 0.0f, 0.0f);
+    vertices[2].position = glm::vec3(1.0f, 1.0f, 0.0f);
+    vertices[3].position = glm::vec3(0.0f, 1.0f, 0.0f);
+
+    m_mesh = std::make_shared<Mesh>(vertices, std::vector<unsigned int>{0, 1, 2, 0, 2, 3});
+    m_mesh->setup();
+
+    m_material = std::make_shared<Material>();
+    m_material->setShader(std::shared_ptr<App::Shader>(shader, [](App::Shader *) {}));
+    m_material->setUniform(DIFFUSE_COLOR_UNIFORM_NAME, glm::vec4(1.0f));
+    m_material->setUniform(SHININESS_UNIFORM_NAME, 32.0f);
+
+    m_model = std::make_shared<Model>();
+    m_model->addMeshGroup(m_mesh, m_material);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution coordinate(-0.95f, 0.95f);
+
+    for (std::size_t i = 0; i < ENTITY_COUNT; i++) {
+      m_positions.emplace_back(coordinate(rng), coordinate(rng), 0.0f);
+    }
+
+    // One light in front of the quads, clustered for the identity view they are drawn with
+    const Light light = Light::Point(glm::vec3(0.0f, 0.0f, -1.0f));
+    App::FrameArena arena(App::Config::Renderer::FRAME_ARENA_BYTES);
+    m_lighting.setup();
+    m_lighting.upload(App::assignLightClusters({&light, 1}, glm::mat4(1.0f), glm::mat4(1.0f), glm::vec2(1.0f), arena));
+  }
+
+  [[nodiscard]] RenderContext context() const {
+    // Identity view and projection, the quads are placed in clip space directly
+    return {
+        .modelMatrix = glm::mat4(1.0f),
+        .viewMatrix = glm::mat4(1.0f),
+        .projectionMatrix = glm::mat4(1.0f),
+        .cameraPosition = glm::vec3(0.0f, 0.0f, 1.0f),
+        .lighting = &m_lighting,
+    };
+  }
+
+  [[nodiscard]] std::vector<GameObject> gameObjects() const {
+    std::vector<GameObject> objects;
+    objects.reserve(ENTITY_COUNT);
+
+    for (const glm::vec3 &position : m_positions) {
+      GameObject &object = objects.emplace_back(m_model);
+      object.getTransform().SetLocalPosition(position);
+      object.getTransform().SetLocalScale(glm::vec3(0.002f));
+    }
+
+    return objects;
+  }
+
+  void spawn(App::Ecs::Registry &registry) const {
+    for (const glm::vec3 &position : m_positions) {
+      registry.create(App::Ecs::Transform{.position = position, .scale = glm::vec3(0.002f)},
+                      App::Ecs::MeshRenderer{.mesh = m_mesh.get(), .material = m_material.get()});
+    }
+  }
+
+private:
+  std::shared_ptr<Mesh> m_mesh;
+  std::shared_ptr<Material> m_material;
+  std::shared_ptr<Model> m_model;
+  std::vector<glm::vec3> m_positions;
+  App::ClusteredLighting m_lighting;
+};
+
+/// One virtual render call per object, each setting every uniform of the shader again.
+static void BM_GameObjectRender100k(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  if (!shader) {
+    return;
+  }
+
+  const EntityScene scene(shader);
+  const std::vector<GameObject> objects = scene.gameObjects();
+  const RenderContext ctx = scene.context();
+  state.setItemsPerIteration(objects.size());
+
+  while (state.keepRunning()) {
+    for (const GameObject &object : objects) {
+      object.render(ctx);
+    }
+
+    glFinish();
+  }
+}
+BENCHMARK(BM_GameObjectRender100k);
+
+static void BM_EcsRender100k(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  if (!shader) {
+    return;
+  }
+
+  const EntityScene scene(shader);
+  App::JobSystem jobs;
+  App::Ecs::Registry registry;
+  scene.spawn(registry);
+  App::Ecs::updateTransforms(registry, jobs);
+
+  const RenderContext ctx = scene.context();
+  std::pmr::vector<App::Ecs::MeshDraw> draws;
+  state.setItemsPerIteration(EntityScene::ENTITY_COUNT);
+
+  while (state.keepRunning()) {
+    draws.clear();
+    App::Ecs::collectDraws(registry, ctx.projectionMatrix * ctx.viewMatrix, draws);
+    App::Ecs::computeDrawMatrices(draws, ctx.projectionMatrix * ctx.viewMatrix);
+    App::Ecs::drawMeshes(draws, ctx);
+    glFinish();
+  }
+}
+BENCHMARK(BM_EcsRender100k);
+
+/// Screen filling quads stacked back to front in front of a field of torches, so every layer passes the depth test:
+/// forward shading lights each pixel once per layer, deferred shading once. Drawn into an offscreen target, a
+/// headless context may have no default framebuffer.
+class OverdrawScene {
+public:
+  static constexpr int LAYER_COUNT = 8;
+  static constexpr glm::ivec2 SIZE{640, 360};
+
+  explicit OverdrawScene(App::Shader *shader) {
+    const Vertex corner{.color = glm::vec4(1.0f), .normal = glm::vec3(0.0f, 0.0f, 1.0f)};
+    std::vector<Vertex> vertices(4, corner);
+    vertices[0].position = glm::vec3(-1.0f, -1.0f, 0.0f);
+    vertices[1].position = glm::vec3(1.0f, -1.0f, 0.0f);
+    vertices[2].position = glm::vec3(1.0f, 1.0f, 0.0f);
+    vertices[3].position = glm::vec3(-1.0f, 1.0f, 0.0f);
+
+    m_mesh = std::make_shared<Mesh>(vertices, std::vector<unsigned int>{0, 1, 2, 0, 2, 3});
+    m_mesh->setup();
+
+    m_material = std::make_shared<Material>();
+    m_material->setShader(std::shared_ptr<App::Shader>(shader, [](App::Shader *) {}));
+
+    // Camera at the origin looking down -z, each layer scaled to just cover the screen at its depth
+    const float halfHeight = std::tan(glm::radians(22.5f));
+    const float aspect = static_cast<float>(SIZE.x) / static_cast<float>(SIZE.y);
+
+    for (int layer = 0; layer < LAYER_COUNT; layer++) {
+      const float depth = 24.0f - 2.0f * static_cast<float>(layer);
+      const glm::mat4 world = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -depth)),
+                                         glm::vec3(depth * halfHeight * aspect, depth * halfHeight, 1.0f));
+      m_draws.push_back({.mesh = m_mesh.get(), .material = m_material.get(), .renderMode = GL_TRIANGLES, .world = world});
+    }
+
+    App::Ecs::computeDrawMatrices(m_draws, perspective());
+
+    std::vector<Light> torches;
+
+    for (int i = 0; i < TORCH_COUNT; i++) {
+      const glm::vec3 position(static_cast<float>(i % 32) - 15.5f, static_cast<float>(i / 32 % 16) - 7.5f,
+                               -4.0f - static_cast<float>(i / 512) * 8.0f);
+      torches.push_back(Light::Point(position, glm::vec4(1.0f), 1.0f, 1.0f, 0.35f, 0.44f));
+    }
+
+    App::FrameArena arena(App::Config::Renderer::FRAME_ARENA_BYTES);
+    m_lighting.setup();
+    m_lighting.upload(App::assignLightClusters(torches, glm::mat4(1.0f), perspective(), glm::vec2(SIZE), arena));
+
+    glGenRenderbuffers(1, &m_color);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SIZE.x, SIZE.y);
+    glGenRenderbuffers(1, &m_depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SIZE.x, SIZE.y);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+  }
+
+  ~OverdrawScene() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteRenderbuffers(1, &m_color);
+    glDeleteRenderbuffers(1, &m_depth);
+  }
+
+  OverdrawScene(const OverdrawScene &) = delete;
+  OverdrawScene &operator=(const OverdrawScene &) = delete;
+
+  /// Binds and clears the target.
+  void begin() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, SIZE.x, SIZE.y);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+
+  [[nodiscard]] RenderContext context(App::Shader *shader) const {
+    return {
+        .modelMatrix = glm::mat4(1.0f),
+        .viewMatrix = glm::mat4(1.0f),
+        .projectionMatrix = perspective(),
+        .cameraPosition = glm::vec3(0.0f),
+        .lighting = &m_lighting,
+        .customShader = shader,
+    };
+  }
+
+  [[nodiscard]] std::span<const App::Ecs::MeshDraw> draws() const {
+    return m_draws;
+  }
+
+private:
+  std::shared_ptr<Mesh> m_mesh;
+  std::shared_ptr<Material> m_material;
+  std::vector<App::Ecs::MeshDraw> m_draws;
+  App::ClusteredLighting m_lighting;
+  GLuint m_framebuffer = 0;
+  GLuint m_color = 0;
+  GLuint m_depth = 0;
+};
+
+/// Items are pixels, the same for both paths so their rates compare directly.
+static void BM_ForwardShadingOverdraw(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  if (!shader) {
+    return;
+  }
+
+  const OverdrawScene scene(shader);
+  const RenderContext ctx = scene.context(shader);
+  glEnable(GL_DEPTH_TEST);
+  state.setItemsPerIteration(OverdrawScene::SIZE.x * OverdrawScene::SIZE.y);
+
+  while (state.keepRunning()) {
+    scene.begin();
+    App::Ecs::drawMeshes(scene.draws(), ctx);
+    glFinish();
+  }
+}
+BENCHMARK(BM_ForwardShadingOverdraw);
+
+static void BM_ForwardShadingPrepassOverdraw(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  if (!shader) {
+    return;
+  }
+
+  const OverdrawScene scene(shader);
+  const RenderContext ctx = scene.context(shader);
+  App::DepthPrepass prepass;
+  prepass.setup();
+  glEnable(GL_DEPTH_TEST);
+  state.setItemsPerIteration(OverdrawScene::SIZE.x * OverdrawScene::SIZE.y);
+
+  while (state.keepRunning()) {
+    scene.begin();
+    prepass.render(scene.draws(), ctx);
+    App::DepthPrepass::beginEqualDepth();
+    App::Ecs::drawMeshes(scene.draws(), ctx);
+    App::DepthPrepass::endEqualDepth();
+    glFinish();
+  }
+}
+BENCHMARK(BM_ForwardShadingPrepassOverdraw);
+
+static void BM_DeferredShadingOverdraw(Bench::State &state) {
+  App::Shader *shader = standardShader(state);
+
+  if (!shader) {
+    return;
+  }
+
+  const OverdrawScene scene(shader);
+  const RenderContext ctx = scene.context(shader);
+  App::DeferredRenderer renderer;
+  renderer.setup();
+  glEnable(GL_DEPTH_TEST);
+  state.setItemsPerIteration(OverdrawScene::SIZE.x * OverdrawScene::SIZE.y);
+
+  while (state.keepRunning()) {
+    scene.begin();
+    renderer.render(scene.draws(), ctx, OverdrawScene::SIZE);
+    glFinish();
+  }
+}
+BENCHMARK(BM_DeferredShadingOverdraw);
+
+constexpr int STREAM_BATCHES = 1024;
+constexpr int STREAM_BATCH_POINTS = 64;
+
+/// Small batches of points written and drawn one after the other, the way instance data or debug lines are streamed.
+/// Rasterization is off, only the vertex fetch reads the data.
+class StreamScene {
+public:
+  static constexpr std::size_t BATCH_BYTES = STREAM_BATCH_POINTS * sizeof(glm::vec3);
+
+  StreamScene() : m_shader("depth_prepass.vert", "depth_only.frag"), m_points(STREAM_BATCH_POINTS, glm::vec3(0.0f)) {
+    m_shader.use();
+    m_shader.set("uModelViewProjection", glm::mat4(1.0f));
+
+    glGenVertexArrays(1, &m_VAO);
+    glBindVertexArray(m_VAO);
+    glEnableVertexAttribArray(0);
+    glEnable(GL_RASTERIZER_DISCARD);
+  }
+
+  ~StreamScene() {
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &m_VAO);
+  }
+
+  StreamScene(const StreamScene &) = delete;
+  StreamScene &operator=(const StreamScene &) = delete;
+
+  /// A batch that differs from the last one, so nothing can be skipped.
+  std::span<const glm::vec3> batch(const int index) {
+    m_points.front().x = static_cast<float>(index);
+    return m_points;
+  }
+
+  /// Draws the batch at `offset` in `buffer`.
+  static void draw(const GLuint buffer, const GLintptr offset) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void *>(offset));
+    glDrawArrays(GL_POINTS, 0, STREAM_BATCH_POINTS);
+  }
+
+private:
+  App::Shader m_shader;
+  std::vector<glm::vec3> m_points;
+  GLuint m_VAO = 0;
+};
+
+/// Every batch goes through glBufferSubData into the same buffer as last frame, which the GPU may still be reading.
+static void BM_StreamBatchesBufferSubData(Bench::State &state) {
+  if (!standardShader(state)) {
+    return;
+  }
+
+  StreamScene scene;
+  GLuint buffer = 0;
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_ARRAY_BUFFER, buffer);
+  glBufferData(GL_ARRAY_BUFFER, STREAM_BATCHES * StreamScene::BATCH_BYTES, nullptr, GL_DYNAMIC_DRAW);
+  state.setItemsPerIteration(STREAM_BATCHES);
+
+  while (state.keepRunning()) {
+    for (int i = 0; i < STREAM_BATCHES; i++) {
+      const auto offset = static_cast<GLintptr>(i * StreamScene::BATCH_BYTES);
+      const std::span<const glm::vec3> batch = scene.batch(i);
+
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glBufferSubData(GL_ARRAY_BUFFER, offset, static_cast<GLsizeiptr>(batch.size_bytes()), batch.data());
+      StreamScene::draw(buffer, offset);
+    }
+
+    glFlush();
+  }
+
+  glDeleteBuffers(1, &buffer);
+}
+BENCHMARK(BM_StreamBatchesBufferSubData);
+
+/// The same batches through a StreamBuffer: persistently mapped where the driver allows it, unsynchronized maps
+/// otherwise, one fenced region per frame either way.
+static void BM_StreamBatchesRing(Bench::State &state) {
+  if (!standardShader(state)) {
+    return;
+  }
+
+  StreamScene scene;
+  App::StreamBuffer stream(STREAM_BATCHES * StreamScene::BATCH_BYTES);
+  state.setItemsPerIteration(STREAM_BATCHES);
+
+  while (state.keepRunning()) {
+    stream.beginFrame();
+
+    for (int i = 0; i < STREAM_BATCHES; i++) {
+      const std::optional<GLintptr> offset = stream.write(scene.batch(i), sizeof(glm::vec3));
+
+      if (!offset) {
+        state.skipWithError("batches overflowed the stream buffer");
+        break;
+      }
+
+      StreamScene::draw(stream.getBuffer(), *offset);
+    }
+
+    stream.endFrame();
+    glFlush();
+  }
+}
+BENCHMARK(BM_StreamBatchesRing);
+
+/// A frame's depth buffer and the screen-space ambient occlusion pass a renderer without baked occlusion would run
+/// over it every frame. The depth is a field of block-sized steps, close to what terrain leaves behind, at the
+/// MinecraftBench resolution.
+class AmbientOcclusionScene {
+public:
+  static constexpr glm::ivec2 SIZE{1280, 720};
+  static constexpr int KERNEL_SIZE = 16; // Matches SAMPLE_COUNT in ssao_reference.frag
+
+  AmbientOcclusionScene() : m_shader("fullscreen_triangle.vert", "ssao_reference.frag") {
+    std::vector<float> depth(static_cast<std::size_t>(SIZE.x) * SIZE.y);
+
+    for (int y = 0; y < SIZE.y; y++) {
+      for (int x = 0; x < SIZE.x; x++) {
+        const int step = (x / 24 * 7 + y / 24 * 3) % 5;
+        depth[static_cast<std::size_t>(y) * SIZE.x + x] = 0.96f + 0.005f * static_cast<float>(step);
+      }
+    }
+
+    glGenTextures(1, &m_depth);
+    glBindTexture(GL_TEXTURE_2D, m_depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, SIZE.x, SIZE.y, 0, GL_DEPTH_COMPONENT, GL_FLOAT,
+                 depth.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenTextures(1, &m_occlusion);
+    glBindTexture(GL_TEXTURE_2D, m_occlusion);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, SIZE.x, SIZE.y, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_occlusion, 0);
+
+    // Samples in the hemisphere around +z, denser towards the center
+    std::mt19937 rng(42);
+    std::uniform_real_distribution unit(0.0f, 1.0f);
+    const glm::mat4 projection = perspective();
+
+    m_shader.use();
+    m_shader.set("uDepth", 0);
+    m_shader.set("uProjection", projection);
+    m_shader.set("uInverseProjection", glm::inverse(projection));
+    m_shader.set("uRadius", 0.5f);
+
+    for (int i = 0; i < KERNEL_SIZE; i++) {
+      const glm::vec3 direction =
+          glm::normalize(glm::vec3(unit(rng) * 2.0f - 1.0f, unit(rng) * 2.0f - 1.0f, unit(rng) + 0.01f));
+      const float scale = static_cast<float>(i) / KERNEL_SIZE;
+      m_shader.set("uKernel[" + std::to_string(i) + "]", direction * unit(rng) * (0.1f + 0.9f * scale * scale));
+    }
+  }
+
+  ~AmbientOcclusionScene() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteTextures(1, &m_occlusion);
+    glDeleteTextures(1, &m_depth);
+  }
+
+  AmbientOcclusionScene(const AmbientOcclusionScene &) = delete;
+  AmbientOcclusionScene &operator=(const AmbientOcclusionScene &) = delete;
+
+  void draw() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, SIZE.x, SIZE.y);
+    m_shader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_depth);
+    m_fullScreenTriangle.render();
+  }
+
+private:
+  App::Shader m_shader;
+  DummyVAO m_fullScreenTriangle;
+  GLuint m_depth = 0;
+  GLuint m_occlusion = 0;
+  GLuint m_framebuffer = 0;
+};
+
+/// The per-frame GPU price of screen-space occlusion on top of the shading, items are pixels. Baked occlusion only
+/// costs meshing time, see BM_ChunkMeshingBakedAmbientOcclusion.
+static void BM_ScreenSpaceAmbientOcclusion(Bench::State &state) {
+  if (!standardShader(state)) {
+    return;
+  }
+
+  const AmbientOcclusionScene scene;
+  glDisable(GL_DEPTH_TEST);
+  state.setItemsPerIteration(AmbientOcclusionScene::SIZE.x * AmbientOcclusionScene::SIZE.y);
+
+  while (state.keepRunning()) {
+    scene.draw();
+    glFinish();
+  }
+}
+BENCHMARK(BM_ScreenSpaceAmbientOcclusion);
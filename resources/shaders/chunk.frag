@@ -0,0 +1,41 @@
+#version 330 core
+
+#include "clustered_lights.glsl"
+#include "shadows.glsl"
+
+out vec4 FragColor;
+
+in vec3 fragWorldPos;
+in vec4 color;
+in vec3 normal;
+
+uniform vec3 uViewPosition;
+uniform vec3 uFogColor;
+uniform float uFogEnd;
+
+const float AMBIENT = 0.35;
+
+void main() {
+  vec3 N = normalize(normal);
+  float viewDepth = -(uView * vec4(fragWorldPos, 1.0)).z; // uView comes with clustered_lights.glsl
+  float diffuse = max(dot(N, uSun.direction), 0.0) * sunVisibility(fragWorldPos, N, viewDepth);
+  vec3 light = vec3(AMBIENT + (1.0 - AMBIENT) * diffuse);
+
+  // Torches and other scene lights, only those of this fragment's cluster
+  uvec2 lightRange = clusterLightRange(fragWorldPos);
+
+  for (uint i = lightRange.x; i < lightRange.x + lightRange.y; ++i) {
+    ClusteredLight sceneLight = clusteredLight(i);
+    vec3 toLight;
+    float falloff = lightFalloff(sceneLight, fragWorldPos, toLight);
+    light += sceneLight.radiance * falloff * max(dot(N, toLight), 0.0);
+  }
+
+  vec3 lit = color.rgb * light;
+
+  // Fade into the clear color towards the view distance so chunks streaming in don't pop
+  float distance = length(uViewPosition - fragWorldPos);
+  float fog = smoothstep(uFogEnd * 0.75, uFogEnd, distance);
+
+  FragColor = vec4(mix(lit, uFogColor, fog), color.a);
+}
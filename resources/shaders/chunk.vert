@@ -0,0 +1,29 @@
+#version 330 core
+
+// Matches VertexAttributeIndex enum in Mesh.h
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec4 aColor;
+layout(location = 2) in vec3 aNormal;
+
+out vec3 fragWorldPos;
+out vec4 color;
+out vec3 normal;
+
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+// All chunks are drawn in one call from a shared pool (ChunkMeshPool). Vertices are allocated in pages, each page
+// belongs to one chunk and this buffer holds its origin. With the base vertex included, gl_VertexID is the vertex's
+// place in the pool.
+#define CHUNK_PAGE_VERTICES 64 // Matches ChunkMeshPool::PAGE_VERTICES
+uniform samplerBuffer uChunkOrigins;
+
+void main() {
+  // Chunk meshes are only ever translated, so the normal needs no normal matrix
+  vec3 origin = texelFetch(uChunkOrigins, gl_VertexID / CHUNK_PAGE_VERTICES).xyz;
+  fragWorldPos = aPosition + origin;
+  color = aColor;
+  normal = aNormal;
+
+  gl_Position = uProjection * uView * vec4(fragWorldPos, 1.0);
+}
@@ -0,0 +1,90 @@
+// Clustered forward lighting, included by the lit fragment shaders. Lights are sorted into clusters of the view
+// frustum on the CPU (ClusteredLighting.h), a fragment only loops over the lights of the cluster it falls in.
+
+// Light types index (matches LightType enum class)
+#define LIGHT_DIRECTIONAL 0u
+#define LIGHT_POINT 1u
+#define LIGHT_SPOT 2u
+
+#define LIGHT_TEXELS 4
+
+struct ClusterGrid {
+  ivec3 size; // Tiles across the screen, slices along depth
+  vec2 viewportSize;
+  float depthScale; // The slice of a view depth is log(depth) * depthScale + depthBias
+  float depthBias;
+};
+
+struct ClusteredLight {
+  uint type;
+  vec3 position;
+  float range; // Negative if the light never fades out
+  vec3 radiance;
+  vec3 direction;
+  float innerCutoff;
+  vec3 attenuation; // Constant, linear, quadratic
+  float outerCutoff;
+};
+
+uniform ClusterGrid uClusters;
+uniform samplerBuffer uClusterLights;   // LIGHT_TEXELS per light
+uniform usamplerBuffer uClusterRanges;  // Offset into uClusterIndices and light count, per cluster
+uniform usamplerBuffer uClusterIndices; // Light indices, grouped by cluster
+uniform mat4 uView;
+
+/// Offset and count of the lights touching the cluster of this fragment.
+uvec2 clusterLightRange(vec3 worldPosition) {
+  float depth = -(uView * vec4(worldPosition, 1.0)).z;
+  ivec2 tile = ivec2(gl_FragCoord.xy / uClusters.viewportSize * vec2(uClusters.size.xy));
+  int slice = int(log(max(depth, 1e-4)) * uClusters.depthScale + uClusters.depthBias);
+  ivec3 cluster = clamp(ivec3(tile, slice), ivec3(0), uClusters.size - 1);
+
+  return texelFetch(uClusterRanges, (cluster.z * uClusters.size.y + cluster.y) * uClusters.size.x + cluster.x).xy;
+}
+
+ClusteredLight clusteredLight(uint rangeIndex) {
+  int base = int(texelFetch(uClusterIndices, int(rangeIndex)).x) * LIGHT_TEXELS;
+  vec4 positionRange = texelFetch(uClusterLights, base);
+  vec4 radianceType = texelFetch(uClusterLights, base + 1);
+  vec4 directionInner = texelFetch(uClusterLights, base + 2);
+  vec4 attenuationOuter = texelFetch(uClusterLights, base + 3);
+
+  ClusteredLight light;
+  light.type = uint(radianceType.w);
+  light.position = positionRange.xyz;
+  light.range = positionRange.w;
+  light.radiance = radianceType.rgb;
+  light.direction = directionInner.xyz;
+  light.innerCutoff = directionInner.w;
+  light.attenuation = attenuationOuter.xyz;
+  light.outerCutoff = attenuationOuter.w;
+  return light;
+}
+
+/// Share of a light's radiance reaching a point, and the direction towards the light. Distance attenuation is
+/// windowed to reach zero at the light's range, so cutting it off at the cluster bounds leaves no visible edge.
+float lightFalloff(ClusteredLight light, vec3 worldPosition, out vec3 toLight) {
+  if (light.type == LIGHT_DIRECTIONAL) {
+    toLight = -light.direction;
+    return 1.0;
+  }
+
+  vec3 offset = light.position - worldPosition;
+  float distance = length(offset);
+  toLight = offset / max(distance, 1e-4);
+
+  float falloff = 1.0 / dot(light.attenuation, vec3(1.0, distance, distance * distance));
+
+  if (light.range > 0.0) {
+    float ratio = distance / light.range;
+    float window = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+    falloff *= window * window;
+  }
+
+  if (light.type == LIGHT_SPOT) {
+    float theta = dot(toLight, -light.direction);
+    falloff *= clamp((theta - light.outerCutoff) / max(light.innerCutoff - light.outerCutoff, 1e-4), 0.0, 1.0);
+  }
+
+  return falloff;
+}
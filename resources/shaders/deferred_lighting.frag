@@ -0,0 +1,39 @@
+#version 330 core
+
+// Lighting pass of the deferred path: every covered pixel is shaded once, with the lights of its cluster.
+
+#include "gbuffer.glsl"
+#include "pbr.glsl"
+
+out vec4 FragColor;
+
+uniform sampler2D uAlbedoMetallic;
+uniform sampler2D uNormalRoughness;
+uniform sampler2D uDepth;
+uniform mat4 uInverseViewProjection;
+uniform vec3 uViewPosition;
+
+void main() {
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  float depth = texelFetch(uDepth, pixel, 0).r;
+
+  // Nothing was drawn here, keep what the target holds
+  if (depth == 1.0) {
+    discard;
+  }
+
+  vec4 albedoMetallic = texelFetch(uAlbedoMetallic, pixel, 0);
+  vec4 normalRoughness = texelFetch(uNormalRoughness, pixel, 0);
+
+  vec2 uv = (vec2(pixel) + 0.5) / vec2(textureSize(uDepth, 0));
+  vec4 clip = vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+  vec4 world = uInverseViewProjection * clip;
+  vec3 worldPosition = world.xyz / world.w;
+
+  vec3 albedo = pow(albedoMetallic.rgb, vec3(2.2));
+  vec3 N = decodeNormal(normalRoughness.xy);
+  vec3 V = normalize(uViewPosition - worldPosition);
+  float ao = 0.2;
+
+  FragColor = vec4(shadePbr(worldPosition, N, V, albedo, albedoMetallic.a, normalRoughness.z, ao), 1.0);
+}
@@ -0,0 +1,5 @@
+#version 330 core
+
+// Depth is all the shadow maps and the depth pre-pass keep, there is no color to write
+void main() {
+}
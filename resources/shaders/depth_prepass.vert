@@ -0,0 +1,15 @@
+#version 330 core
+
+// Depth pre-pass for the entity meshes, drawn from their position streams. The main pass tests for equal depths, so
+// the position comes from the same matrix skeleton.vert uses.
+
+// Matches VertexAttributeIndex enum in Mesh.h
+layout(location = 0) in vec3 aPosition;
+
+uniform mat4 uModelViewProjection;
+
+invariant gl_Position;
+
+void main() {
+  gl_Position = uModelViewProjection * vec4(aPosition, 1.0);
+}
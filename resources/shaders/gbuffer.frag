@@ -0,0 +1,38 @@
+#version 330 core
+
+// Geometry pass of the deferred path, drawn with skeleton.vert. Only surface attributes are written, the lights are
+// applied once per pixel by deferred_lighting.frag.
+
+#include "gbuffer.glsl"
+#include "normal_mapping.glsl"
+
+layout(location = 0) out vec4 gAlbedoMetallic;
+layout(location = 1) out vec4 gNormalRoughness;
+
+in VsOut {
+  vec3 fragWorldPos;
+  vec4 color;
+  vec2 texCoords;
+  vec3 normal;
+}
+fsIn;
+
+// The part of skeleton.frag's Material the surface needs
+struct Material {
+  sampler2D diffuseTexture;
+  sampler2D specularTexture;
+  sampler2D normalTexture;
+};
+
+uniform Material uMaterial;
+
+void main() {
+  vec3 albedo = texture(uMaterial.diffuseTexture, fsIn.texCoords).rgb;
+  float metallic = texture(uMaterial.specularTexture, fsIn.texCoords).r;
+  float roughness = 0.5;
+  vec3 N = normalFromMap(uMaterial.normalTexture, fsIn.fragWorldPos, fsIn.normal, fsIn.texCoords);
+
+  // Albedo stays gamma encoded, 8 bits of linear color would band in the darks
+  gAlbedoMetallic = vec4(albedo, metallic);
+  gNormalRoughness = vec4(encodeNormal(N), roughness, 0.0);
+}
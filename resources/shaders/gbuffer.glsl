@@ -0,0 +1,23 @@
+// G-buffer layout of the deferred path (DeferredRenderer.h):
+//   0: albedo.rgb (gamma encoded), metallic      RGBA8
+//   1: octahedral normal.xy, roughness           RGB10_A2
+//   depth                                        DEPTH24_STENCIL8, positions are rebuilt from it
+
+vec2 octahedronWrap(vec2 v) {
+  return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+/// Unit normal folded onto an octahedron and unrolled into the 0..1 square, two channels instead of three.
+vec2 encodeNormal(vec3 n) {
+  n /= abs(n.x) + abs(n.y) + abs(n.z);
+  vec2 folded = n.z >= 0.0 ? n.xy : octahedronWrap(n.xy);
+  return folded * 0.5 + 0.5;
+}
+
+vec3 decodeNormal(vec2 encoded) {
+  vec2 f = encoded * 2.0 - 1.0;
+  vec3 n = vec3(f, 1.0 - abs(f.x) - abs(f.y));
+  float t = clamp(-n.z, 0.0, 1.0);
+  n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+  return normalize(n);
+}
@@ -0,0 +1,19 @@
+// Easy trick to get tangent-normals to world-space to keep PBR code simplified.
+// Don't worry if you don't get what's going on; you generally want to do normal
+// mapping the usual way for performance anyways; I do plan make a note of this
+// technique somewhere later in the normal mapping tutorial.
+vec3 normalFromMap(sampler2D normalTexture, vec3 worldPosition, vec3 normal, vec2 texCoords) {
+  vec3 tangentNormal = texture(normalTexture, texCoords).xyz * 2.0 - 1.0;
+
+  vec3 Q1 = dFdx(worldPosition);
+  vec3 Q2 = dFdy(worldPosition);
+  vec2 st1 = dFdx(texCoords);
+  vec2 st2 = dFdy(texCoords);
+
+  vec3 N = normalize(normal);
+  vec3 T = normalize(Q1 * st2.t - Q2 * st1.t);
+  vec3 B = -normalize(cross(N, T));
+  mat3 TBN = mat3(T, B, N);
+
+  return normalize(TBN * tangentNormal);
+}
@@ -0,0 +1,8 @@
+#version 330 core
+
+// Every fragment that passes the depth test adds one to its pixel, blending is additive
+out vec4 FragColor;
+
+void main() {
+  FragColor = vec4(1.0, 0.0, 0.0, 0.0);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+
+// Fragments shaded per pixel: none is black, one blue, then green, yellow and red from OVERDRAW_SATURATION on.
+
+out vec4 FragColor;
+
+uniform sampler2D uCounts;
+
+const float OVERDRAW_SATURATION = 8.0;
+
+const vec3 RAMP[5] = vec3[](vec3(0.0, 0.0, 0.0), vec3(0.0, 0.2, 1.0), vec3(0.0, 0.9, 0.2), vec3(1.0, 0.9, 0.0),
+                            vec3(1.0, 0.0, 0.0));
+
+void main() {
+  float count = texelFetch(uCounts, ivec2(gl_FragCoord.xy), 0).r;
+
+  // 0 and 1 get their own stops, the rest of the ramp spreads over 1 to the saturation
+  float t = count <= 1.0 ? count : 1.0 + 3.0 * clamp((count - 1.0) / (OVERDRAW_SATURATION - 1.0), 0.0, 1.0);
+  int stop = min(int(t), 3);
+
+  FragColor = vec4(mix(RAMP[stop], RAMP[stop + 1], t - float(stop)), 1.0);
+}
@@ -0,0 +1,112 @@
+// Cook-Torrance BRDF over the clustered lights, shared by the forward and the deferred lighting paths.
+
+#include "clustered_lights.glsl"
+
+const float PI = 3.14159265359;
+
+float DistributionGGX(vec3 N, vec3 H, float roughness) {
+  float a = roughness * roughness;
+  float a2 = a * a;
+  float NdotH = max(dot(N, H), 0.0);
+  float NdotH2 = NdotH * NdotH;
+
+  float nom = a2;
+  float denom = (NdotH2 * (a2 - 1.0) + 1.0);
+  denom = PI * denom * denom;
+
+  return nom / denom;
+}
+
+float GeometrySchlickGGX(float NdotV, float roughness) {
+  float r = (roughness + 1.0);
+  float k = (r * r) / 8.0;
+
+  float nom = NdotV;
+  float denom = NdotV * (1.0 - k) + k;
+
+  return nom / denom;
+}
+
+float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
+  float NdotV = max(dot(N, V), 0.0);
+  float NdotL = max(dot(N, L), 0.0);
+  float ggx2 = GeometrySchlickGGX(NdotV, roughness);
+  float ggx1 = GeometrySchlickGGX(NdotL, roughness);
+
+  return ggx1 * ggx2;
+}
+
+vec3 fresnelSchlick(float cosTheta, vec3 F0) {
+  return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
+}
+
+/// Tonemapped, gamma corrected color of a surface point lit by the lights of its cluster.
+vec3 shadePbr(vec3 worldPosition, vec3 N, vec3 V, vec3 albedo, float metallic, float roughness, float ao) {
+  // calculate reflectance at normal incidence; if dia-electric (like plastic) use F0
+  // of 0.04 and if it's a metal, use the albedo color as F0 (metallic workflow)
+  vec3 F0 = vec3(0.04);
+  F0 = mix(F0, albedo, metallic);
+
+  // reflectance equation, over the lights of this fragment's cluster only
+  vec3 Lo = vec3(0.0);
+
+  // Shader variants bound the loop (ShaderVariant.h): with no lights even the cluster lookup goes, a short bound the
+  // compiler can see lets it unroll. Without a variant the whole cluster is looped over.
+#ifndef UNLIT
+  uvec2 lightRange = clusterLightRange(worldPosition);
+
+#ifdef MAX_FRAGMENT_LIGHTS
+  for (uint n = 0u; n < uint(MAX_FRAGMENT_LIGHTS); ++n) {
+    if (n >= lightRange.y) {
+      break;
+    }
+#else
+  for (uint n = 0u; n < lightRange.y; ++n) {
+#endif
+    // calculate per-light radiance
+    ClusteredLight light = clusteredLight(lightRange.x + n);
+    vec3 L;
+    float attenuation = lightFalloff(light, worldPosition, L);
+    vec3 H = normalize(V + L);
+    vec3 radiance = light.radiance * attenuation;
+
+    // Cook-Torrance BRDF
+    float NDF = DistributionGGX(N, H, roughness);
+    float G = GeometrySmith(N, V, L, roughness);
+    vec3 F = fresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 numerator = NDF * G * F;
+    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001; // + 0.0001 to prevent divide by zero
+    vec3 specular = numerator / denominator;
+
+    // kS is equal to Fresnel
+    vec3 kS = F;
+    // for energy conservation, the diffuse and specular light can't
+    // be above 1.0 (unless the surface emits light); to preserve this
+    // relationship the diffuse component (kD) should equal 1.0 - kS.
+    vec3 kD = vec3(1.0) - kS;
+    // multiply kD by the inverse metalness such that only non-metals
+    // have diffuse lighting, or a linear blend if partly metal (pure metals
+    // have no diffuse light).
+    kD *= 1.0 - metallic;
+
+    // scale light by NdotL
+    float NdotL = max(dot(N, L), 0.0);
+
+    // add to outgoing radiance Lo
+    Lo += (kD * albedo / PI + specular) * radiance *
+          NdotL; // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
+  }
+#endif
+
+  // ambient lighting (note that the next IBL tutorial will replace
+  // this ambient lighting with environment lighting).
+  vec3 ambient = vec3(0.03) * albedo * ao;
+
+  vec3 color = ambient + Lo;
+
+  // HDR tonemapping
+  color = color / (color + vec3(1.0));
+  // gamma correct
+  return pow(color, vec3(1.0 / 2.2));
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+// Depth only variant for the shadow maps, drawn for chunks and entity meshes alike from their position streams
+
+// Matches VertexAttributeIndex enum in Mesh.h
+layout(location = 0) in vec3 aPosition;
+
+uniform mat4 uModel;
+uniform mat4 uLightViewProjection;
+
+void main() {
+  gl_Position = uLightViewProjection * uModel * vec4(aPosition, 1.0);
+}
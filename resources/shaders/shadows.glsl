@@ -0,0 +1,44 @@
+// Sun and its cascaded shadow maps (ShadowMaps.h), included by shaders lit by the sun.
+
+#define SHADOW_CASCADES 4 // Matches Config::Renderer::SHADOW_CASCADES
+
+struct Sun {
+  vec3 direction; // Towards the sun
+  int cascades;   // 0 without shadows
+  mat4 matrices[SHADOW_CASCADES];
+  float farDepths[SHADOW_CASCADES];
+  float texelSizes[SHADOW_CASCADES];
+};
+
+uniform Sun uSun;
+uniform sampler2DArrayShadow uShadowMap;
+
+/// Share of the sunlight reaching a point, 1 where nothing stands between it and the sun or past the last cascade.
+float sunVisibility(vec3 worldPosition, vec3 normal, float viewDepth) {
+  int cascade = 0;
+
+  while (cascade < uSun.cascades && viewDepth > uSun.farDepths[cascade]) {
+    cascade++;
+  }
+
+  if (cascade >= uSun.cascades) {
+    return 1.0;
+  }
+
+  // Pushed off the surface by about a texel, so it doesn't shadow itself
+  vec3 offsetPosition = worldPosition + normal * uSun.texelSizes[cascade] * 1.5;
+  vec4 clip = uSun.matrices[cascade] * vec4(offsetPosition, 1.0);
+  vec3 coord = clip.xyz / clip.w * 0.5 + 0.5;
+  vec2 texel = 1.0 / vec2(textureSize(uShadowMap, 0).xy);
+
+  // 3x3 taps, each one already a bilinear blend of four comparisons
+  float lit = 0.0;
+
+  for (int x = -1; x <= 1; x++) {
+    for (int y = -1; y <= 1; y++) {
+      lit += texture(uShadowMap, vec4(coord.xy + vec2(x, y) * texel, float(cascade), coord.z));
+    }
+  }
+
+  return lit / 9.0;
+}
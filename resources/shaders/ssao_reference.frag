@@ -0,0 +1,47 @@
+#version 330 core
+
+// Screen-space ambient occlusion the way a deferred renderer would add it: samples in the hemisphere around each
+// pixel's normal, both reconstructed from the depth buffer. The renderer doesn't use it, terrain bakes its occlusion
+// into the vertex colors while meshing (ChunkMesher). RenderBench draws it to price what that saves per frame.
+
+#define SAMPLE_COUNT 16
+
+out float FragOcclusion;
+
+uniform sampler2D uDepth;
+uniform mat4 uProjection;
+uniform mat4 uInverseProjection;
+uniform float uRadius;
+uniform vec3 uKernel[SAMPLE_COUNT];
+
+vec3 viewPosition(vec2 uv) {
+  vec4 clip = vec4(vec3(uv, texture(uDepth, uv).r) * 2.0 - 1.0, 1.0);
+  vec4 view = uInverseProjection * clip;
+  return view.xyz / view.w;
+}
+
+void main() {
+  vec2 uv = gl_FragCoord.xy / vec2(textureSize(uDepth, 0));
+  vec3 position = viewPosition(uv);
+  vec3 normal = normalize(cross(dFdx(position), dFdy(position)));
+
+  // The kernel is turned per pixel, the blur that usually hides the noise afterwards is left out
+  float angle = fract(sin(dot(gl_FragCoord.xy, vec2(12.9898, 78.233))) * 43758.5453) * 6.2831853;
+  vec3 random = vec3(cos(angle), sin(angle), 0.0);
+  vec3 tangent = normalize(random - normal * dot(random, normal));
+  mat3 tbn = mat3(tangent, cross(normal, tangent), normal);
+
+  float occlusion = 0.0;
+
+  for (int i = 0; i < SAMPLE_COUNT; ++i) {
+    vec3 samplePosition = position + tbn * uKernel[i] * uRadius;
+    vec4 offset = uProjection * vec4(samplePosition, 1.0);
+    float sceneDepth = viewPosition(offset.xy / offset.w * 0.5 + 0.5).z;
+
+    // Geometry far in front of the sample is something else entirely, it doesn't occlude
+    float inRange = smoothstep(0.0, 1.0, uRadius / abs(position.z - sceneDepth));
+    occlusion += (sceneDepth >= samplePosition.z + 0.025 ? 1.0 : 0.0) * inRange;
+  }
+
+  FragOcclusion = 1.0 - occlusion / float(SAMPLE_COUNT);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+
+// Upscales the world drawn at a lower resolution into the lower left corner of uScene, then sharpens it: the bilinear
+// sample is pushed away from the average of its neighbours, one source texel away, but kept within their range so
+// edges don't ring.
+
+out vec4 FragColor;
+
+uniform sampler2D uScene;
+uniform vec2 uRenderSize;  // Part of uScene holding the frame, in texels
+uniform vec2 uDisplaySize;
+uniform float uSharpness;
+
+vec3 sampleFrame(vec2 texel) {
+  // Half a texel in from the frame's edges, bilinear filtering would blend in what lies outside it
+  vec2 clamped = clamp(texel, vec2(0.5), uRenderSize - 0.5);
+  return texture(uScene, clamped / vec2(textureSize(uScene, 0))).rgb;
+}
+
+void main() {
+  vec2 texel = gl_FragCoord.xy / uDisplaySize * uRenderSize;
+
+  vec3 center = sampleFrame(texel);
+  vec3 left = sampleFrame(texel - vec2(1.0, 0.0));
+  vec3 right = sampleFrame(texel + vec2(1.0, 0.0));
+  vec3 down = sampleFrame(texel - vec2(0.0, 1.0));
+  vec3 up = sampleFrame(texel + vec2(0.0, 1.0));
+
+  vec3 lowest = min(center, min(min(left, right), min(down, up)));
+  vec3 highest = max(center, max(max(left, right), max(down, up)));
+  vec3 average = (left + right + down + up) * 0.25;
+
+  FragColor = vec4(clamp(center + (center - average) * uSharpness, lowest, highest), 1.0);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/// Axis aligned bounding box.
+struct AABB {
+  glm::vec3 min;
+  glm::vec3 max;
+
+  [[nodiscard]] glm::vec3 center() const {
+    return (min + max) * 0.5f;
+  }
+
+  [[nodiscard]] glm::vec3 extents() const {
+    return (max - min) * 0.5f;
+  }
+
+  [[nodiscard]] AABB merged(const AABB &other) const {
+    return {glm::min(min, other.min), glm::max(max, other.max)};
+  }
+
+  /// Box enclosing this one once moved by `transform`, which can only grow under rotation.
+  [[nodiscard]] AABB transformed(const glm::mat4 &transform) const {
+    const glm::vec3 center = glm::vec3(transform * glm::vec4(this->center(), 1.0f));
+    const glm::vec3 size = extents();
+    const glm::vec3 halfSize = glm::abs(glm::vec3(transform[0])) * size.x +
+                               glm::abs(glm::vec3(transform[1])) * size.y + glm::abs(glm::vec3(transform[2])) * size.z;
+    return {center - halfSize, center + halfSize};
+  }
+};
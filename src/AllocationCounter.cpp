@@ -0,0 +1,52 @@
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace App::AllocationCounter {
+
+namespace {
+thread_local uint64_t g_threadAllocations = 0;
+} // namespace
+
+uint64_t threadAllocations() {
+  return g_threadAllocations;
+}
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+void *countedAllocate(const std::size_t bytes, const std::size_t alignment) {
+  g_threadAllocations++;
+
+  // aligned_alloc wants a size that is a multiple of the alignment
+  const std::size_t size = (std::max<std::size_t>(bytes, 1) + alignment - 1) / alignment * alignment;
+
+  if (void *data = std::aligned_alloc(alignment, size)) {
+    return data;
+  }
+
+  throw std::bad_alloc();
+}
+#endif
+
+} // namespace App::AllocationCounter
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+// The array, nothrow and sized forms all forward to these by default
+void *operator new(const std::size_t bytes) {
+  return App::AllocationCounter::countedAllocate(bytes, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(const std::size_t bytes, const std::align_val_t alignment) {
+  return App::AllocationCounter::countedAllocate(
+      bytes, std::max(static_cast<std::size_t>(alignment), std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}));
+}
+
+void operator delete(void *data) noexcept {
+  std::free(data);
+}
+
+void operator delete(void *data, std::align_val_t) noexcept {
+  std::free(data);
+}
+#endif
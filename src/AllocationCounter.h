@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocations are only counted in builds defining ALLOCATION_COUNTER_ENABLED (Debug), which replaces the global
+// operator new. Elsewhere the counter always reads 0.
+namespace App::AllocationCounter {
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+/// Heap allocations made by the calling thread since it started, other threads' work doesn't disturb a measurement.
+[[nodiscard]] uint64_t threadAllocations();
+
+} // namespace App::AllocationCounter
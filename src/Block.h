@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+enum class BlockType : uint8_t {
+  Air,
+  Stone,
+  Dirt,
+  Grass,
+  Sand,
+  Water,
+};
+
+/// Faces of a block (and of a chunk), in the same order as BLOCK_FACE_NORMALS.
+enum class BlockFace : uint8_t {
+  NegX,
+  PosX,
+  NegY,
+  PosY,
+  NegZ,
+  PosZ,
+};
+
+constexpr int BLOCK_FACE_COUNT = 6;
+
+constexpr glm::ivec3 BLOCK_FACE_NORMALS[BLOCK_FACE_COUNT] = {
+    {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1},
+};
+
+constexpr BlockFace oppositeFace(const BlockFace face) {
+  return static_cast<BlockFace>(static_cast<uint8_t>(face) ^ 1u);
+}
+
+constexpr bool isSolid(const BlockType type) {
+  return type != BlockType::Air;
+}
+
+/// Opaque blocks hide the faces of their neighbours.
+constexpr bool isOpaque(const BlockType type) {
+  return type != BlockType::Air && type != BlockType::Water;
+}
+
+constexpr glm::vec4 blockColor(const BlockType type) {
+  switch (type) {
+  case BlockType::Stone:
+    return {0.50f, 0.50f, 0.52f, 1.0f};
+  case BlockType::Dirt:
+    return {0.45f, 0.31f, 0.20f, 1.0f};
+  case BlockType::Grass:
+    return {0.33f, 0.58f, 0.24f, 1.0f};
+  case BlockType::Sand:
+    return {0.86f, 0.80f, 0.56f, 1.0f};
+  case BlockType::Water:
+    return {0.20f, 0.38f, 0.80f, 0.70f};
+  case BlockType::Air:
+    break;
+  }
+
+  return {0.0f, 0.0f, 0.0f, 0.0f};
+}
@@ -1,30 +1,35 @@
 #pragma once
 
-#include <unordered_map>
-#include <sstream>
-#include <string>
+#include <format>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <typeinfo>
+
+#include "StringHash.h"
 
 constexpr auto sep = " ";
 
 template <class T> class Cache {
 public:
   template <class... CtorArgs> std::shared_ptr<T> &get(CtorArgs... args) {
-    std::ostringstream oss;
-
-    ((oss << sep << args), ...);
+    // Reused between calls, so once it fits the longest key looking up a cached entry doesn't allocate
+    thread_local std::string key;
+    key = typeid(T).name();
 
-    const std::string key = std::string(typeid(T).name()) + oss.str();
+    ((std::format_to(std::back_inserter(key), "{}{}", sep, args)), ...);
 
     if (const auto entry = m_cache.find(key); entry != m_cache.end()) {
       return entry->second;
     }
 
-    m_cache.insert({key, std::make_shared<T>(std::forward<CtorArgs>(args)...)});
+    // Copied before constructing, in case building a T looks something else up in this cache
+    std::string newKey = key;
+    auto value = std::make_shared<T>(std::forward<CtorArgs>(args)...);
 
-    return m_cache[key];
+    return m_cache.emplace(std::move(newKey), std::move(value)).first->second;
   }
 
 private:
-  std::unordered_map<std::string, std::shared_ptr<T>> m_cache{};
+  StringMap<std::shared_ptr<T>> m_cache{};
 };
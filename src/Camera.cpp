@@ -12,7 +12,6 @@ Camera::Camera(const glm::vec3 &position)
 }
 
 void Camera::update() {
-  handleKeyInput();
   m_speed = SDL_GetKeyboardState(nullptr)[SDL_SCANCODE_LSHIFT] ? m_baseSpeed * m_boostMultiplier : m_baseSpeed;
 
   updateCursorCapture();
@@ -57,6 +56,22 @@ const glm::vec3 &Camera::getPosition() const {
   return m_position;
 }
 
+const glm::vec3 &Camera::getFront() const {
+  return m_front;
+}
+
+void Camera::lookAt(const glm::vec3 &position, const glm::vec3 &target) {
+  m_position = position;
+
+  if (target != position) {
+    const glm::vec3 direction = glm::normalize(target - position);
+    m_yaw = static_cast<float>(glm::degrees(atan2(direction.z, direction.x)));
+    m_pitch = static_cast<float>(glm::degrees(asin(direction.y)));
+  }
+
+  updateCameraVectors();
+}
+
 void Camera::reset() {
   m_position = m_initialPosition;
   lookAtOrigin();
@@ -82,33 +97,35 @@ void Camera::updateCameraVectors() {
   m_up = glm::normalize(glm::cross(m_right, m_front));
 }
 
-void Camera::handleKeyInput() {
+glm::vec3 Camera::getMovementVelocity() const {
   const bool *keys = SDL_GetKeyboardState(nullptr);
-  const float frameSpeed = m_speed * g_container.m_time->deltaTime();
+  glm::vec3 velocity(0.0f);
 
   if (keys[SDL_SCANCODE_W]) {
-    m_position += m_front * frameSpeed;
+    velocity += m_front;
   }
 
   if (keys[SDL_SCANCODE_S]) {
-    m_position -= m_front * frameSpeed;
+    velocity -= m_front;
   }
 
   if (keys[SDL_SCANCODE_A]) {
-    m_position -= m_right * frameSpeed;
+    velocity -= m_right;
   }
 
   if (keys[SDL_SCANCODE_D]) {
-    m_position += m_right * frameSpeed;
+    velocity += m_right;
   }
 
   if (keys[SDL_SCANCODE_SPACE]) {
-    m_position += m_up * frameSpeed;
+    velocity += m_up;
   }
 
   if (keys[SDL_SCANCODE_LALT]) {
-    m_position -= m_up * frameSpeed;
+    velocity -= m_up;
   }
+
+  return velocity * m_speed;
 }
 
 void Camera::updateCursorCapture() const {
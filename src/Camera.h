@@ -14,8 +14,19 @@ public:
 
   void setActive(bool active);
 
+  /// Moves the camera to `position`, facing `target`.
+  void lookAt(const glm::vec3 &position, const glm::vec3 &target);
+
+  void setPosition(const glm::vec3 &position) {
+    m_position = position;
+  }
+
+  /// Velocity the movement keys ask for, along the current view axes. Integrated by the simulation ticks.
+  [[nodiscard]] glm::vec3 getMovementVelocity() const;
+
   [[nodiscard]] glm::mat4 getViewMatrix() const;
   [[nodiscard]] const glm::vec3 &getPosition() const;
+  [[nodiscard]] const glm::vec3 &getFront() const;
   void reset();
 
 private:
@@ -37,7 +48,6 @@ private:
 
   void lookAtOrigin();
   void updateCameraVectors();
-  void handleKeyInput();
   void updateCursorCapture() const;
 };
 } // namespace App
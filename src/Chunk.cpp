@@ -0,0 +1,90 @@
+#include "Chunk.h"
+
+#include <algorithm>
+
+Chunk::Chunk(const glm::ivec3 &coord) : m_coord(coord) {
+}
+
+void Chunk::set(const int x, const int y, const int z, const BlockType type) {
+  if (m_blocks.empty()) {
+    if (type == BlockType::Air) {
+      return;
+    }
+
+    m_blocks.assign(VOLUME, BlockType::Air);
+    trackMemory();
+  }
+
+  m_blocks[index(x, y, z, SIZE)] = type;
+  m_lodDirty.fill(true);
+}
+
+const std::vector<BlockType> &Chunk::getLodData(const int lod) const {
+  if (lod <= 0 || m_blocks.empty()) {
+    return m_blocks;
+  }
+
+  const int slot = std::min(lod, MAX_LOD) - 1;
+
+  if (m_lodDirty[slot]) {
+    downsample(getLodData(slot), lodSize(slot), m_lodData[slot]);
+    m_lodDirty[slot] = false;
+    trackMemory();
+  }
+
+  return m_lodData[slot];
+}
+
+void Chunk::trackMemory() const {
+  std::size_t bytes = m_blocks.capacity() * sizeof(BlockType);
+
+  for (const std::vector<BlockType> &lodData : m_lodData) {
+    bytes += lodData.capacity() * sizeof(BlockType);
+  }
+
+  m_memory.set(bytes);
+}
+
+void Chunk::downsample(const std::vector<BlockType> &source, const int sourceSize, std::vector<BlockType> &target) {
+  const int targetSize = sourceSize / 2;
+  target.assign(targetSize * targetSize * targetSize, BlockType::Air);
+
+  // Each coarse cell covers 2x2x2 source cells. It becomes solid when at least half of them are, and takes the most
+  // frequent solid type, which keeps the terrain silhouette (and the grass on top of it) stable across levels.
+  for (int y = 0; y < targetSize; y++) {
+    for (int z = 0; z < targetSize; z++) {
+      for (int x = 0; x < targetSize; x++) {
+        BlockType samples[8];
+        int solidCount = 0;
+
+        for (int dy = 0; dy < 2; dy++) {
+          for (int dz = 0; dz < 2; dz++) {
+            for (int dx = 0; dx < 2; dx++) {
+              const BlockType type = source[index(2 * x + dx, 2 * y + dy, 2 * z + dz, sourceSize)];
+              if (isSolid(type)) {
+                samples[solidCount++] = type;
+              }
+            }
+          }
+        }
+
+        if (solidCount < 4) {
+          continue;
+        }
+
+        BlockType dominant = samples[0];
+        int dominantCount = 0;
+
+        for (int i = 0; i < solidCount; i++) {
+          const auto count = static_cast<int>(std::count(samples, samples + solidCount, samples[i]));
+          if (count > dominantCount) {
+            dominant = samples[i];
+            dominantCount = count;
+          }
+        }
+
+        target[index(x, y, z, targetSize)] = dominant;
+      }
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Block.h"
+#include "Config.h"
+#include "MemoryAccounting.h"
+
+/// A cubic 16x16x16 block of voxels (a "section" in Minecraft terms), addressed by its chunk coordinate.
+class Chunk {
+public:
+  static constexpr int SIZE = App::Config::World::CHUNK_SIZE;
+  static constexpr int VOLUME = SIZE * SIZE * SIZE;
+
+  /// Number of downsampled levels kept next to the full resolution data (2x, 4x and 8x).
+  static constexpr int MAX_LOD = 3;
+
+  explicit Chunk(const glm::ivec3 &coord);
+
+  [[nodiscard]] const glm::ivec3 &getCoord() const {
+    return m_coord;
+  }
+
+  [[nodiscard]] glm::ivec3 getWorldOrigin() const {
+    return m_coord * SIZE;
+  }
+
+  /// True while no block has been written, the chunk then keeps no block storage at all.
+  [[nodiscard]] bool isEmpty() const {
+    return m_blocks.empty();
+  }
+
+  [[nodiscard]] BlockType get(const int x, const int y, const int z) const {
+    return m_blocks.empty() ? BlockType::Air : m_blocks[index(x, y, z, SIZE)];
+  }
+
+  void set(int x, int y, int z, BlockType type);
+
+  /// Edge length, in cells, of the voxel grid of a LOD level.
+  static constexpr int lodSize(const int lod) {
+    return SIZE >> lod;
+  }
+
+  /// Voxel grid of a LOD level (0 is full resolution), built lazily from the previous level.
+  /// Returns an empty vector if the chunk is empty.
+  [[nodiscard]] const std::vector<BlockType> &getLodData(int lod) const;
+
+  static constexpr int index(const int x, const int y, const int z, const int size) {
+    return (y * size + z) * size + x;
+  }
+
+private:
+  glm::ivec3 m_coord;
+  std::vector<BlockType> m_blocks;
+
+  mutable std::array<std::vector<BlockType>, MAX_LOD> m_lodData;
+  mutable std::array<bool, MAX_LOD> m_lodDirty{true, true, true};
+  mutable App::TrackedMemory m_memory{App::MemoryTag::Terrain, App::MemoryPool::Cpu};
+
+  void trackMemory() const;
+
+  static void downsample(const std::vector<BlockType> &source, int sourceSize, std::vector<BlockType> &target);
+};
@@ -0,0 +1,36 @@
+#include "ChunkMap.h"
+
+Chunk *ChunkMap::find(const glm::ivec3 &coord) {
+  const auto entry = m_chunks.find(coord);
+  return entry != m_chunks.end() ? entry->second.get() : nullptr;
+}
+
+const Chunk *ChunkMap::find(const glm::ivec3 &coord) const {
+  const auto entry = m_chunks.find(coord);
+  return entry != m_chunks.end() ? entry->second.get() : nullptr;
+}
+
+Chunk &ChunkMap::getOrCreate(const glm::ivec3 &coord) {
+  auto &chunk = m_chunks[coord];
+
+  if (!chunk) {
+    chunk = std::make_unique<Chunk>(coord);
+  }
+
+  return *chunk;
+}
+
+void ChunkMap::erase(const glm::ivec3 &coord) {
+  m_chunks.erase(coord);
+}
+
+BlockType ChunkMap::getBlock(const glm::ivec3 &worldPos) const {
+  const Chunk *chunk = find(toChunkCoord(worldPos));
+
+  if (!chunk) {
+    return BlockType::Air;
+  }
+
+  const glm::ivec3 local = toLocalPos(worldPos);
+  return chunk->get(local.x, local.y, local.z);
+}
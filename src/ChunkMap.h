@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "Chunk.h"
+
+struct ChunkCoordHash {
+  std::size_t operator()(const glm::ivec3 &coord) const {
+    // Large primes spread neighbouring coordinates over the buckets
+    return static_cast<std::size_t>(coord.x) * 73856093u ^ static_cast<std::size_t>(coord.y) * 19349663u ^
+           static_cast<std::size_t>(coord.z) * 83492791u;
+  }
+};
+
+template <class T> using ChunkCoordMap = std::unordered_map<glm::ivec3, T, ChunkCoordHash>;
+
+/// Owns the loaded chunks and resolves world block positions to them.
+class ChunkMap {
+public:
+  [[nodiscard]] Chunk *find(const glm::ivec3 &coord);
+  [[nodiscard]] const Chunk *find(const glm::ivec3 &coord) const;
+
+  Chunk &getOrCreate(const glm::ivec3 &coord);
+  void erase(const glm::ivec3 &coord);
+
+  /// Block at a world position, Air if the chunk holding it is not loaded.
+  [[nodiscard]] BlockType getBlock(const glm::ivec3 &worldPos) const;
+
+  [[nodiscard]] std::size_t size() const {
+    return m_chunks.size();
+  }
+
+  [[nodiscard]] auto begin() const {
+    return m_chunks.begin();
+  }
+
+  [[nodiscard]] auto end() const {
+    return m_chunks.end();
+  }
+
+  static glm::ivec3 toChunkCoord(const glm::ivec3 &worldPos) {
+    // Floor division, so that -1 maps to chunk -1 rather than 0
+    return {floorDiv(worldPos.x), floorDiv(worldPos.y), floorDiv(worldPos.z)};
+  }
+
+  static glm::ivec3 toLocalPos(const glm::ivec3 &worldPos) {
+    return worldPos - toChunkCoord(worldPos) * Chunk::SIZE;
+  }
+
+private:
+  ChunkCoordMap<std::unique_ptr<Chunk>> m_chunks;
+
+  static int floorDiv(const int value) {
+    return value >= 0 ? value / Chunk::SIZE : (value - Chunk::SIZE + 1) / Chunk::SIZE;
+  }
+};
@@ -0,0 +1,359 @@
+#include "ChunkMeshPool.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <spdlog/spdlog.h>
+
+#include "Profiler.h"
+#include "World.h"
+
+namespace App {
+
+ChunkMesh::ChunkMesh(ChunkMeshPool &pool, const glm::ivec3 &coord, const ChunkMeshData &data)
+    : m_pool(&pool), m_coord(coord), m_bounds{glm::vec3(0.0f), glm::vec3(0.0f)} {
+  update(data);
+}
+
+ChunkMesh::~ChunkMesh() {
+  m_pool->release(m_allocation);
+}
+
+void ChunkMesh::update(const ChunkMeshData &data) {
+  m_pool->store(m_allocation, m_coord, data);
+
+  if (data.vertices.empty()) {
+    m_bounds = {glm::vec3(0.0f), glm::vec3(0.0f)};
+    return;
+  }
+
+  m_bounds = {data.vertices.front().position, data.vertices.front().position};
+
+  for (const Vertex &vertex : data.vertices) {
+    m_bounds.min = glm::min(m_bounds.min, vertex.position);
+    m_bounds.max = glm::max(m_bounds.max, vertex.position);
+  }
+}
+
+void ChunkMesh::renderPositions() const {
+  m_pool->drawPositions(m_allocation);
+}
+
+std::optional<uint32_t> ChunkMeshPool::RangeAllocator::allocate(const uint32_t size) {
+  for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+    const auto [offset, freeSize] = *it;
+
+    if (freeSize < size) {
+      continue;
+    }
+
+    m_free.erase(it);
+
+    if (freeSize > size) {
+      m_free.emplace(offset + size, freeSize - size);
+    }
+
+    return offset;
+  }
+
+  return std::nullopt;
+}
+
+void ChunkMeshPool::RangeAllocator::release(uint32_t offset, uint32_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  auto next = m_free.lower_bound(offset);
+
+  if (next != m_free.begin()) {
+    if (const auto previous = std::prev(next); previous->first + previous->second == offset) {
+      offset = previous->first;
+      size += previous->second;
+      m_free.erase(previous);
+    }
+  }
+
+  if (next != m_free.end() && offset + size == next->first) {
+    size += next->second;
+    m_free.erase(next);
+  }
+
+  m_free.emplace(offset, size);
+}
+
+void ChunkMeshPool::RangeAllocator::grow(const uint32_t capacity) {
+  release(m_capacity, capacity - m_capacity);
+  m_capacity = capacity;
+}
+
+ChunkMeshPool::~ChunkMeshPool() {
+  for (const GLuint vao : {m_VAO, m_positionVAO}) {
+    if (vao) {
+      glDeleteVertexArrays(1, &vao);
+    }
+  }
+
+  for (const GLuint buffer : {m_vertexBuffer, m_positionBuffer, m_indexBuffer, m_originBuffer}) {
+    if (buffer) {
+      glDeleteBuffers(1, &buffer);
+    }
+  }
+
+  if (m_originTexture) {
+    glDeleteTextures(1, &m_originTexture);
+  }
+}
+
+void ChunkMeshPool::store(ChunkMeshAllocation &allocation, const glm::ivec3 &coord, const ChunkMeshData &data) {
+  const auto pageCount = static_cast<uint32_t>((data.vertices.size() + PAGE_VERTICES - 1) / PAGE_VERTICES);
+  const auto indexCount = static_cast<uint32_t>(data.indices.size());
+
+  // Keep the ranges unless the mesh outgrew them or shrank to less than half of them
+  const bool pagesFit = pageCount <= allocation.pageCount && pageCount * 2 > allocation.pageCount;
+  const bool indicesFit = indexCount <= allocation.indexCapacity && indexCount * 2 > allocation.indexCapacity;
+
+  if (!pagesFit) {
+    m_pages.release(allocation.firstPage, allocation.pageCount);
+    allocation.firstPage = pageCount ? allocatePages(pageCount) : 0;
+    allocation.pageCount = pageCount;
+  }
+
+  if (!indicesFit) {
+    m_indices.release(allocation.firstIndex, allocation.indexCapacity);
+    allocation.firstIndex = indexCount ? allocateIndices(indexCount) : 0;
+    allocation.indexCapacity = indexCount;
+  }
+
+  allocation.opaqueIndices = static_cast<uint32_t>(data.opaqueIndexCount);
+  allocation.translucentIndices = indexCount - allocation.opaqueIndices;
+
+  if (indexCount == 0) {
+    return;
+  }
+
+  // Through the copy target, binding the element buffer would change whichever VAO is bound
+  const std::size_t firstVertex = static_cast<std::size_t>(allocation.firstPage) * PAGE_VERTICES;
+  std::vector<glm::vec3> positions;
+  positions.reserve(data.vertices.size());
+
+  for (const Vertex &vertex : data.vertices) {
+    positions.push_back(vertex.position);
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstVertex * sizeof(Vertex)),
+                  static_cast<GLsizeiptr>(data.vertices.size() * sizeof(Vertex)), data.vertices.data());
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_positionBuffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(firstVertex * sizeof(glm::vec3)),
+                  static_cast<GLsizeiptr>(positions.size() * sizeof(glm::vec3)), positions.data());
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(allocation.firstIndex * sizeof(unsigned int)),
+                  static_cast<GLsizeiptr>(data.indices.size() * sizeof(unsigned int)), data.indices.data());
+
+  // Pages can change hands between chunks, so the origins are written on every store
+  const std::vector<glm::vec4> origins(allocation.pageCount, glm::vec4(glm::vec3(coord * Chunk::SIZE), 0.0f));
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_originBuffer);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(allocation.firstPage * sizeof(glm::vec4)),
+                  static_cast<GLsizeiptr>(origins.size() * sizeof(glm::vec4)), origins.data());
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void ChunkMeshPool::release(ChunkMeshAllocation &allocation) {
+  m_pages.release(allocation.firstPage, allocation.pageCount);
+  m_indices.release(allocation.firstIndex, allocation.indexCapacity);
+  allocation = {};
+}
+
+void ChunkMeshPool::drawLayer(const std::span<const ChunkDraw> draws, const ChunkLayer layer) {
+  PROFILE_SCOPE("ChunkMeshPool::drawLayer");
+
+  m_counts.clear();
+  m_offsets.clear();
+  m_baseVertices.clear();
+  std::size_t indexCount = 0;
+
+  auto add = [&](const ChunkMesh &mesh) {
+    const ChunkMeshAllocation &allocation = mesh.getAllocation();
+    const bool opaque = layer == ChunkLayer::Opaque;
+    const uint32_t count = opaque ? allocation.opaqueIndices : allocation.translucentIndices;
+
+    if (count == 0) {
+      return;
+    }
+
+    const std::size_t firstIndex = allocation.firstIndex + (opaque ? 0 : allocation.opaqueIndices);
+    m_counts.push_back(static_cast<GLsizei>(count));
+    m_offsets.push_back(reinterpret_cast<const void *>(firstIndex * sizeof(unsigned int)));
+    m_baseVertices.push_back(static_cast<GLint>(allocation.firstPage * PAGE_VERTICES));
+    indexCount += count;
+  };
+
+  // Translucent faces are blended, so they go back to front as far as the order of the cull allows: the cave culling
+  // walk finds chunks roughly near to far
+  if (layer == ChunkLayer::Opaque) {
+    for (const ChunkDraw &draw : draws) {
+      add(*draw.mesh);
+    }
+  } else {
+    for (auto it = draws.rbegin(); it != draws.rend(); ++it) {
+      add(*it->mesh);
+    }
+  }
+
+  if (m_counts.empty()) {
+    return;
+  }
+
+  glBindVertexArray(m_VAO);
+  glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_counts.data(), GL_UNSIGNED_INT, m_offsets.data(),
+                                static_cast<GLsizei>(m_counts.size()), m_baseVertices.data());
+  glBindVertexArray(0);
+
+  DrawStats &stats = Mesh::drawStats();
+  stats.drawCalls++;
+  stats.triangles += indexCount / 3;
+}
+
+void ChunkMeshPool::drawPositions(const ChunkMeshAllocation &allocation) const {
+  const uint32_t indexCount = allocation.opaqueIndices + allocation.translucentIndices;
+
+  if (indexCount == 0) {
+    return;
+  }
+
+  glBindVertexArray(m_positionVAO);
+  glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                           reinterpret_cast<const void *>(allocation.firstIndex * sizeof(unsigned int)),
+                           static_cast<GLint>(allocation.firstPage * PAGE_VERTICES));
+  glBindVertexArray(0);
+
+  DrawStats &stats = Mesh::drawStats();
+  stats.drawCalls++;
+  stats.triangles += indexCount / 3;
+}
+
+void ChunkMeshPool::bindOrigins() const {
+  glActiveTexture(GL_TEXTURE0 + CHUNK_ORIGINS_TEXTURE_INDEX);
+  glBindTexture(GL_TEXTURE_BUFFER, m_originTexture);
+  glActiveTexture(GL_TEXTURE0);
+}
+
+uint32_t ChunkMeshPool::allocatePages(const uint32_t count) {
+  if (const std::optional<uint32_t> offset = m_pages.allocate(count)) {
+    return *offset;
+  }
+
+  growPages(std::max({INITIAL_PAGES, m_pages.capacity() * 2, m_pages.capacity() + count}));
+  return *m_pages.allocate(count);
+}
+
+uint32_t ChunkMeshPool::allocateIndices(const uint32_t count) {
+  if (const std::optional<uint32_t> offset = m_indices.allocate(count)) {
+    return *offset;
+  }
+
+  growIndices(std::max({INITIAL_INDICES, m_indices.capacity() * 2, m_indices.capacity() + count}));
+  return *m_indices.allocate(count);
+}
+
+void ChunkMeshPool::growPages(const uint32_t capacity) {
+  GLint maxTexels = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+
+  if (capacity > static_cast<uint32_t>(maxTexels)) {
+    SPDLOG_ERROR("Chunk mesh pool needs {} pages, texture buffers only hold {}", capacity, maxTexels);
+  }
+
+  const std::size_t keptVertices = static_cast<std::size_t>(m_pages.capacity()) * PAGE_VERTICES;
+  const std::size_t vertices = static_cast<std::size_t>(capacity) * PAGE_VERTICES;
+
+  m_vertexBuffer = resizeBuffer(m_vertexBuffer, keptVertices * sizeof(Vertex), vertices * sizeof(Vertex));
+  m_positionBuffer =
+      resizeBuffer(m_positionBuffer, keptVertices * sizeof(glm::vec3), vertices * sizeof(glm::vec3));
+  m_originBuffer =
+      resizeBuffer(m_originBuffer, m_pages.capacity() * sizeof(glm::vec4), capacity * sizeof(glm::vec4));
+
+  if (!m_originTexture) {
+    glGenTextures(1, &m_originTexture);
+  }
+
+  glBindTexture(GL_TEXTURE_BUFFER, m_originTexture);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_originBuffer);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+  m_pages.grow(capacity);
+  bindAttributes();
+  trackMemory();
+}
+
+void ChunkMeshPool::growIndices(const uint32_t capacity) {
+  m_indexBuffer = resizeBuffer(m_indexBuffer, m_indices.capacity() * sizeof(unsigned int),
+                               static_cast<std::size_t>(capacity) * sizeof(unsigned int));
+  m_indices.grow(capacity);
+  bindAttributes();
+  trackMemory();
+}
+
+void ChunkMeshPool::bindAttributes() {
+  // Runs whenever a buffer was replaced, until both pools grew once some are still missing
+  if (!m_VAO) {
+    glGenVertexArrays(1, &m_VAO);
+    glGenVertexArrays(1, &m_positionVAO);
+  }
+
+  auto attribute = [](const GLuint index, const GLint size, const GLsizei stride, const std::size_t offset) {
+    glEnableVertexAttribArray(index);
+    glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<void *>(offset));
+  };
+
+  glBindVertexArray(m_VAO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+  if (m_vertexBuffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    attribute(positionAttrIndex, 3, sizeof(Vertex), offsetof(Vertex, position));
+    attribute(colorAttrIndex, 4, sizeof(Vertex), offsetof(Vertex, color));
+    attribute(normalAttrIndex, 3, sizeof(Vertex), offsetof(Vertex, normal));
+    attribute(uvAttrIndex, 2, sizeof(Vertex), offsetof(Vertex, uv));
+  }
+
+  glBindVertexArray(m_positionVAO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+  if (m_positionBuffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_positionBuffer);
+    attribute(positionAttrIndex, 3, sizeof(glm::vec3), 0);
+  }
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ChunkMeshPool::trackMemory() {
+  const auto pages = static_cast<std::size_t>(m_pages.capacity());
+  m_gpuMemory.set(pages * PAGE_VERTICES * (sizeof(Vertex) + sizeof(glm::vec3)) + pages * sizeof(glm::vec4) +
+                  static_cast<std::size_t>(m_indices.capacity()) * sizeof(unsigned int));
+}
+
+GLuint ChunkMeshPool::resizeBuffer(const GLuint buffer, const std::size_t keptBytes, const std::size_t bytes) {
+  GLuint resized = 0;
+  glGenBuffers(1, &resized);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, resized);
+  glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_DYNAMIC_DRAW);
+
+  if (buffer) {
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(keptBytes));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  return resized;
+}
+
+} // namespace App
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+#include "ChunkMesher.h"
+#include "DeferredRenderer.h"
+#include "MemoryAccounting.h"
+#include "Mesh.h"
+
+namespace App {
+
+struct ChunkDraw;
+class ChunkMeshPool;
+
+/// Texture unit of the chunk origins, right after the G-buffer.
+enum ChunkPoolTextureIndex {
+  CHUNK_ORIGINS_TEXTURE_INDEX = GBUFFER_DEPTH_TEXTURE_INDEX + 1,
+};
+
+/// Faces drawn together across all chunks. Translucent ones go after every opaque one, so water never hides the
+/// terrain of a chunk drawn after it.
+enum class ChunkLayer : uint8_t {
+  Opaque,
+  Translucent,
+};
+
+/// Where one chunk's geometry lives in the pool. Vertices are allocated in whole pages, indices one by one.
+struct ChunkMeshAllocation {
+  uint32_t firstPage = 0;
+  uint32_t pageCount = 0;
+  uint32_t firstIndex = 0;
+  uint32_t indexCapacity = 0;
+  uint32_t opaqueIndices = 0;      // From firstIndex
+  uint32_t translucentIndices = 0; // After the opaque ones
+};
+
+/// One chunk's mesh, stored in a pool shared by every chunk. Nothing is kept on the CPU side but its bounds.
+class ChunkMesh {
+public:
+  ChunkMesh(ChunkMeshPool &pool, const glm::ivec3 &coord, const ChunkMeshData &data);
+  ~ChunkMesh();
+
+  ChunkMesh(const ChunkMesh &) = delete;
+  ChunkMesh &operator=(const ChunkMesh &) = delete;
+
+  /// Replaces the geometry, keeping its place in the pool when the new one fits.
+  void update(const ChunkMeshData &data);
+
+  /// Draws both layers from the position stream, in chunk-local coordinates, for depth only passes.
+  void renderPositions() const;
+
+  [[nodiscard]] std::size_t getIndexCount() const {
+    return m_allocation.opaqueIndices + m_allocation.translucentIndices;
+  }
+
+  /// Bounds of the vertex positions, in chunk-local space.
+  [[nodiscard]] const AABB &getBounds() const {
+    return m_bounds;
+  }
+
+  [[nodiscard]] const ChunkMeshAllocation &getAllocation() const {
+    return m_allocation;
+  }
+
+private:
+  ChunkMeshPool *m_pool;
+  glm::ivec3 m_coord;
+  AABB m_bounds;
+  ChunkMeshAllocation m_allocation;
+};
+
+/// Vertex, position and index buffers shared by all chunk meshes, so a whole layer of visible chunks is drawn with a
+/// single glMultiDrawElementsBaseVertex.
+///
+/// GL 3.3 has no gl_DrawID to tell the sub-draws apart, so vertices are allocated in pages of PAGE_VERTICES and a
+/// texture buffer holds the origin of the chunk owning each page. With a base vertex gl_VertexID already counts from
+/// the start of the pool, chunk.vert finds its origin at gl_VertexID / PAGE_VERTICES. Costs half a page per chunk on
+/// average instead of a per-vertex chunk index. Buffers grow by copying on the GPU when full.
+class ChunkMeshPool {
+public:
+  /// Matches CHUNK_PAGE_VERTICES in chunk.vert.
+  static constexpr uint32_t PAGE_VERTICES = 64;
+
+  ChunkMeshPool() = default;
+  ~ChunkMeshPool();
+
+  ChunkMeshPool(const ChunkMeshPool &) = delete;
+  ChunkMeshPool &operator=(const ChunkMeshPool &) = delete;
+
+  /// Uploads a chunk's geometry, reusing the ranges of `allocation` when they fit. Opaque indices come first in
+  /// `data.indices`. GL thread only, the buffers are created on first use.
+  void store(ChunkMeshAllocation &allocation, const glm::ivec3 &coord, const ChunkMeshData &data);
+
+  /// Gives the ranges back, `allocation` is left empty.
+  void release(ChunkMeshAllocation &allocation);
+
+  /// Draws one layer of every chunk in `draws` with one call. The shader in use must be chunk.vert's.
+  void drawLayer(std::span<const ChunkDraw> draws, ChunkLayer layer);
+
+  /// Draws a single allocation from the position stream.
+  void drawPositions(const ChunkMeshAllocation &allocation) const;
+
+  /// Binds the page origins for chunk.vert.
+  void bindOrigins() const;
+
+  [[nodiscard]] std::size_t getVertexCapacity() const {
+    return static_cast<std::size_t>(m_pages.capacity()) * PAGE_VERTICES;
+  }
+
+  [[nodiscard]] std::size_t getIndexCapacity() const {
+    return m_indices.capacity();
+  }
+
+private:
+  /// First fit over free ranges kept sorted, neighbours merge on release.
+  class RangeAllocator {
+  public:
+    std::optional<uint32_t> allocate(uint32_t size);
+    void release(uint32_t offset, uint32_t size);
+    void grow(uint32_t capacity);
+
+    [[nodiscard]] uint32_t capacity() const {
+      return m_capacity;
+    }
+
+  private:
+    std::map<uint32_t, uint32_t> m_free; // Offset to size
+    uint32_t m_capacity = 0;
+  };
+
+  static constexpr uint32_t INITIAL_PAGES = 4096;
+  static constexpr uint32_t INITIAL_INDICES = INITIAL_PAGES * PAGE_VERTICES * 3 / 2; // 6 indices per 4 vertices
+
+  RangeAllocator m_pages;
+  RangeAllocator m_indices;
+
+  GLuint m_VAO = 0;
+  GLuint m_positionVAO = 0;
+  GLuint m_vertexBuffer = 0;
+  GLuint m_positionBuffer = 0;
+  GLuint m_indexBuffer = 0;
+  GLuint m_originBuffer = 0;
+  GLuint m_originTexture = 0;
+  TrackedMemory m_gpuMemory{MemoryTag::Terrain, MemoryPool::Gpu};
+
+  // Reused by every drawLayer
+  std::vector<GLsizei> m_counts;
+  std::vector<const void *> m_offsets;
+  std::vector<GLint> m_baseVertices;
+
+  uint32_t allocatePages(uint32_t count);
+  uint32_t allocateIndices(uint32_t count);
+  void growPages(uint32_t capacity);
+  void growIndices(uint32_t capacity);
+  void bindAttributes();
+  void trackMemory();
+  static GLuint resizeBuffer(GLuint buffer, std::size_t keptBytes, std::size_t bytes);
+};
+
+} // namespace App
@@ -0,0 +1,182 @@
+#include "ChunkMesher.h"
+
+// Corners of each block face, counter-clockwise when seen from outside the block
+constexpr glm::vec3 FACE_CORNERS[BLOCK_FACE_COUNT][4] = {
+    {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, // NegX
+    {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}}, // PosX
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, // NegY
+    {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}}, // PosY
+    {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}, // NegZ
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // PosZ
+};
+
+constexpr glm::vec2 FACE_UVS[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+namespace {
+
+/// Occluders of each corner of a face: the two blocks beside the corner and the one diagonal to it, all in the layer
+/// in front of the face. With both sides opaque the diagonal is hidden anyway, the corner is as dark as it gets.
+template <class Occludes>
+std::array<uint8_t, 4> cornerOcclusion(const Occludes &occludes, const glm::ivec3 &pos, const int face) {
+  const glm::ivec3 front = pos + BLOCK_FACE_NORMALS[face];
+  // The two axes spanning the face, faces come in pairs along each axis
+  const int uAxis = (face / 2 + 1) % 3;
+  const int vAxis = (face / 2 + 2) % 3;
+  std::array<uint8_t, 4> occlusion{};
+
+  for (int corner = 0; corner < 4; corner++) {
+    glm::ivec3 u(0), v(0);
+    u[uAxis] = FACE_CORNERS[face][corner][uAxis] > 0.0f ? 1 : -1;
+    v[vAxis] = FACE_CORNERS[face][corner][vAxis] > 0.0f ? 1 : -1;
+
+    const bool side1 = occludes(front + u);
+    const bool side2 = occludes(front + v);
+    occlusion[corner] = side1 && side2 ? 3 : static_cast<uint8_t>(side1 + side2 + occludes(front + u + v));
+  }
+
+  return occlusion;
+}
+
+} // namespace
+
+ChunkMeshData ChunkMesher::build(const ChunkMap &chunks, const Chunk &chunk, const int lod, const uint8_t openFaces,
+                                 const bool ambientOcclusion) {
+  ChunkMeshData data;
+  data.connectivity = computeFaceConnectivity(chunk);
+  data.solidLayers = countSolidLayers(chunk);
+
+  const std::vector<BlockType> &cells = chunk.getLodData(lod);
+
+  if (cells.empty()) {
+    return data;
+  }
+
+  const int size = Chunk::lodSize(lod);
+  const auto cellSize = static_cast<float>(1 << lod);
+
+  // Coarse levels never look into their neighbours, their boundary is always closed
+  const Chunk *neighbours[BLOCK_FACE_COUNT] = {};
+
+  if (lod == 0) {
+    for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+      if (!(openFaces & faceBit(static_cast<BlockFace>(face)))) {
+        neighbours[face] = chunks.find(chunk.getCoord() + BLOCK_FACE_NORMALS[face]);
+      }
+    }
+  }
+
+  // Ambient occlusion also looks diagonally across the edges and corners, whatever the LOD of the chunks there
+  const Chunk *around[27] = {};
+  auto aroundIndex = [](const glm::ivec3 &side) { return (side.z + 1) * 9 + (side.y + 1) * 3 + side.x + 1; };
+
+  if (lod == 0 && ambientOcclusion) {
+    for (int z = -1; z <= 1; z++) {
+      for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+          if (x != 0 || y != 0 || z != 0) {
+            around[aroundIndex({x, y, z})] = chunks.find(chunk.getCoord() + glm::ivec3(x, y, z));
+          }
+        }
+      }
+    }
+  }
+
+  auto occludes = [&](glm::ivec3 pos) {
+    if (pos.x >= 0 && pos.y >= 0 && pos.z >= 0 && pos.x < size && pos.y < size && pos.z < size) {
+      return isOpaque(cells[Chunk::index(pos.x, pos.y, pos.z, size)]);
+    }
+
+    glm::ivec3 side(0);
+
+    for (int axis = 0; axis < 3; axis++) {
+      side[axis] = pos[axis] < 0 ? -1 : pos[axis] >= size ? 1 : 0;
+    }
+
+    const Chunk *neighbour = around[aroundIndex(side)];
+
+    if (!neighbour) {
+      return false;
+    }
+
+    pos = (pos + Chunk::SIZE) % Chunk::SIZE;
+    return isOpaque(neighbour->get(pos.x, pos.y, pos.z));
+  };
+
+  auto neighbourCell = [&](const int face, glm::ivec3 pos) {
+    if (pos.x >= 0 && pos.y >= 0 && pos.z >= 0 && pos.x < size && pos.y < size && pos.z < size) {
+      return cells[Chunk::index(pos.x, pos.y, pos.z, size)];
+    }
+
+    const Chunk *neighbour = neighbours[face];
+
+    if (!neighbour) {
+      return BlockType::Air;
+    }
+
+    pos = (pos + Chunk::SIZE) % Chunk::SIZE;
+    return neighbour->get(pos.x, pos.y, pos.z);
+  };
+
+  std::vector<unsigned int> translucentIndices;
+
+  for (int y = 0; y < size; y++) {
+    for (int z = 0; z < size; z++) {
+      for (int x = 0; x < size; x++) {
+        const BlockType type = cells[Chunk::index(x, y, z, size)];
+
+        if (!isSolid(type)) {
+          continue;
+        }
+
+        const glm::ivec3 pos(x, y, z);
+        const glm::vec3 cellMin = glm::vec3(pos) * cellSize;
+        const glm::vec4 color = blockColor(type);
+        std::vector<unsigned int> &indices = isOpaque(type) ? data.indices : translucentIndices;
+
+        for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+          const BlockType neighbour = neighbourCell(face, pos + BLOCK_FACE_NORMALS[face]);
+
+          if (isOpaque(neighbour) || neighbour == type) {
+            continue;
+          }
+
+          const std::array<uint8_t, 4> occlusion =
+              ambientOcclusion ? cornerOcclusion(occludes, pos, face) : std::array<uint8_t, 4>{};
+          emitFace(data, indices, cellMin, cellSize, static_cast<BlockFace>(face), color, occlusion);
+        }
+      }
+    }
+  }
+
+  data.opaqueIndexCount = data.indices.size();
+  data.indices.insert(data.indices.end(), translucentIndices.begin(), translucentIndices.end());
+  return data;
+}
+
+void ChunkMesher::emitFace(ChunkMeshData &data, std::vector<unsigned int> &indices, const glm::vec3 &cellMin,
+                           const float cellSize, const BlockFace face, const glm::vec4 &color,
+                           const std::array<uint8_t, 4> &occlusion) {
+  const auto faceIndex = static_cast<uint8_t>(face);
+  const auto base = static_cast<unsigned int>(data.vertices.size());
+  const glm::vec3 normal(BLOCK_FACE_NORMALS[faceIndex]);
+
+  for (int corner = 0; corner < 4; corner++) {
+    Vertex vertex{};
+    vertex.position = cellMin + FACE_CORNERS[faceIndex][corner] * cellSize;
+    vertex.color =
+        glm::vec4(glm::vec3(color) * App::Config::World::AMBIENT_OCCLUSION_BRIGHTNESS[occlusion[corner]], color.a);
+    vertex.normal = normal;
+    vertex.uv = FACE_UVS[corner];
+    data.vertices.push_back(vertex);
+  }
+
+  // Split along the lighter diagonal. Across the darker one a single occluded corner would shade both triangles,
+  // and the same occlusion would look different depending on which corner it is in
+  constexpr std::array<unsigned int, 6> SPLIT_02 = {0, 1, 2, 0, 2, 3};
+  constexpr std::array<unsigned int, 6> SPLIT_13 = {1, 2, 3, 1, 3, 0};
+  const bool flip = occlusion[0] + occlusion[2] > occlusion[1] + occlusion[3];
+
+  for (const unsigned int offset : flip ? SPLIT_13 : SPLIT_02) {
+    indices.push_back(base + offset);
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ChunkMap.h"
+#include "ChunkVisibility.h"
+#include "Mesh.h"
+
+struct ChunkMeshData {
+  std::vector<Vertex> vertices;
+  std::vector<unsigned int> indices;
+  /// Indices of opaque faces, at the front. Translucent ones (water) follow, they are drawn after all opaque terrain.
+  std::size_t opaqueIndexCount = 0;
+  /// Face-to-face connectivity of the full resolution blocks, used for cave culling.
+  VisibilityMask connectivity = ALL_FACES_CONNECTED;
+  /// Fully opaque layers at the bottom of the full resolution blocks, used as an occlusion culling slab.
+  int solidLayers = 0;
+};
+
+/// Bit of a BlockFace inside a face mask.
+constexpr uint8_t faceBit(const BlockFace face) {
+  return static_cast<uint8_t>(1u << static_cast<uint8_t>(face));
+}
+
+constexpr uint8_t ALL_FACES_MASK = (1u << BLOCK_FACE_COUNT) - 1;
+
+class ChunkMesher {
+public:
+  /// Builds the mesh of a chunk at the given LOD, in chunk-local coordinates (one unit per full resolution block).
+  ///
+  /// Boundary faces are culled against the neighbouring chunks, except along the faces set in `openFaces`. Those are
+  /// always emitted, which closes the mesh towards neighbours rendered at a different LOD so no crack can open
+  /// between the two surfaces.
+  ///
+  /// With `ambientOcclusion` the corners of each face are darkened by the blocks around them, looking into every
+  /// loaded neighbour at full resolution and only within the chunk at coarser levels.
+  static ChunkMeshData build(const ChunkMap &chunks, const Chunk &chunk, int lod, uint8_t openFaces,
+                             bool ambientOcclusion = App::Config::World::BAKED_AMBIENT_OCCLUSION);
+
+private:
+  /// `occlusion` holds the occluder count of each corner, 0 to 3.
+  static void emitFace(ChunkMeshData &data, std::vector<unsigned int> &indices, const glm::vec3 &cellMin,
+                       float cellSize, BlockFace face, const glm::vec4 &color,
+                       const std::array<uint8_t, 4> &occlusion);
+};
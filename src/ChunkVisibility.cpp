@@ -0,0 +1,83 @@
+#include "ChunkVisibility.h"
+
+#include <bitset>
+
+VisibilityMask computeFaceConnectivity(const Chunk &chunk) {
+  if (chunk.isEmpty()) {
+    return ALL_FACES_CONNECTED;
+  }
+
+  constexpr int size = Chunk::SIZE;
+
+  std::bitset<Chunk::VOLUME> visited;
+  std::vector<int> stack;
+  stack.reserve(Chunk::VOLUME);
+
+  VisibilityMask connectivity = 0;
+
+  for (int start = 0; start < Chunk::VOLUME && connectivity != ALL_FACES_CONNECTED; start++) {
+    const int startX = start % size;
+    const int startZ = start / size % size;
+    const int startY = start / (size * size);
+
+    if (visited[start] || isOpaque(chunk.get(startX, startY, startZ))) {
+      continue;
+    }
+
+    uint8_t touchedFaces = 0;
+    visited[start] = true;
+    stack.push_back(start);
+
+    while (!stack.empty()) {
+      const int cell = stack.back();
+      stack.pop_back();
+
+      const glm::ivec3 pos(cell % size, cell / (size * size), cell / size % size);
+
+      for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+        const glm::ivec3 next = pos + BLOCK_FACE_NORMALS[face];
+
+        if (next.x < 0 || next.y < 0 || next.z < 0 || next.x >= size || next.y >= size || next.z >= size) {
+          touchedFaces |= 1u << face;
+          continue;
+        }
+
+        const int nextIndex = Chunk::index(next.x, next.y, next.z, size);
+
+        if (!visited[nextIndex] && !isOpaque(chunk.get(next.x, next.y, next.z))) {
+          visited[nextIndex] = true;
+          stack.push_back(nextIndex);
+        }
+      }
+    }
+
+    // Every pair of faces reached by the same region can see each other
+    for (int a = 0; a < BLOCK_FACE_COUNT; a++) {
+      for (int b = a + 1; b < BLOCK_FACE_COUNT; b++) {
+        if ((touchedFaces >> a & 1u) && (touchedFaces >> b & 1u)) {
+          connectivity |= 1u << facePairIndex(static_cast<BlockFace>(a), static_cast<BlockFace>(b));
+        }
+      }
+    }
+  }
+
+  return connectivity;
+}
+
+int countSolidLayers(const Chunk &chunk) {
+  if (chunk.isEmpty()) {
+    return 0;
+  }
+
+  for (int y = 0; y < Chunk::SIZE; y++) {
+    for (int z = 0; z < Chunk::SIZE; z++) {
+      for (int x = 0; x < Chunk::SIZE; x++) {
+        if (!isOpaque(chunk.get(x, y, z))) {
+          return y;
+        }
+      }
+    }
+  }
+
+  return Chunk::SIZE;
+}
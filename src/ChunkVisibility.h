@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "Chunk.h"
+
+/// Which pairs of chunk faces are connected through non-opaque cells, one bit per pair (15 pairs of 6 faces).
+using VisibilityMask = uint16_t;
+
+constexpr VisibilityMask ALL_FACES_CONNECTED = 0x7FFF;
+
+constexpr int facePairIndex(const BlockFace a, const BlockFace b) {
+  const int low = std::min(static_cast<int>(a), static_cast<int>(b));
+  const int high = std::max(static_cast<int>(a), static_cast<int>(b));
+
+  // Pairs are numbered (0,1)..(0,5), (1,2)..(1,5), ... (4,5)
+  return low * BLOCK_FACE_COUNT - low * (low + 1) / 2 + (high - low - 1);
+}
+
+constexpr bool areFacesConnected(const VisibilityMask mask, const BlockFace a, const BlockFace b) {
+  return a == b || (mask >> facePairIndex(a, b) & 1u);
+}
+
+/// Flood fills the non-opaque cells of a chunk and records which faces each connected region touches.
+VisibilityMask computeFaceConnectivity(const Chunk &chunk);
+
+/// Number of fully opaque block layers at the bottom of a chunk, the slab they form can hide what lies behind it.
+int countSolidLayers(const Chunk &chunk);
@@ -0,0 +1,331 @@
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Config.h"
+#include "Profiler.h"
+#include "Simd.h"
+
+namespace App {
+
+namespace {
+using namespace Config::Renderer;
+
+constexpr int CLUSTER_COUNT = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+constexpr std::size_t LIGHT_TEXELS = 4;
+
+/// A frame at the clustering limits, with room to align each of its three ranges.
+constexpr std::size_t STREAM_BYTES_PER_FRAME = MAX_CLUSTERED_LIGHTS * LIGHT_TEXELS * sizeof(glm::vec4) +
+                                               CLUSTER_COUNT * sizeof(glm::uvec2) +
+                                               MAX_CLUSTER_LIGHT_INDICES * sizeof(uint32_t) + 3 * 256;
+
+/// Stands in for infinite ranges, big enough to cover every cluster and small enough to keep the bounds math finite.
+constexpr float UNBOUNDED_RANGE = 1e30f;
+
+/// Depth slice of a view depth is log(depth) * scale + bias, slices grow exponentially from the near to the far plane.
+struct DepthSlicing {
+  float scale;
+  float bias;
+};
+
+DepthSlicing depthSlicing() {
+  const float logRatio = std::log(FAR_PLANE / NEAR_PLANE);
+  return {LIGHT_CLUSTERS_Z / logRatio, -LIGHT_CLUSTERS_Z * std::log(NEAR_PLANE) / logRatio};
+}
+
+/// Cells covering a coordinate in -1..1, clamped to the grid.
+int toCell(const float ndc, const int cells) {
+  const float cell = std::floor((std::clamp(ndc, -1.0f, 1.0f) * 0.5f + 0.5f) * static_cast<float>(cells));
+  return std::min(static_cast<int>(cell), cells - 1);
+}
+
+int toSlice(const float depth, const DepthSlicing &slicing) {
+  const float slice = std::log(std::max(depth, NEAR_PLANE)) * slicing.scale + slicing.bias;
+  return std::clamp(static_cast<int>(slice), 0, LIGHT_CLUSTERS_Z - 1);
+}
+
+/// Clusters a light touches, inclusive. Empty if `min` is past `max`.
+struct ClusterBounds {
+  glm::ivec3 min;
+  glm::ivec3 max;
+};
+
+template <class F> void forEachCluster(const ClusterBounds &bounds, F &&function) {
+  for (int z = bounds.min.z; z <= bounds.max.z; z++) {
+    for (int y = bounds.min.y; y <= bounds.max.y; y++) {
+      const int row = (z * LIGHT_CLUSTERS_Y + y) * LIGHT_CLUSTERS_X;
+
+      for (int x = bounds.min.x; x <= bounds.max.x; x++) {
+        function(row + x);
+      }
+    }
+  }
+}
+} // namespace
+
+LightClusters assignLightClusters(const std::span<const Light> allLights, const glm::mat4 &viewMatrix,
+                                  const glm::mat4 &projectionMatrix, const glm::vec2 viewportSize, FrameArena &arena) {
+  PROFILE_SCOPE("Assign light clusters");
+
+  const std::span<const Light> lights =
+      allLights.first(std::min<std::size_t>(allLights.size(), MAX_CLUSTERED_LIGHTS));
+  const std::size_t count = lights.size();
+
+  LightClusters clusters;
+  clusters.viewportSize = viewportSize;
+  clusters.stats.lights = count;
+
+  // Structure-of-arrays copies padded to whole SIMD lanes, the padding stays zero and is never read back
+  const std::size_t lanes = (count + 3) & ~std::size_t{3};
+  const std::span<glm::vec4> texels = arena.allocateArray<glm::vec4>(count * LIGHT_TEXELS);
+  const std::span<float> x = arena.allocateArray<float>(lanes);
+  const std::span<float> y = arena.allocateArray<float>(lanes);
+  const std::span<float> z = arena.allocateArray<float>(lanes);
+  const std::span<float> radius = arena.allocateArray<float>(lanes);
+
+  for (std::size_t i = 0; i < count; i++) {
+    const Light &light = lights[i];
+    const float range = light.range();
+    const bool bounded = std::isfinite(range);
+
+    // A negative range tells the shaders the light never fades out
+    texels[i * LIGHT_TEXELS + 0] = glm::vec4(light.position, bounded ? range : -1.0f);
+    texels[i * LIGHT_TEXELS + 1] = glm::vec4(glm::vec3(light.color) * light.intensity, static_cast<float>(light.type));
+    texels[i * LIGHT_TEXELS + 2] = glm::vec4(light.direction, light.innerCutoff);
+    texels[i * LIGHT_TEXELS + 3] = glm::vec4(light.constant, light.linear, light.quadratic, light.outerCutoff);
+
+    x[i] = light.position.x;
+    y[i] = light.position.y;
+    z[i] = light.position.z;
+    radius[i] = bounded ? range : UNBOUNDED_RANGE;
+  }
+
+  // Projected extents of every light's view space box, four lights at a time. Over the box, x / depth is monotonic
+  // along both axes, so the extremes are at its corners
+  const std::span<float> minX = arena.allocateArray<float>(lanes);
+  const std::span<float> maxX = arena.allocateArray<float>(lanes);
+  const std::span<float> minY = arena.allocateArray<float>(lanes);
+  const std::span<float> maxY = arena.allocateArray<float>(lanes);
+  const std::span<float> nearDepths = arena.allocateArray<float>(lanes);
+  const std::span<float> farDepths = arena.allocateArray<float>(lanes);
+
+  const glm::mat4 &m = viewMatrix;
+  const Simd::Float4 nearPlane(NEAR_PLANE);
+  const Simd::Float4 scaleX(projectionMatrix[0][0]);
+  const Simd::Float4 scaleY(projectionMatrix[1][1]);
+
+  for (std::size_t i = 0; i < lanes; i += 4) {
+    const Simd::Float4 worldX = Simd::Float4::load(&x[i]);
+    const Simd::Float4 worldY = Simd::Float4::load(&y[i]);
+    const Simd::Float4 worldZ = Simd::Float4::load(&z[i]);
+    const Simd::Float4 r = Simd::Float4::load(&radius[i]);
+
+    const Simd::Float4 viewX = Simd::Float4(m[0][0]) * worldX + Simd::Float4(m[1][0]) * worldY +
+                               Simd::Float4(m[2][0]) * worldZ + Simd::Float4(m[3][0]);
+    const Simd::Float4 viewY = Simd::Float4(m[0][1]) * worldX + Simd::Float4(m[1][1]) * worldY +
+                               Simd::Float4(m[2][1]) * worldZ + Simd::Float4(m[3][1]);
+    const Simd::Float4 depth = Simd::Float4(0.0f) - (Simd::Float4(m[0][2]) * worldX + Simd::Float4(m[1][2]) * worldY +
+                                                     Simd::Float4(m[2][2]) * worldZ + Simd::Float4(m[3][2]));
+
+    const Simd::Float4 nearDepth = max(depth - r, nearPlane);
+    const Simd::Float4 farDepth = max(depth + r, nearPlane);
+    const Simd::Float4 left = viewX - r;
+    const Simd::Float4 right = viewX + r;
+    const Simd::Float4 bottom = viewY - r;
+    const Simd::Float4 top = viewY + r;
+
+    (scaleX * min(left / nearDepth, left / farDepth)).store(&minX[i]);
+    (scaleX * max(right / nearDepth, right / farDepth)).store(&maxX[i]);
+    (scaleY * min(bottom / nearDepth, bottom / farDepth)).store(&minY[i]);
+    (scaleY * max(top / nearDepth, top / farDepth)).store(&maxY[i]);
+    // Unclamped, so lights wholly behind the camera or past the far plane can be told apart
+    (depth - r).store(&nearDepths[i]);
+    (depth + r).store(&farDepths[i]);
+  }
+
+  const DepthSlicing slicing = depthSlicing();
+  const std::span<ClusterBounds> bounds = arena.allocateArray<ClusterBounds>(count);
+
+  for (std::size_t i = 0; i < count; i++) {
+    const bool visible = farDepths[i] >= NEAR_PLANE && nearDepths[i] <= FAR_PLANE && maxX[i] >= -1.0f &&
+                         minX[i] <= 1.0f && maxY[i] >= -1.0f && minY[i] <= 1.0f;
+
+    bounds[i] = {
+        .min = {toCell(minX[i], LIGHT_CLUSTERS_X), toCell(minY[i], LIGHT_CLUSTERS_Y), toSlice(nearDepths[i], slicing)},
+        .max = {toCell(maxX[i], LIGHT_CLUSTERS_X), toCell(maxY[i], LIGHT_CLUSTERS_Y), toSlice(farDepths[i], slicing)},
+    };
+
+    if (!visible) {
+      bounds[i].max = bounds[i].min - 1;
+    }
+  }
+
+  // Count, lay the clusters out back to back, then scatter the light indices into them
+  const std::span<uint32_t> counts = arena.allocateArray<uint32_t>(CLUSTER_COUNT);
+
+  for (const ClusterBounds &lightBounds : bounds) {
+    if (lightBounds.min.x > lightBounds.max.x) {
+      clusters.stats.culledLights++;
+      continue;
+    }
+
+    forEachCluster(lightBounds, [&](const int cluster) { counts[cluster]++; });
+  }
+
+  const std::span<glm::uvec2> ranges = arena.allocateArray<glm::uvec2>(CLUSTER_COUNT);
+  uint32_t offset = 0;
+
+  for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+    const uint32_t wanted = counts[cluster];
+    const uint32_t kept = std::min({wanted, static_cast<uint32_t>(MAX_LIGHTS_PER_CLUSTER),
+                                    static_cast<uint32_t>(MAX_CLUSTER_LIGHT_INDICES) - offset});
+
+    ranges[cluster] = {offset, 0};
+    counts[cluster] = kept;
+    offset += kept;
+
+    clusters.stats.droppedAssignments += wanted - kept;
+    clusters.stats.busiestCluster = std::max<std::size_t>(clusters.stats.busiestCluster, kept);
+  }
+
+  const std::span<uint32_t> indices = arena.allocateArray<uint32_t>(offset);
+
+  for (std::size_t i = 0; i < count; i++) {
+    forEachCluster(bounds[i], [&](const int cluster) {
+      if (glm::uvec2 &range = ranges[cluster]; range.y < counts[cluster]) {
+        indices[range.x + range.y++] = static_cast<uint32_t>(i);
+      }
+    });
+  }
+
+  clusters.stats.assignments = offset;
+  clusters.lightTexels = texels;
+  clusters.clusterRanges = ranges;
+  clusters.lightIndices = indices;
+  return clusters;
+}
+
+ClusteredLighting::~ClusteredLighting() {
+  destroy(m_lights);
+  destroy(m_ranges);
+  destroy(m_indices);
+}
+
+void ClusteredLighting::setup() {
+  create(m_lights, GL_RGBA32F);
+  create(m_ranges, GL_RG32UI);
+  create(m_indices, GL_R32UI);
+
+  if (StreamBuffer::hasTextureBufferRange()) {
+    m_stream = std::make_unique<StreamBuffer>(STREAM_BYTES_PER_FRAME);
+  }
+}
+
+void ClusteredLighting::upload(const LightClusters &clusters) {
+  PROFILE_SCOPE("Upload light clusters");
+  m_viewportSize = clusters.viewportSize;
+
+  if (m_stream) {
+    // Fences the last frame's region behind the draws that read it, before moving on to this frame's
+    m_stream->endFrame();
+    m_stream->beginFrame();
+
+    if (stream(m_lights, clusters.lightTexels.data(), clusters.lightTexels.size_bytes()) &&
+        stream(m_ranges, clusters.clusterRanges.data(), clusters.clusterRanges.size_bytes()) &&
+        stream(m_indices, clusters.lightIndices.data(), clusters.lightIndices.size_bytes())) {
+      return;
+    }
+  }
+
+  upload(m_lights, clusters.lightTexels.data(), clusters.lightTexels.size_bytes());
+  upload(m_ranges, clusters.clusterRanges.data(), clusters.clusterRanges.size_bytes());
+  upload(m_indices, clusters.lightIndices.data(), clusters.lightIndices.size_bytes());
+}
+
+void ClusteredLighting::bind(Shader &shader) const {
+  const DepthSlicing slicing = depthSlicing();
+
+  glActiveTexture(GL_TEXTURE0 + CLUSTER_LIGHTS_TEXTURE_INDEX);
+  glBindTexture(GL_TEXTURE_BUFFER, m_lights.texture);
+  glActiveTexture(GL_TEXTURE0 + CLUSTER_RANGES_TEXTURE_INDEX);
+  glBindTexture(GL_TEXTURE_BUFFER, m_ranges.texture);
+  glActiveTexture(GL_TEXTURE0 + CLUSTER_INDICES_TEXTURE_INDEX);
+  glBindTexture(GL_TEXTURE_BUFFER, m_indices.texture);
+  glActiveTexture(GL_TEXTURE0);
+
+  shader.set("uClusterLights", static_cast<int>(CLUSTER_LIGHTS_TEXTURE_INDEX));
+  shader.set("uClusterRanges", static_cast<int>(CLUSTER_RANGES_TEXTURE_INDEX));
+  shader.set("uClusterIndices", static_cast<int>(CLUSTER_INDICES_TEXTURE_INDEX));
+  shader.set("uClusters.size", glm::ivec3(LIGHT_CLUSTERS_X, LIGHT_CLUSTERS_Y, LIGHT_CLUSTERS_Z));
+  shader.set("uClusters.viewportSize", m_viewportSize);
+  shader.set("uClusters.depthScale", slicing.scale);
+  shader.set("uClusters.depthBias", slicing.bias);
+}
+
+bool ClusteredLighting::stream(TextureBuffer &textureBuffer, const void *data, std::size_t bytes) {
+  // Texture buffer ranges can't be empty
+  constexpr glm::vec4 empty(0.0f);
+
+  if (bytes == 0) {
+    data = &empty;
+    bytes = sizeof(empty);
+  }
+
+  const std::optional<GLintptr> offset = m_stream->write(data, bytes, StreamBuffer::textureBufferAlignment());
+
+  if (!offset) {
+    return false;
+  }
+
+  m_stream->attachTexture(textureBuffer.texture, textureBuffer.format, *offset, bytes);
+  textureBuffer.streamed = true;
+  return true;
+}
+
+void ClusteredLighting::create(TextureBuffer &textureBuffer, const GLenum format) {
+  textureBuffer.format = format;
+  glGenBuffers(1, &textureBuffer.buffer);
+  upload(textureBuffer, nullptr, 0);
+
+  glGenTextures(1, &textureBuffer.texture);
+  glBindTexture(GL_TEXTURE_BUFFER, textureBuffer.texture);
+  glTexBuffer(GL_TEXTURE_BUFFER, format, textureBuffer.buffer);
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void ClusteredLighting::upload(TextureBuffer &textureBuffer, const void *data, const std::size_t bytes) {
+  // Orphaned every frame, the driver hands out fresh storage instead of waiting for draws still reading the old one.
+  // Never empty, some drivers reject texture buffers without storage.
+  glBindBuffer(GL_TEXTURE_BUFFER, textureBuffer.buffer);
+  const std::size_t storageBytes = std::max<std::size_t>(bytes, sizeof(glm::vec4));
+  glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(storageBytes), nullptr, GL_STREAM_DRAW);
+  textureBuffer.memory.set(storageBytes);
+
+  if (bytes > 0) {
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, static_cast<GLsizeiptr>(bytes), data);
+  }
+
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+  if (textureBuffer.streamed) {
+    glBindTexture(GL_TEXTURE_BUFFER, textureBuffer.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, textureBuffer.format, textureBuffer.buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    textureBuffer.streamed = false;
+  }
+}
+
+void ClusteredLighting::destroy(TextureBuffer &textureBuffer) {
+  if (textureBuffer.texture) {
+    glDeleteTextures(1, &textureBuffer.texture);
+  }
+
+  if (textureBuffer.buffer) {
+    glDeleteBuffers(1, &textureBuffer.buffer);
+  }
+
+  textureBuffer = {};
+}
+
+} // namespace App
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "FrameArena.h"
+#include "Light.h"
+#include "Material.h"
+#include "MemoryAccounting.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+namespace App {
+
+/// Texture units of the cluster buffers, right after the material textures.
+enum ClusterTextureIndex {
+  CLUSTER_LIGHTS_TEXTURE_INDEX = NORMAL_TEXTURE_INDEX + 1,
+  CLUSTER_RANGES_TEXTURE_INDEX,
+  CLUSTER_INDICES_TEXTURE_INDEX,
+};
+
+struct LightClusterStats {
+  std::size_t lights = 0;
+  std::size_t culledLights = 0;         // Outside the view frustum
+  std::size_t assignments = 0;          // Light and cluster pairs
+  std::size_t droppedAssignments = 0;   // Over the per cluster or total limit
+  std::size_t busiestCluster = 0;       // Lights in the cluster with the most
+};
+
+/// Lights sorted into the clusters of one view. Clusters are the view frustum cut into a grid of screen tiles and
+/// exponentially thicker depth slices, numbered x first, then y, then depth. All arrays live in a frame arena.
+struct LightClusters {
+  /// Four texels per light: position and range, radiance and type, direction and inner cutoff, the three
+  /// attenuation factors and outer cutoff. Matches clusteredLight in clustered_lights.glsl.
+  std::span<const glm::vec4> lightTexels;
+  /// Offset into `lightIndices` and light count, per cluster.
+  std::span<const glm::uvec2> clusterRanges;
+  std::span<const uint32_t> lightIndices;
+  glm::vec2 viewportSize{1.0f};
+  LightClusterStats stats;
+};
+
+/// Assigns every light to the clusters its range touches. Reads no GL state, so it runs with the rest of frame
+/// preparation. The per light bounds are computed four lights at a time over structure-of-arrays copies, only the
+/// scatter into the clusters is done light by light.
+[[nodiscard]] LightClusters assignLightClusters(std::span<const Light> lights, const glm::mat4 &viewMatrix,
+                                                const glm::mat4 &projectionMatrix, glm::vec2 viewportSize,
+                                                FrameArena &arena);
+
+/// Texture buffers the lit shaders read the clusters from, GL 3.3 has no storage buffers. Uploaded once per frame
+/// and bound to every shader including clustered_lights.glsl.
+///
+/// Where the driver can point buffer textures at a range (GL_ARB_texture_buffer_range), the clusters are written into
+/// a StreamBuffer and read in place. Otherwise, or when a frame doesn't fit, each texture orphans a buffer of its own.
+class ClusteredLighting {
+public:
+  ClusteredLighting() = default;
+  ~ClusteredLighting();
+
+  ClusteredLighting(const ClusteredLighting &) = delete;
+  ClusteredLighting &operator=(const ClusteredLighting &) = delete;
+
+  /// Creates the buffers, needs a current OpenGL context.
+  void setup();
+
+  void upload(const LightClusters &clusters);
+
+  /// Binds the buffers and sets the cluster uniforms of a shader that is in use.
+  void bind(Shader &shader) const;
+
+private:
+  struct TextureBuffer {
+    GLuint buffer = 0;
+    GLuint texture = 0;
+    GLenum format = GL_NONE;
+    bool streamed = false; // The texture reads a range of the stream buffer rather than `buffer`
+    TrackedMemory memory{MemoryTag::Lighting, MemoryPool::Gpu};
+  };
+
+  TextureBuffer m_lights;
+  TextureBuffer m_ranges;
+  TextureBuffer m_indices;
+  std::unique_ptr<StreamBuffer> m_stream;
+  glm::vec2 m_viewportSize{1.0f};
+
+  /// Writes the data into this frame's region of the stream buffer. False once the region is full.
+  bool stream(TextureBuffer &textureBuffer, const void *data, std::size_t bytes);
+
+  static void create(TextureBuffer &textureBuffer, GLenum format);
+  static void upload(TextureBuffer &textureBuffer, const void *data, std::size_t bytes);
+  static void destroy(TextureBuffer &textureBuffer);
+};
+
+} // namespace App
@@ -6,6 +6,12 @@ constexpr auto TITLE = "Minecraft";
 constexpr int WIDTH = 1024;
 constexpr int HEIGHT = 1024;
 inline float CLEAR_COLOR[] = {0.0f, 0.0f, 0.0f};
+/// Frame rate of PresentMode::Limited. Its sleep stops this long before the deadline and spins the rest, sleeps can
+/// overshoot by a whole scheduler tick.
+constexpr int FRAME_RATE_LIMIT = 120;
+constexpr float LIMITER_SPIN_MS = 1.5f;
+/// Frames the GPU may have queued, counting the one about to start, before PresentMode::LowLatency samples input.
+constexpr std::size_t LOW_LATENCY_FRAMES_IN_FLIGHT = 1;
 } // namespace Window
 
 namespace Core {
@@ -15,9 +21,110 @@ constexpr auto GLSL_VERSION = "#version 330";
 constexpr auto DEBUG_MODE = false;
 } // namespace Core
 
+namespace World {
+constexpr int CHUNK_SIZE = 16;
+/// Horizontal streaming radius, in chunks.
+constexpr int VIEW_DISTANCE = 32;
+/// Vertical extent of the world, in chunks (inclusive).
+constexpr int MIN_CHUNK_Y = -2;
+constexpr int MAX_CHUNK_Y = 1;
+constexpr int SEA_LEVEL = -4;
+constexpr unsigned int SEED = 1337;
+/// Chunk distances (in chunks) at which the mesh switches to the next coarser LOD (2x, 4x, 8x).
+constexpr float LOD_DISTANCES[] = {8.0f, 16.0f, 24.0f};
+/// Distance (in chunks) the camera has to move past a LOD boundary before a chunk switches back.
+constexpr float LOD_HYSTERESIS = 0.5f;
+constexpr int GENERATE_BUDGET_PER_FRAME = 8;
+constexpr int MESH_BUDGET_PER_FRAME = 16;
+/// Reach of the block picking ray, in blocks.
+constexpr float PICK_DISTANCE = 8.0f;
+/// Nearest chunks, at most this many and this far (in chunks), rasterized as occluders every frame.
+constexpr int MAX_OCCLUDERS = 64;
+constexpr float OCCLUDER_DISTANCE = 4.0f;
+/// Chunk meshes bake Minecraft style ambient occlusion into their vertex colors: each face corner is darkened by the
+/// opaque blocks among the three touching it from in front of the face, indexed by their count (both sides count as
+/// three). Contact shadows without a screen-space pass.
+constexpr bool BAKED_AMBIENT_OCCLUSION = true;
+constexpr float AMBIENT_OCCLUSION_BRIGHTNESS[4] = {1.0f, 0.8f, 0.62f, 0.45f};
+} // namespace World
+
+namespace Simulation {
+/// Fixed rate of the game simulation, Minecraft's 20 ticks per second.
+constexpr int TICKS_PER_SECOND = 20;
+/// Ticks one update may run to catch up, the rest are dropped rather than stalling the frame further.
+constexpr int MAX_TICKS_PER_UPDATE = 10;
+constexpr bool RUN_ON_THREAD = false;
+} // namespace Simulation
+
+namespace Profiler {
+/// Frames kept for the flame graph and trace exports.
+constexpr int FRAME_HISTORY = 240;
+/// Frames a GPU timer query gets to complete before its result is read back (or dropped).
+constexpr int GPU_FRAMES_IN_FLIGHT = 4;
+constexpr int MAX_GPU_ZONES_PER_FRAME = 32;
+constexpr auto TRACE_FILE = "trace.json";
+} // namespace Profiler
+
 namespace Renderer {
+constexpr float NEAR_PLANE = 0.1f;
+constexpr float FAR_PLANE = (World::VIEW_DISTANCE + 1) * World::CHUNK_SIZE;
 constexpr auto DEFAULT_VERTEX_SHADER = "skeleton.vert";
 constexpr auto DEFAULT_FRAGMENT_SHADER = "skeleton.frag";
 constexpr auto COLOR_PLACEHOLDER = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+/// Initial size of each frame packet's arena, it grows to the largest frame seen so far.
+constexpr std::size_t FRAME_ARENA_BYTES = 256 * 1024;
+/// Packets in flight: one being submitted, one being prepared and one spare for the stats of the last frame.
+constexpr std::size_t FRAME_PACKETS = 3;
+/// Regions of a StreamBuffer, one per frame the GPU may still be reading when the CPU starts the next one.
+constexpr std::size_t STREAM_BUFFER_FRAMES = 3;
+/// Prepare the next frame on its own thread while the current one is submitted.
+constexpr bool PIPELINED_FRAMES = true;
+/// Clusters the view frustum is cut into for lighting: tiles across the screen, exponential slices along depth.
+constexpr int LIGHT_CLUSTERS_X = 16;
+constexpr int LIGHT_CLUSTERS_Y = 9;
+constexpr int LIGHT_CLUSTERS_Z = 24;
+/// Most lights a fragment loops over, later lights touching a full cluster are left out of it.
+constexpr int MAX_LIGHTS_PER_CLUSTER = 128;
+/// Frames whose busiest cluster has at most this many lights use shader variants with a loop this short.
+constexpr int FEW_LIGHTS_PER_CLUSTER = 16;
+/// Texture buffers are only guaranteed 65536 texels, each light takes four and each assignment one.
+constexpr int MAX_CLUSTERED_LIGHTS = 16384;
+constexpr int MAX_CLUSTER_LIGHT_INDICES = 65536;
+/// Entities go through a G-buffer and are lit once per pixel instead of once per fragment drawn.
+constexpr bool DEFERRED_SHADING = false;
+/// Forward entities lay down their depth first, so the shading pass only runs for the fragments that end up visible.
+constexpr bool DEPTH_PREPASS = false;
+/// Towards the sun, the terrain's main light.
+constexpr auto SUN_DIRECTION = glm::vec3(0.4f, 1.0f, 0.3f);
+/// Sun shadows: the view up to SHADOW_DISTANCE is split into cascades, each with its own depth map layer.
+constexpr bool SUN_SHADOWS = true;
+constexpr int SHADOW_CASCADES = 4;
+constexpr int SHADOW_MAP_SIZE = 2048;
+constexpr float SHADOW_DISTANCE = 16.0f * World::CHUNK_SIZE;
+/// Blend between logarithmic (1) and even (0) cascade splits.
+constexpr float SHADOW_SPLIT_LAMBDA = 0.75f;
+/// The farthest cascades are kept across frames and only redrawn when the sun moves, a chunk inside them changes or
+/// the camera leaves them. They cover this much more than the view needs, so the camera can roam a while.
+constexpr int CACHED_SHADOW_CASCADES = 2;
+constexpr float SHADOW_CACHE_MARGIN = 0.25f;
+/// Casters this far towards the sun from a cascade still shadow it.
+constexpr float SHADOW_CASTER_REACH = 128.0f;
+/// The world is drawn at a fraction of the display resolution, adjusted every frame so its GPU time stays under the
+/// target, then upscaled and sharpened. ImGui is drawn at the display resolution on top.
+constexpr bool DYNAMIC_RESOLUTION = false;
+constexpr float DYNAMIC_RESOLUTION_TARGET_MS = 14.0f;
+constexpr float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;
+/// The render size only changes in steps this large, each change reallocates the G-buffer and similar targets.
+constexpr float DYNAMIC_RESOLUTION_STEP = 0.05f;
+/// Fraction of the way to the scale the last GPU time asks for, taken every frame.
+constexpr float DYNAMIC_RESOLUTION_RESPONSE = 0.1f;
+constexpr float UPSCALE_SHARPNESS = 0.5f;
 } // namespace Renderer
+
+namespace Memory {
+/// What the tracked subsystems may use in total, the memory panel and dump measure against these.
+constexpr std::size_t CPU_BUDGET_BYTES = std::size_t{1} << 30;
+constexpr std::size_t GPU_BUDGET_BYTES = std::size_t{1} << 30;
+constexpr auto DUMP_FILE = "memory.json";
+} // namespace Memory
 } // namespace App::Config
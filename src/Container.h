@@ -10,6 +10,21 @@
 #include "Texture.h"
 #include "Axis.h"
 #include "Cache.h"
+#include "World.h"
+#include "OcclusionCuller.h"
+#include "Profiler.h"
+#include "Simulation.h"
+#include "JobSystem.h"
+#include "EcsSystems.h"
+#include "FramePacer.h"
+#include "FramePipeline.h"
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
+#include "DepthPrepass.h"
+#include "DynamicResolution.h"
+#include "OverdrawHeatmap.h"
+#include "ShadowMaps.h"
+#include "TransformSystem.h"
 
 namespace App {
 class Container {
@@ -22,6 +37,20 @@ public:
   std::shared_ptr<FloorGrid> m_floorGrid = nullptr;
   std::shared_ptr<Axis> m_axis = nullptr;
   std::shared_ptr<Cache<Texture>> m_textureCache = nullptr;
+  std::shared_ptr<World> m_world = nullptr;
+  std::shared_ptr<OcclusionCuller> m_occlusionCuller = nullptr;
+  std::shared_ptr<Profiler> m_profiler = nullptr;
+  std::shared_ptr<Simulation> m_simulation = nullptr;
+  std::shared_ptr<JobSystem> m_jobSystem = nullptr;
+  std::shared_ptr<Ecs::Registry> m_entities = nullptr;
+  std::shared_ptr<FramePipeline> m_framePipeline = nullptr;
+  std::shared_ptr<FramePacer> m_framePacer = nullptr;
+  std::shared_ptr<ClusteredLighting> m_clusteredLighting = nullptr;
+  std::shared_ptr<DeferredRenderer> m_deferredRenderer = nullptr;
+  std::shared_ptr<ShadowMaps> m_shadowMaps = nullptr;
+  std::shared_ptr<DepthPrepass> m_depthPrepass = nullptr;
+  std::shared_ptr<OverdrawHeatmap> m_overdrawHeatmap = nullptr;
+  std::shared_ptr<DynamicResolution> m_dynamicResolution = nullptr;
 
   Container(const Container &) = delete;
   Container &operator=(const Container &) = delete;
@@ -43,9 +72,45 @@ public:
     m_floorGrid = std::make_shared<FloorGrid>();
     m_axis = std::make_shared<Axis>();
     m_textureCache = std::make_shared<Cache<Texture>>();
+    m_world = std::make_shared<World>();
+    m_occlusionCuller = std::make_shared<OcclusionCuller>();
+    m_profiler = std::make_shared<Profiler>();
+    m_simulation = std::make_shared<Simulation>();
+    m_jobSystem = std::make_shared<JobSystem>();
+    m_entities = std::make_shared<Ecs::Registry>();
+    m_framePipeline = std::make_shared<FramePipeline>();
+    m_framePacer = std::make_shared<FramePacer>();
+    m_clusteredLighting = std::make_shared<ClusteredLighting>();
+    m_deferredRenderer = std::make_shared<DeferredRenderer>();
+    m_shadowMaps = std::make_shared<ShadowMaps>();
+    m_depthPrepass = std::make_shared<DepthPrepass>();
+    m_overdrawHeatmap = std::make_shared<OverdrawHeatmap>();
+    m_dynamicResolution = std::make_shared<DynamicResolution>();
   }
 
   void dispose() {
+    // Stops the simulation and worker threads before the services they could reach go away
+    m_framePipeline = nullptr;
+    m_simulation = nullptr;
+    m_jobSystem = nullptr;
+
+    // Own GL objects, released while the context still exists
+    m_profiler = nullptr;
+    m_framePacer = nullptr;
+    m_clusteredLighting = nullptr;
+    m_deferredRenderer = nullptr;
+    m_shadowMaps = nullptr;
+    m_depthPrepass = nullptr;
+    m_overdrawHeatmap = nullptr;
+    m_dynamicResolution = nullptr;
+
+    // Chunk meshes and the pool they live in, then the resources everything above drew with
+    m_world = nullptr;
+    m_axis = nullptr;
+    m_floorGrid = nullptr;
+    m_textureCache = nullptr;
+    m_shaderCache = nullptr;
+
     if (m_window) {
       m_window->dispose();
       m_window = nullptr;
@@ -60,6 +125,7 @@ private:
 } // namespace App
 
 #define g_container (Container::getInstance())
+#define g_transforms (TransformSystem::getInstance())
 
 inline const App::Container &container = App::Container::getInstance();
 
@@ -72,3 +138,17 @@ inline const App::Container &container = App::Container::getInstance();
 #define g_floorGrid (*container.m_floorGrid)
 #define g_axis (*container.m_axis)
 #define g_textureCache (*container.m_textureCache)
+#define g_world (*container.m_world)
+#define g_occlusionCuller (*container.m_occlusionCuller)
+#define g_profiler (*container.m_profiler)
+#define g_simulation (*container.m_simulation)
+#define g_jobSystem (*container.m_jobSystem)
+#define g_entities (*container.m_entities)
+#define g_framePipeline (*container.m_framePipeline)
+#define g_framePacer (*container.m_framePacer)
+#define g_clusteredLighting (*container.m_clusteredLighting)
+#define g_deferredRenderer (*container.m_deferredRenderer)
+#define g_shadowMaps (*container.m_shadowMaps)
+#define g_depthPrepass (*container.m_depthPrepass)
+#define g_overdrawHeatmap (*container.m_overdrawHeatmap)
+#define g_dynamicResolution (*container.m_dynamicResolution)
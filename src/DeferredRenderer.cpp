@@ -0,0 +1,177 @@
+#include "DeferredRenderer.h"
+
+#include <spdlog/spdlog.h>
+
+#include "Material.h"
+#include "Mesh.h"
+#include "Profiler.h"
+
+namespace App {
+
+DeferredRenderer::~DeferredRenderer() {
+  releaseGBuffer();
+}
+
+void DeferredRenderer::setup() {
+  m_geometryShader = std::make_unique<Shader>(Config::Renderer::DEFAULT_VERTEX_SHADER, "gbuffer.frag");
+  m_lightingShader = std::make_unique<Shader>("fullscreen_triangle.vert", "deferred_lighting.frag");
+  m_fullScreenTriangle = std::make_unique<DummyVAO>();
+
+  // Samplers never change, materials only bind their textures to these units
+  m_geometryShader->use();
+  m_geometryShader->set(DIFFUSE_TEXTURE_UNIFORM_NAME, static_cast<int>(DIFFUSE_TEXTURE_INDEX));
+  m_geometryShader->set(SPECULAR_TEXTURE_UNIFORM_NAME, static_cast<int>(SPECULAR_TEXTURE_INDEX));
+  m_geometryShader->set(NORMAL_TEXTURE_UNIFORM_NAME, static_cast<int>(NORMAL_TEXTURE_INDEX));
+
+  m_lightingShader->use();
+  m_lightingShader->set("uAlbedoMetallic", static_cast<int>(GBUFFER_ALBEDO_TEXTURE_INDEX));
+  m_lightingShader->set("uNormalRoughness", static_cast<int>(GBUFFER_NORMAL_TEXTURE_INDEX));
+  m_lightingShader->set("uDepth", static_cast<int>(GBUFFER_DEPTH_TEXTURE_INDEX));
+}
+
+void DeferredRenderer::render(const std::span<const Ecs::MeshDraw> draws, const RenderContext &ctx,
+                              const glm::ivec2 size) {
+  PROFILE_SCOPE("DeferredRenderer::render");
+
+  if (size.x <= 0 || size.y <= 0) {
+    return;
+  }
+
+  GLint target = 0;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+  const GLboolean blend = glIsEnabled(GL_BLEND);
+  const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+
+  if (size != m_size) {
+    resize(size);
+  }
+
+  // Geometry pass. Blending is off, it would scale the albedo by the metallic stored next to it in alpha
+  {
+    PROFILE_GPU_SCOPE("G-buffer");
+    constexpr GLfloat clearColor[] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glClearBufferfv(GL_COLOR, 0, clearColor);
+    glClearBufferfv(GL_COLOR, 1, clearColor);
+    glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+
+    m_geometryShader->use();
+
+    // Only textures matter to the surface, so the material's other uniforms are skipped
+    const Material *boundMaterial = nullptr;
+
+    for (const Ecs::MeshDraw &draw : draws) {
+      if (draw.material != boundMaterial) {
+        draw.material->bindTextures();
+        boundMaterial = draw.material;
+      }
+
+      m_geometryShader->set("uModel", draw.world);
+      m_geometryShader->set("uModelViewProjection", draw.modelViewProjection);
+      m_geometryShader->set("uNormalMatrix", draw.normalMatrix);
+      draw.mesh->render(draw.renderMode);
+    }
+  }
+
+  // Lighting pass, one triangle over the whole target. Pixels without geometry are discarded
+  {
+    PROFILE_GPU_SCOPE("Deferred lighting");
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(target));
+    glDisable(GL_DEPTH_TEST);
+
+    glActiveTexture(GL_TEXTURE0 + GBUFFER_ALBEDO_TEXTURE_INDEX);
+    glBindTexture(GL_TEXTURE_2D, m_albedoMetallic);
+    glActiveTexture(GL_TEXTURE0 + GBUFFER_NORMAL_TEXTURE_INDEX);
+    glBindTexture(GL_TEXTURE_2D, m_normalRoughness);
+    glActiveTexture(GL_TEXTURE0 + GBUFFER_DEPTH_TEXTURE_INDEX);
+    glBindTexture(GL_TEXTURE_2D, m_depth);
+    glActiveTexture(GL_TEXTURE0);
+
+    m_lightingShader->use();
+    m_lightingShader->set("uView", ctx.viewMatrix);
+    m_lightingShader->set("uInverseViewProjection", glm::inverse(ctx.projectionMatrix * ctx.viewMatrix));
+    m_lightingShader->set("uViewPosition", ctx.cameraPosition);
+
+    if (ctx.lighting) {
+      ctx.lighting->bind(*m_lightingShader);
+    }
+
+    m_fullScreenTriangle->render();
+  }
+
+  // Forward passes drawn after this one are hidden behind the lit meshes as usual
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+  glBlitFramebuffer(0, 0, size.x, size.y, 0, 0, size.x, size.y, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(target));
+
+  // Both are off after the lighting pass, the passes after this one find them as they left them
+  if (blend) {
+    glEnable(GL_BLEND);
+  }
+
+  if (depthTest) {
+    glEnable(GL_DEPTH_TEST);
+  }
+}
+
+void DeferredRenderer::resize(const glm::ivec2 size) {
+  releaseGBuffer();
+
+  m_albedoMetallic = createTarget(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, size);
+  m_normalRoughness = createTarget(GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, size);
+  // Same format as the window's depth buffer, blitting depth between them needs that
+  m_depth = createTarget(GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, size);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_albedoMetallic, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, m_normalRoughness, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_depth, 0);
+
+  constexpr GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+  glDrawBuffers(2, attachments);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    SPDLOG_ERROR("G-buffer framebuffer is incomplete");
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  m_size = size;
+  // RGBA8, RGB10_A2 and DEPTH24_STENCIL8, four bytes each
+  m_gpuMemory.set(MemoryAccounting::textureBytes(size.x, size.y, 12));
+}
+
+void DeferredRenderer::releaseGBuffer() {
+  if (m_framebuffer) {
+    glDeleteFramebuffers(1, &m_framebuffer);
+  }
+
+  for (const GLuint texture : {m_albedoMetallic, m_normalRoughness, m_depth}) {
+    if (texture) {
+      glDeleteTextures(1, &texture);
+    }
+  }
+
+  m_framebuffer = m_albedoMetallic = m_normalRoughness = m_depth = 0;
+  m_size = glm::ivec2(0);
+  m_gpuMemory.set(0);
+}
+
+GLuint DeferredRenderer::createTarget(const GLenum internalFormat, const GLenum format, const GLenum type,
+                                      const glm::ivec2 size) {
+  GLuint texture = 0;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), size.x, size.y, 0, format, type, nullptr);
+
+  // Read with texelFetch only, but a texture without mipmaps is incomplete under the default filter
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  return texture;
+}
+
+} // namespace App
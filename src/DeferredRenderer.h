@@ -0,0 +1,75 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "ClusteredLighting.h"
+#include "Config.h"
+#include "DummyVAO.h"
+#include "EcsSystems.h"
+#include "MemoryAccounting.h"
+#include "Renderable.h"
+#include "Shader.h"
+
+namespace App {
+
+/// Texture units of the G-buffer in the lighting pass, right after the cluster buffers it is lit with.
+enum GBufferTextureIndex {
+  GBUFFER_ALBEDO_TEXTURE_INDEX = CLUSTER_INDICES_TEXTURE_INDEX + 1,
+  GBUFFER_NORMAL_TEXTURE_INDEX,
+  GBUFFER_DEPTH_TEXTURE_INDEX,
+};
+
+/// Deferred path for entity meshes, the alternative to drawing them forward with the PBR shader. A geometry pass
+/// writes their surfaces into a compact G-buffer (gbuffer.glsl), then a single full screen pass lights every covered
+/// pixel once with the lights of its cluster. Fragments hidden by later ones never pay for lighting, which is what
+/// forward shading loses with many lights and heavy overdraw. Costs the G-buffer bandwidth, and these meshes can't
+/// be blended.
+class DeferredRenderer {
+public:
+  DeferredRenderer() = default;
+  ~DeferredRenderer();
+
+  DeferredRenderer(const DeferredRenderer &) = delete;
+  DeferredRenderer &operator=(const DeferredRenderer &) = delete;
+
+  /// Compiles the passes' shaders, needs a current OpenGL context. Owns them rather than going through the shader
+  /// cache, so it also runs without the container.
+  void setup();
+
+  /// Draws the meshes into the G-buffer, lights them into the framebuffer bound when called and copies their depth
+  /// there too, so forward passes after this one are depth tested against them. The G-buffer follows `size`. Blending
+  /// and depth testing are left as they were found.
+  void render(std::span<const Ecs::MeshDraw> draws, const RenderContext &ctx, glm::ivec2 size);
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+  }
+
+private:
+  bool m_enabled = Config::Renderer::DEFERRED_SHADING;
+
+  GLuint m_framebuffer = 0;
+  GLuint m_albedoMetallic = 0;
+  GLuint m_normalRoughness = 0;
+  GLuint m_depth = 0;
+  glm::ivec2 m_size{0};
+  TrackedMemory m_gpuMemory{MemoryTag::RenderTargets, MemoryPool::Gpu};
+
+  std::unique_ptr<Shader> m_geometryShader;
+  std::unique_ptr<Shader> m_lightingShader;
+  std::unique_ptr<DummyVAO> m_fullScreenTriangle;
+
+  void resize(glm::ivec2 size);
+  void releaseGBuffer();
+  static GLuint createTarget(GLenum internalFormat, GLenum format, GLenum type, glm::ivec2 size);
+};
+
+} // namespace App
@@ -0,0 +1,39 @@
+#include "DepthPrepass.h"
+
+#include <glad/glad.h>
+
+#include "Mesh.h"
+#include "Profiler.h"
+
+namespace App {
+
+void DepthPrepass::setup() {
+  m_shader = std::make_unique<Shader>("depth_prepass.vert", "depth_only.frag");
+}
+
+void DepthPrepass::render(const std::span<const Ecs::MeshDraw> draws, const RenderContext &ctx) const {
+  PROFILE_SCOPE("DepthPrepass::render");
+
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+  m_shader->use();
+
+  for (const Ecs::MeshDraw &draw : draws) {
+    m_shader->set("uModelViewProjection", draw.modelViewProjection);
+    draw.mesh->renderPositions(draw.renderMode);
+  }
+
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void DepthPrepass::beginEqualDepth() {
+  glDepthFunc(GL_EQUAL);
+  glDepthMask(GL_FALSE);
+}
+
+void DepthPrepass::endEqualDepth() {
+  glDepthFunc(GL_LESS);
+  glDepthMask(GL_TRUE);
+}
+
+} // namespace App
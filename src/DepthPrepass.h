@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Config.h"
+#include "EcsSystems.h"
+#include "Renderable.h"
+#include "Shader.h"
+
+namespace App {
+
+/// Optional depth only pass in front of the forward entity pass. It lays down the meshes' depth from their position
+/// streams with a program that does nothing per fragment, then the shading pass tests for equal depth without writing
+/// it, so every covered pixel runs the PBR shader once whatever order the meshes come in. Pays off when shading
+/// dominates and meshes overlap, otherwise it only adds a second vertex pass, hence the toggle.
+///
+/// Terrain stays out of it: its water is blended, and a pre-pass would hide what lies under the surface.
+class DepthPrepass {
+public:
+  DepthPrepass() = default;
+
+  DepthPrepass(const DepthPrepass &) = delete;
+  DepthPrepass &operator=(const DepthPrepass &) = delete;
+
+  /// Compiles the depth only program, needs a current OpenGL context.
+  void setup();
+
+  /// Writes the depth of the meshes into the bound framebuffer, leaving its color alone.
+  void render(std::span<const Ecs::MeshDraw> draws, const RenderContext &ctx) const;
+
+  /// Depth state of the pass after the pre-pass: only the fragments that won it pass, and none writes depth again.
+  static void beginEqualDepth();
+  static void endEqualDepth();
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+  }
+
+private:
+  bool m_enabled = Config::Renderer::DEPTH_PREPASS;
+  std::unique_ptr<Shader> m_shader;
+};
+
+} // namespace App
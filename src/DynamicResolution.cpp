@@ -0,0 +1,191 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <spdlog/spdlog.h>
+
+#include "Profiler.h"
+
+namespace App {
+
+using namespace Config::Renderer;
+
+DynamicResolution::~DynamicResolution() {
+  releaseTarget();
+
+  for (const TimerSlot &slot : m_timers) {
+    if (slot.start) {
+      glDeleteQueries(1, &slot.start);
+      glDeleteQueries(1, &slot.end);
+    }
+  }
+}
+
+void DynamicResolution::setup() {
+  for (TimerSlot &slot : m_timers) {
+    glGenQueries(1, &slot.start);
+    glGenQueries(1, &slot.end);
+  }
+
+  m_upscaleShader = std::make_unique<Shader>("fullscreen_triangle.vert", "upscale_sharpen.frag");
+  m_fullScreenTriangle = std::make_unique<DummyVAO>();
+
+  m_upscaleShader->use();
+  m_upscaleShader->set("uScene", 0);
+  m_upscaleShader->set("uSharpness", UPSCALE_SHARPNESS);
+}
+
+glm::ivec2 DynamicResolution::renderSize(const glm::ivec2 displaySize) const {
+  if (!m_enabled) {
+    return displaySize;
+  }
+
+  const float scale = std::round(m_scale / DYNAMIC_RESOLUTION_STEP) * DYNAMIC_RESOLUTION_STEP;
+  const glm::vec2 size = glm::round(glm::vec2(displaySize) * std::min(scale, 1.0f));
+  return glm::max(glm::ivec2(size), glm::ivec2(1));
+}
+
+void DynamicResolution::begin(const glm::ivec2 frameSize, const glm::ivec2 displaySize) {
+  resolveTimers();
+
+  m_frameSize = frameSize;
+  m_displaySize = displaySize;
+  m_offscreen = frameSize != displaySize && displaySize.x > 0 && displaySize.y > 0;
+
+  if (m_offscreen) {
+    if (displaySize != m_targetSize) {
+      resize(displaySize);
+    }
+
+    const auto [r, g, b] = Config::Window::CLEAR_COLOR;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, frameSize.x, frameSize.y);
+    glClearColor(r, g, b, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  }
+
+  glQueryCounter(m_timers[m_nextTimer].start, GL_TIMESTAMP);
+}
+
+void DynamicResolution::end() {
+  if (m_offscreen) {
+    PROFILE_GPU_SCOPE("Upscale");
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, m_displaySize.x, m_displaySize.y);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, m_color);
+
+    m_upscaleShader->use();
+    m_upscaleShader->set("uRenderSize", glm::vec2(m_frameSize));
+    m_upscaleShader->set("uDisplaySize", glm::vec2(m_displaySize));
+    m_fullScreenTriangle->render();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+  }
+
+  TimerSlot &slot = m_timers[m_nextTimer];
+  glQueryCounter(slot.end, GL_TIMESTAMP);
+  slot.scale = m_displaySize.x > 0 ? static_cast<float>(m_frameSize.x) / static_cast<float>(m_displaySize.x) : 1.0f;
+  slot.pending = true;
+  m_nextTimer = (m_nextTimer + 1) % m_timers.size();
+}
+
+void DynamicResolution::resolveTimers() {
+  // Oldest first, stopping at the first the GPU hasn't reached: the later ones can't be done either
+  for (std::size_t i = 0; i < m_timers.size(); i++) {
+    TimerSlot &slot = m_timers[(m_nextTimer + i) % m_timers.size()];
+
+    if (!slot.pending) {
+      continue;
+    }
+
+    GLint available = 0;
+    glGetQueryObjectiv(slot.end, GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (!available) {
+      break;
+    }
+
+    GLuint64 startNs = 0;
+    GLuint64 endNs = 0;
+    glGetQueryObjectui64v(slot.start, GL_QUERY_RESULT, &startNs);
+    glGetQueryObjectui64v(slot.end, GL_QUERY_RESULT, &endNs);
+    slot.pending = false;
+
+    m_gpuMs = static_cast<float>(endNs - startNs) / 1e6f;
+    updateScale(m_gpuMs, slot.scale);
+  }
+
+  // All slots in flight, the next frame reuses the oldest and its measurement is lost
+  m_timers[m_nextTimer].pending = false;
+}
+
+void DynamicResolution::updateScale(const float gpuMs, const float frameScale) {
+  if (!m_enabled || gpuMs <= 0.0f) {
+    return;
+  }
+
+  // The cost is assumed to grow with the pixel count, that is with the square of the scale
+  const float desired = frameScale * std::sqrt(m_targetMs / gpuMs);
+  m_scale += (desired - m_scale) * DYNAMIC_RESOLUTION_RESPONSE;
+  m_scale = std::clamp(m_scale, DYNAMIC_RESOLUTION_MIN_SCALE, 1.0f);
+}
+
+void DynamicResolution::resize(const glm::ivec2 size) {
+  releaseTarget();
+
+  // Filtered when upscaling, clamped so the edges don't pull in texels outside the frame
+  glGenTextures(1, &m_color);
+  glBindTexture(GL_TEXTURE_2D, m_color);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  // Same format as the window's depth buffer, the deferred path blits its depth into whichever it draws to
+  glGenRenderbuffers(1, &m_depth);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.x, size.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_color, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    SPDLOG_ERROR("Dynamic resolution framebuffer is incomplete");
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  m_targetSize = size;
+  m_gpuMemory.set(MemoryAccounting::textureBytes(size.x, size.y, 8)); // RGBA8 and DEPTH24_STENCIL8
+}
+
+void DynamicResolution::releaseTarget() {
+  if (m_framebuffer) {
+    glDeleteFramebuffers(1, &m_framebuffer);
+  }
+
+  if (m_color) {
+    glDeleteTextures(1, &m_color);
+  }
+
+  if (m_depth) {
+    glDeleteRenderbuffers(1, &m_depth);
+  }
+
+  m_framebuffer = m_color = m_depth = 0;
+  m_targetSize = glm::ivec2(0);
+  m_gpuMemory.set(0);
+}
+
+} // namespace App
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Config.h"
+#include "DummyVAO.h"
+#include "MemoryAccounting.h"
+#include "Shader.h"
+
+namespace App {
+
+/// Draws the world below the display resolution when the GPU can't keep up, and upscales it with a sharpening filter.
+///
+/// Timestamp queries around each frame's world measure its GPU time, read back a few frames later without waiting.
+/// The controller moves the scale towards the one that would bring that time to the target, assuming the cost follows
+/// the pixel count. The size is chosen when a frame is prepared (`renderSize`) and travels with its packet, so a
+/// frame is always submitted at the size it was planned for.
+class DynamicResolution {
+public:
+  DynamicResolution() = default;
+  ~DynamicResolution();
+
+  DynamicResolution(const DynamicResolution &) = delete;
+  DynamicResolution &operator=(const DynamicResolution &) = delete;
+
+  /// Creates the timer queries and the upscaling shader, needs a current OpenGL context.
+  void setup();
+
+  /// Size to draw the world at for the current scale, the display size while disabled.
+  [[nodiscard]] glm::ivec2 renderSize(glm::ivec2 displaySize) const;
+
+  /// Starts a frame's world drawn at `frameSize`. Below the display size it goes to an offscreen target, which is
+  /// bound and cleared, at full size it goes straight to the bound framebuffer.
+  void begin(glm::ivec2 frameSize, glm::ivec2 displaySize);
+
+  /// Ends the world, upscaling it into the default framebuffer when it went offscreen.
+  void end();
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  /// Disabling goes back to full resolution right away.
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+    m_scale = 1.0f;
+  }
+
+  [[nodiscard]] float getScale() const {
+    return m_scale;
+  }
+
+  /// GPU time of the last measured world, in milliseconds.
+  [[nodiscard]] float getGpuMs() const {
+    return m_gpuMs;
+  }
+
+  [[nodiscard]] float getTargetMs() const {
+    return m_targetMs;
+  }
+
+  void setTargetMs(const float targetMs) {
+    m_targetMs = targetMs;
+  }
+
+private:
+  struct TimerSlot {
+    GLuint start = 0;
+    GLuint end = 0;
+    float scale = 1.0f;   // Of the frame measured
+    bool pending = false; // Issued, the result is not read yet
+  };
+
+  bool m_enabled = Config::Renderer::DYNAMIC_RESOLUTION;
+  float m_targetMs = Config::Renderer::DYNAMIC_RESOLUTION_TARGET_MS;
+  float m_scale = 1.0f;
+  float m_gpuMs = 0.0f;
+
+  // Timestamps rather than elapsed time queries, those can't overlap and the profiler's GPU zones use them
+  std::array<TimerSlot, 4> m_timers{};
+  std::size_t m_nextTimer = 0;
+
+  GLuint m_framebuffer = 0;
+  GLuint m_color = 0;
+  GLuint m_depth = 0;
+  glm::ivec2 m_targetSize{0}; // Sized for the display, frames use its lower left corner
+  glm::ivec2 m_frameSize{0};
+  glm::ivec2 m_displaySize{0};
+  bool m_offscreen = false;
+  TrackedMemory m_gpuMemory{MemoryTag::RenderTargets, MemoryPool::Gpu};
+
+  std::unique_ptr<Shader> m_upscaleShader;
+  std::unique_ptr<DummyVAO> m_fullScreenTriangle;
+
+  void resolveTimers();
+  void updateScale(float gpuMs, float frameScale);
+  void resize(glm::ivec2 size);
+  void releaseTarget();
+};
+
+} // namespace App
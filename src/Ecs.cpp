@@ -0,0 +1,161 @@
+#include "Ecs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
+namespace App::Ecs {
+
+namespace {
+std::array<ComponentInfo, MAX_COMPONENTS> g_componentInfos{};
+std::atomic<ComponentId> g_componentCount{0};
+std::mutex g_componentMutex;
+} // namespace
+
+ComponentId registerComponent(const ComponentInfo &info) {
+  const std::lock_guard lock(g_componentMutex);
+  const ComponentId id = g_componentCount;
+  assert(id < MAX_COMPONENTS && "Raise Ecs::MAX_COMPONENTS");
+
+  g_componentInfos[id] = info;
+  g_componentCount = id + 1;
+  return id;
+}
+
+const ComponentInfo &componentInfo(const ComponentId id) {
+  return g_componentInfos[id];
+}
+
+Archetype::Archetype(const ComponentMask &mask) : m_mask(mask) {
+  std::size_t bytesPerEntity = sizeof(Entity);
+  std::size_t padding = 0;
+
+  for (ComponentId id = 0; id < MAX_COMPONENTS; id++) {
+    if (mask.test(id)) {
+      m_components.push_back(id);
+      bytesPerEntity += componentInfo(id).size;
+      padding += componentInfo(id).alignment;
+    }
+  }
+
+  // Entities that don't fit a regular chunk get chunks of their own size
+  m_capacity = std::max<std::size_t>((CHUNK_BYTES - std::min(padding, CHUNK_BYTES)) / bytesPerEntity, 1);
+
+  std::size_t offset = m_capacity * sizeof(Entity);
+
+  for (const ComponentId id : m_components) {
+    const ComponentInfo &info = componentInfo(id);
+    offset = (offset + info.alignment - 1) / info.alignment * info.alignment;
+    m_offsets[id] = offset;
+    offset += m_capacity * info.size;
+  }
+
+  m_chunkBytes = offset;
+}
+
+std::size_t Archetype::size() const {
+  return m_chunks.empty() ? 0 : (m_chunks.size() - 1) * m_capacity + m_chunks.back().count;
+}
+
+Archetype::Location Archetype::allocate(const Entity entity) {
+  if (m_chunks.empty() || m_chunks.back().count == m_capacity) {
+    void *data = ::operator new[](m_chunkBytes, std::align_val_t(CHUNK_ALIGNMENT));
+    m_chunks.push_back({.data = Chunk::Data(static_cast<std::byte *>(data)), .count = 0});
+  }
+
+  Chunk &chunk = m_chunks.back();
+  const Location location{static_cast<uint32_t>(m_chunks.size() - 1), chunk.count++};
+  entities(chunk)[location.row] = entity;
+  return location;
+}
+
+Entity Archetype::remove(const Location location) {
+  Chunk &last = m_chunks.back();
+  const Location lastLocation{static_cast<uint32_t>(m_chunks.size() - 1), last.count - 1};
+  Entity moved = NULL_ENTITY;
+
+  if (location.chunk != lastLocation.chunk || location.row != lastLocation.row) {
+    for (const ComponentId id : m_components) {
+      std::memcpy(component(id, location), component(id, lastLocation), componentInfo(id).size);
+    }
+
+    moved = entities(last)[lastLocation.row];
+    entities(m_chunks[location.chunk])[location.row] = moved;
+  }
+
+  if (--last.count == 0) {
+    m_chunks.pop_back();
+  }
+
+  return moved;
+}
+
+Archetype &Registry::archetypeFor(const ComponentMask &mask) {
+  std::unique_ptr<Archetype> &archetype = m_archetypes[mask];
+
+  if (!archetype) {
+    archetype = std::make_unique<Archetype>(mask);
+    m_archetypeList.push_back(archetype.get());
+
+    for (auto &[queryMask, matches] : m_queryMatches) {
+      if ((mask & queryMask) == queryMask) {
+        matches.push_back(archetype.get());
+      }
+    }
+  }
+
+  return *archetype;
+}
+
+Entity Registry::allocateEntity() {
+  if (m_freeIndices.empty()) {
+    m_records.emplace_back();
+    return {static_cast<uint32_t>(m_records.size() - 1), 0};
+  }
+
+  const uint32_t index = m_freeIndices.back();
+  m_freeIndices.pop_back();
+  return {index, m_records[index].generation};
+}
+
+bool Registry::isAlive(const Entity entity) const {
+  return entity.index < m_records.size() && m_records[entity.index].archetype &&
+         m_records[entity.index].generation == entity.generation;
+}
+
+void Registry::removeFromArchetype(const Record &record) {
+  if (const Entity moved = record.archetype->remove(record.location); moved != NULL_ENTITY) {
+    m_records[moved.index].location = record.location;
+  }
+}
+
+void Registry::destroy(const Entity entity) {
+  if (!isAlive(entity)) {
+    return;
+  }
+
+  Record &record = m_records[entity.index];
+  removeFromArchetype(record);
+
+  record.archetype = nullptr;
+  record.generation++; // Outstanding handles to this entity are dead from now on
+  m_freeIndices.push_back(entity.index);
+}
+
+void Registry::moveEntity(const Entity entity, Archetype &target) {
+  Record &record = m_records[entity.index];
+  Archetype &source = *record.archetype;
+  const Archetype::Location location = target.allocate(entity);
+
+  for (const ComponentId id : target.getComponents()) {
+    if (source.getMask().test(id)) {
+      std::memcpy(target.component(id, location), source.component(id, record.location), componentInfo(id).size);
+    }
+  }
+
+  removeFromArchetype(record);
+  record = {&target, location, record.generation};
+}
+
+} // namespace App::Ecs
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.h"
+
+/// Archetype based entity component system. Entities with the same set of components share an archetype, which
+/// stores them in fixed size chunks with one contiguous array per component (SoA), so systems stream through exactly
+/// the data they query.
+namespace App::Ecs {
+
+/// Bytes per chunk, sized to stay resident in L1/L2 while a system walks it.
+constexpr std::size_t CHUNK_BYTES = 16 * 1024;
+constexpr std::size_t MAX_COMPONENTS = 64;
+/// Chunks are aligned for SIMD loads and so their arrays don't share cache lines with other allocations.
+constexpr std::size_t CHUNK_ALIGNMENT = 64;
+
+using ComponentId = uint32_t;
+using ComponentMask = std::bitset<MAX_COMPONENTS>;
+
+struct Entity {
+  uint32_t index = std::numeric_limits<uint32_t>::max();
+  uint32_t generation = 0;
+
+  bool operator==(const Entity &) const = default;
+};
+
+constexpr Entity NULL_ENTITY{};
+
+struct ComponentInfo {
+  std::size_t size;
+  std::size_t alignment;
+};
+
+ComponentId registerComponent(const ComponentInfo &info);
+const ComponentInfo &componentInfo(ComponentId id);
+
+/// Components are plain data, chunks move them around with memcpy and never run constructors or destructors.
+template <class T>
+concept Component = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> && !std::is_empty_v<T>;
+
+template <Component T> ComponentId componentId() {
+  static const ComponentId id = registerComponent({sizeof(T), alignof(T)});
+  return id;
+}
+
+template <class T> ComponentId componentIdOf() {
+  return componentId<std::remove_cvref_t<T>>();
+}
+
+class Archetype {
+public:
+  struct Chunk {
+    struct Free {
+      void operator()(std::byte *data) const {
+        ::operator delete[](data, std::align_val_t(CHUNK_ALIGNMENT));
+      }
+    };
+
+    using Data = std::unique_ptr<std::byte[], Free>;
+
+    Data data;
+    uint32_t count = 0;
+  };
+
+  struct Location {
+    uint32_t chunk;
+    uint32_t row;
+  };
+
+  explicit Archetype(const ComponentMask &mask);
+
+  [[nodiscard]] const ComponentMask &getMask() const {
+    return m_mask;
+  }
+
+  [[nodiscard]] const std::vector<ComponentId> &getComponents() const {
+    return m_components;
+  }
+
+  [[nodiscard]] std::vector<Chunk> &getChunks() {
+    return m_chunks;
+  }
+
+  [[nodiscard]] std::size_t getChunkCapacity() const {
+    return m_capacity;
+  }
+
+  [[nodiscard]] std::size_t size() const;
+
+  /// Appends an entity with uninitialized components.
+  Location allocate(Entity entity);
+
+  /// Fills the hole at `location` with the last entity and returns it, or NULL_ENTITY if the removed one was last.
+  Entity remove(Location location);
+
+  [[nodiscard]] std::byte *component(const ComponentId id, const Location location) {
+    return m_chunks[location.chunk].data.get() + m_offsets[id] + location.row * componentInfo(id).size;
+  }
+
+  template <class T> [[nodiscard]] T *column(Chunk &chunk) const {
+    return reinterpret_cast<T *>(chunk.data.get() + m_offsets[componentIdOf<T>()]);
+  }
+
+  [[nodiscard]] Entity *entities(Chunk &chunk) const {
+    return reinterpret_cast<Entity *>(chunk.data.get());
+  }
+
+private:
+  ComponentMask m_mask;
+  std::vector<ComponentId> m_components;
+  std::array<std::size_t, MAX_COMPONENTS> m_offsets{}; // Of each component's array within a chunk
+  std::size_t m_capacity = 0;
+  std::size_t m_chunkBytes = 0;
+  std::vector<Chunk> m_chunks;
+};
+
+template <class... Ts> class Query;
+
+/// Owns every entity and its components. Structural changes (create, destroy, add, remove) must not happen while a
+/// query iterates.
+class Registry {
+public:
+  Registry() = default;
+
+  Registry(const Registry &) = delete;
+  Registry &operator=(const Registry &) = delete;
+
+  template <Component... Ts> Entity create(const Ts &...components) {
+    ComponentMask mask;
+    (mask.set(componentId<Ts>()), ...);
+
+    Archetype &archetype = archetypeFor(mask);
+    const Entity entity = allocateEntity();
+    const Archetype::Location location = archetype.allocate(entity);
+    m_records[entity.index] = {&archetype, location, entity.generation};
+
+    (std::memcpy(archetype.component(componentId<Ts>(), location), &components, sizeof(Ts)), ...);
+    return entity;
+  }
+
+  void destroy(Entity entity);
+
+  [[nodiscard]] bool isAlive(Entity entity) const;
+
+  /// Null if the entity is dead or lacks the component. Valid until the next structural change.
+  template <Component T> [[nodiscard]] T *get(const Entity entity) {
+    if (!has<T>(entity)) {
+      return nullptr;
+    }
+
+    const Record &record = m_records[entity.index];
+    return reinterpret_cast<T *>(record.archetype->component(componentId<T>(), record.location));
+  }
+
+  template <Component T> [[nodiscard]] bool has(const Entity entity) const {
+    return isAlive(entity) && m_records[entity.index].archetype->getMask().test(componentId<T>());
+  }
+
+  /// Adds the component, or overwrites it if the entity already has one.
+  template <Component T> void add(const Entity entity, const T &component) {
+    if (!isAlive(entity)) {
+      return;
+    }
+
+    if (!has<T>(entity)) {
+      ComponentMask mask = m_records[entity.index].archetype->getMask();
+      moveEntity(entity, archetypeFor(mask.set(componentId<T>())));
+    }
+
+    *get<T>(entity) = component;
+  }
+
+  template <Component T> void remove(const Entity entity) {
+    if (has<T>(entity)) {
+      ComponentMask mask = m_records[entity.index].archetype->getMask();
+      moveEntity(entity, archetypeFor(mask.reset(componentId<T>())));
+    }
+  }
+
+  /// Entities having at least the components `Ts` (const-qualify the ones a system only reads). Valid until the next
+  /// structural change.
+  template <class... Ts> [[nodiscard]] Query<Ts...> query();
+
+  [[nodiscard]] std::size_t size() const {
+    return m_records.size() - m_freeIndices.size();
+  }
+
+private:
+  struct Record {
+    Archetype *archetype = nullptr;
+    Archetype::Location location{};
+    uint32_t generation = 0;
+  };
+
+  std::unordered_map<ComponentMask, std::unique_ptr<Archetype>> m_archetypes;
+  std::vector<Archetype *> m_archetypeList; // Creation order, for queries
+  // Archetypes matching each mask queried so far, kept up to date as archetypes appear so queries don't allocate
+  std::unordered_map<ComponentMask, std::vector<Archetype *>> m_queryMatches;
+  std::vector<Record> m_records;            // Indexed by Entity::index
+  std::vector<uint32_t> m_freeIndices;
+
+  Archetype &archetypeFor(const ComponentMask &mask);
+  Entity allocateEntity();
+  void moveEntity(Entity entity, Archetype &target);
+  void removeFromArchetype(const Record &record);
+};
+
+/// Matching archetypes, captured when the query is made.
+template <class... Ts> class Query {
+public:
+  explicit Query(const std::span<Archetype *const> archetypes) : m_archetypes(archetypes) {
+  }
+
+  /// Calls `function(Ts&...)`, or `function(Entity, Ts&...)`, for every matching entity.
+  template <class F> void each(F &&function) const {
+    for (Archetype *archetype : m_archetypes) {
+      for (Archetype::Chunk &chunk : archetype->getChunks()) {
+        eachInChunk(*archetype, chunk, function);
+      }
+    }
+  }
+
+  /// Like `each`, with chunks spread over the job system. `function` must be safe to call concurrently.
+  template <class F> void parallelEach(JobSystem &jobs, F &&function) const {
+    for (Archetype *archetype : m_archetypes) {
+      std::vector<Archetype::Chunk> &chunks = archetype->getChunks();
+
+      jobs.parallelFor(chunks.size(), 1, [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          eachInChunk(*archetype, chunks[i], function);
+        }
+      });
+    }
+  }
+
+  /// Calls `function(count, Entity*, Ts*...)` with the component arrays of every matching chunk.
+  template <class F> void eachChunk(F &&function) const {
+    for (Archetype *archetype : m_archetypes) {
+      for (Archetype::Chunk &chunk : archetype->getChunks()) {
+        function(static_cast<std::size_t>(chunk.count), archetype->entities(chunk),
+                 archetype->column<std::remove_cvref_t<Ts>>(chunk)...);
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    std::size_t count = 0;
+
+    for (const Archetype *archetype : m_archetypes) {
+      count += archetype->size();
+    }
+
+    return count;
+  }
+
+private:
+  std::span<Archetype *const> m_archetypes;
+
+  template <class F> static void eachInChunk(const Archetype &archetype, Archetype::Chunk &chunk, F &function) {
+    const std::tuple<Ts *...> columns{archetype.column<std::remove_cvref_t<Ts>>(chunk)...};
+    const Entity *entities = archetype.entities(chunk);
+
+    for (uint32_t row = 0; row < chunk.count; row++) {
+      std::apply(
+          [&](auto *...column) {
+            if constexpr (std::is_invocable_v<F &, Entity, Ts &...>) {
+              function(entities[row], column[row]...);
+            } else {
+              function(column[row]...);
+            }
+          },
+          columns);
+    }
+  }
+};
+
+template <class... Ts> Query<Ts...> Registry::query() {
+  ComponentMask mask;
+  (mask.set(componentIdOf<Ts>()), ...);
+
+  const auto [entry, inserted] = m_queryMatches.try_emplace(mask);
+
+  if (inserted) {
+    for (Archetype *archetype : m_archetypeList) {
+      if ((archetype->getMask() & mask) == mask) {
+        entry->second.push_back(archetype);
+      }
+    }
+  }
+
+  // Empty archetypes stay in the list, they have no chunks to walk
+  return Query<Ts...>(entry->second);
+}
+
+} // namespace App::Ecs
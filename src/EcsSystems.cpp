@@ -0,0 +1,121 @@
+#include "EcsSystems.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Frustum.h"
+#include "ClusteredLighting.h"
+#include "OcclusionCuller.h"
+#include "Profiler.h"
+#include "Simd.h"
+
+namespace App::Ecs {
+
+void updateTransforms(Registry &registry, JobSystem &jobs) {
+  PROFILE_SCOPE("Update transforms");
+
+  registry.query<Transform>().parallelEach(jobs, [](Transform &transform) {
+    // Same as translate * rotate * scale, without the two matrix products
+    transform.world = glm::mat4_cast(transform.rotation);
+    transform.world[0] *= transform.scale.x;
+    transform.world[1] *= transform.scale.y;
+    transform.world[2] *= transform.scale.z;
+    transform.world[3] = glm::vec4(transform.position, 1.0f);
+  });
+}
+
+std::span<const Light> collectLights(Registry &registry, FrameArena &arena) {
+  const Query<const Light> query = registry.query<const Light>();
+  const std::span<Light> lights = arena.allocateArray<Light>(query.size());
+  std::size_t count = 0;
+
+  query.each([&](const Light &light) { lights[count++] = light; });
+  return lights;
+}
+
+MeshRenderStats collectDraws(Registry &registry, const glm::mat4 &viewProjection, std::pmr::vector<MeshDraw> &draws,
+                             OcclusionCuller *occlusion) {
+  PROFILE_SCOPE("Collect mesh draws");
+
+  const Frustum frustum(viewProjection);
+  MeshRenderStats stats;
+
+  registry.query<const Transform, const MeshRenderer>().each([&](const Transform &transform,
+                                                                 const MeshRenderer &renderer) {
+    if (!renderer.mesh || !renderer.material) {
+      return;
+    }
+
+    const AABB bounds = renderer.mesh->getBounds().transformed(transform.world);
+
+    if (!frustum.intersects(bounds) || (occlusion && !occlusion->isVisible(bounds))) {
+      stats.culledEntities++;
+      return;
+    }
+
+    draws.push_back({renderer.mesh, renderer.material, renderer.renderMode, transform.world});
+    stats.drawnEntities++;
+  });
+
+  return stats;
+}
+
+void computeDrawMatrices(const std::span<MeshDraw> draws, const glm::mat4 &viewProjection) {
+  PROFILE_SCOPE("Compute draw matrices");
+
+  // The view-projection's columns stay in registers for the whole batch, each column of a product is their sum
+  // weighted by a column of the world matrix
+  const Simd::Float4 viewProjectionColumns[] = {
+      Simd::Float4::load(&viewProjection[0][0]), Simd::Float4::load(&viewProjection[1][0]),
+      Simd::Float4::load(&viewProjection[2][0]), Simd::Float4::load(&viewProjection[3][0])};
+
+  for (MeshDraw &draw : draws) {
+    for (int column = 0; column < 4; column++) {
+      const glm::vec4 &weights = draw.world[column];
+      const Simd::Float4 product = viewProjectionColumns[0] * Simd::Float4(weights.x) +
+                                   viewProjectionColumns[1] * Simd::Float4(weights.y) +
+                                   viewProjectionColumns[2] * Simd::Float4(weights.z) +
+                                   viewProjectionColumns[3] * Simd::Float4(weights.w);
+      product.store(&draw.modelViewProjection[column][0]);
+    }
+
+    draw.normalMatrix = normalMatrix(draw.world);
+  }
+}
+
+void drawMeshes(const std::span<const MeshDraw> draws, const RenderContext &ctx) {
+  PROFILE_SCOPE("Draw meshes");
+
+  const Shader *boundShader = nullptr;
+  const Material *boundMaterial = nullptr;
+  Shader *shader = nullptr;
+
+  for (const MeshDraw &draw : draws) {
+    Material *material = draw.material;
+
+    if (material != boundMaterial) {
+      shader = ctx.customShader ? ctx.customShader : &material->getShader(ctx.lightBucket);
+
+      if (shader != boundShader) {
+        shader->use();
+        shader->set("uView", ctx.viewMatrix);
+        shader->set("uWorld.viewPosition", ctx.cameraPosition);
+        if (ctx.lighting && ctx.lightBucket != LightBucket::Unlit) {
+          ctx.lighting->bind(*shader);
+        }
+        boundShader = shader;
+      }
+
+      // Textures first, they set the samplers applied with the other uniforms
+      material->bindTextures();
+      material->applyUniforms(*shader);
+      boundMaterial = material;
+    }
+
+    shader->set("uModel", draw.world);
+    shader->set("uModelViewProjection", draw.modelViewProjection);
+    shader->set("uNormalMatrix", draw.normalMatrix);
+    draw.mesh->render(draw.renderMode);
+  }
+}
+
+} // namespace App::Ecs
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Ecs.h"
+#include "FrameArena.h"
+#include "Light.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Renderable.h"
+
+namespace App {
+class OcclusionCuller;
+}
+
+/// Built-in components and the systems working on them. Lights use the engine's plain `Light` struct as is.
+namespace App::Ecs {
+
+/// Placement relative to the world, `world` is derived from the rest by `updateTransforms`.
+struct Transform {
+  glm::vec3 position{0.0f};
+  glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+  glm::vec3 scale{1.0f};
+  glm::mat4 world{1.0f};
+};
+
+/// Draws a mesh with a material. Both are owned elsewhere (a Model, a cache) and must outlive the entity.
+struct MeshRenderer {
+  const Mesh *mesh = nullptr;
+  Material *material = nullptr;
+  GLuint renderMode = GL_TRIANGLES;
+};
+
+/// One mesh renderer as picked by `collectDraws`, with the world matrix it had then.
+struct MeshDraw {
+  const Mesh *mesh;
+  Material *material;
+  GLuint renderMode;
+  glm::mat4 world;
+  // Filled in by `computeDrawMatrices`, so vertex shaders don't redo them per vertex
+  glm::mat4 modelViewProjection{1.0f};
+  glm::mat3 normalMatrix{1.0f};
+};
+
+struct MeshRenderStats {
+  std::size_t drawnEntities = 0;
+  std::size_t culledEntities = 0;
+};
+
+/// Recomputes the world matrix of every transform, chunks spread over the job system.
+void updateTransforms(Registry &registry, JobSystem &jobs);
+
+/// Lights of every entity with a Light component, for the render context. Lives until the arena's next reset.
+[[nodiscard]] std::span<const Light> collectLights(Registry &registry, FrameArena &arena);
+
+/// Appends every mesh renderer inside the frustum and, if a culler is given, not occluded to `draws`. Makes no GL
+/// calls, so it can run off the GL thread while nothing changes the registry.
+MeshRenderStats collectDraws(Registry &registry, const glm::mat4 &viewProjection, std::pmr::vector<MeshDraw> &draws,
+                             OcclusionCuller *occlusion = nullptr);
+
+/// Model-view-projection and normal matrix of every draw, for one view. Once per object on the CPU instead of once per
+/// vertex in skeleton.vert, where the normal matrix was a 3x3 inverse for every vertex.
+void computeDrawMatrices(std::span<MeshDraw> draws, const glm::mat4 &viewProjection);
+
+/// Draws what `collectDraws` picked, once `computeDrawMatrices` has run on it. Shader and material state is only set
+/// when it changes between consecutive draws, the per draw cost is its matrices and draw call.
+void drawMeshes(std::span<const MeshDraw> draws, const RenderContext &ctx);
+
+} // namespace App::Ecs
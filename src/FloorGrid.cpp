@@ -18,6 +18,7 @@ FloorGrid::~FloorGrid() {
   }
 
   s_gridVAO = s_gridVBO = 0;
+  s_gridShader = nullptr;
 }
 
 void FloorGrid::setup() {
@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace App {
+
+FrameArena::FrameArena(const std::size_t capacity) : m_block(allocateBlock(capacity)), m_capacity(capacity) {
+  m_stats.capacityBytes = m_capacity;
+  m_memory.set(m_capacity);
+}
+
+FrameArena::Block FrameArena::allocateBlock(const std::size_t bytes) {
+  return Block(static_cast<std::byte *>(::operator new[](bytes, std::align_val_t(BLOCK_ALIGNMENT))));
+}
+
+void FrameArena::reset() {
+  const std::size_t usedBytes = m_offset + m_spilledBytes;
+  m_stats = {.usedBytes = usedBytes, .capacityBytes = m_capacity, .spilledAllocations = m_spills.size()};
+
+  if (!m_spills.empty()) {
+    m_spills.clear();
+    m_capacity = std::bit_ceil(usedBytes);
+    m_block = allocateBlock(m_capacity);
+    m_memory.set(m_capacity);
+  }
+
+  m_offset = 0;
+  m_spilledBytes = 0;
+}
+
+void *FrameArena::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+  assert(alignment <= BLOCK_ALIGNMENT && "Over-aligned types don't fit the arena");
+
+  const std::size_t start = (m_offset + alignment - 1) & ~(alignment - 1);
+
+  if (start + bytes <= m_capacity) {
+    m_offset = start + bytes;
+    return m_block.get() + start;
+  }
+
+  m_spilledBytes += bytes + alignment;
+  return m_spills.emplace_back(allocateBlock(std::max<std::size_t>(bytes, 1))).get();
+}
+
+} // namespace App
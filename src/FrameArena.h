@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "MemoryAccounting.h"
+
+namespace App {
+
+struct FrameArenaStats {
+  std::size_t usedBytes = 0; // By the last frame
+  std::size_t capacityBytes = 0;
+  std::size_t spilledAllocations = 0; // Didn't fit and went to the heap, the arena grows to avoid that next time
+};
+
+/// Bump allocator for data that only lives for one frame: light arrays, draw lists, anything a render pass builds
+/// and forgets. Everything is freed at once by `reset` at the start of the frame. Also a pmr memory resource, so
+/// std::pmr containers can draw from it. Not thread-safe, one thread fills it at a time.
+class FrameArena final : public std::pmr::memory_resource {
+public:
+  explicit FrameArena(std::size_t capacity);
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  /// Frees the previous frame's allocations. If they spilled over, the block grows to fit them all next time.
+  void reset();
+
+  /// Value-initialized array, gone at the next reset.
+  template <class T> [[nodiscard]] std::span<T> allocateArray(const std::size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "Nothing in the arena gets destroyed");
+
+    T *data = static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    std::uninitialized_value_construct_n(data, count);
+    return {data, count};
+  }
+
+  template <class T, class... Args> [[nodiscard]] T &create(Args &&...args) {
+    static_assert(std::is_trivially_destructible_v<T>, "Nothing in the arena gets destroyed");
+
+    return *new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  [[nodiscard]] const FrameArenaStats &getStats() const {
+    return m_stats;
+  }
+
+private:
+  static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+  struct Free {
+    void operator()(std::byte *data) const {
+      ::operator delete[](data, std::align_val_t(BLOCK_ALIGNMENT));
+    }
+  };
+
+  using Block = std::unique_ptr<std::byte[], Free>;
+
+  Block m_block;
+  std::size_t m_capacity = 0;
+  std::size_t m_offset = 0;
+  std::vector<Block> m_spills; // Allocations that didn't fit this frame
+  std::size_t m_spilledBytes = 0;
+  FrameArenaStats m_stats;
+  TrackedMemory m_memory{MemoryTag::Frames, MemoryPool::Cpu}; // The block, spills are gone by the next reset
+
+  static Block allocateBlock(std::size_t bytes);
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *, std::size_t, std::size_t) override {
+    // Freed all at once by reset
+  }
+
+  [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace App
@@ -0,0 +1,142 @@
+#include "FramePacer.h"
+
+#include <thread>
+
+#include "Profiler.h"
+
+namespace App {
+
+namespace {
+float millisecondsBetween(const FramePacer::Clock::time_point from, const FramePacer::Clock::time_point to) {
+  return std::chrono::duration<float, std::milli>(to - from).count();
+}
+} // namespace
+
+int FramePacer::swapInterval(const PresentMode mode) {
+  switch (mode) {
+  case PresentMode::AdaptiveVsync:
+    return -1;
+  case PresentMode::Uncapped:
+  case PresentMode::Limited:
+    return 0;
+  case PresentMode::Vsync:
+  case PresentMode::LowLatency:
+    break;
+  }
+
+  return 1;
+}
+
+const char *presentModeName(const PresentMode mode) {
+  switch (mode) {
+  case PresentMode::Vsync:
+    return "Vsync";
+  case PresentMode::AdaptiveVsync:
+    return "Adaptive vsync";
+  case PresentMode::Uncapped:
+    return "Uncapped";
+  case PresentMode::Limited:
+    return "Frame limiter";
+  case PresentMode::LowLatency:
+    return "Low latency";
+  }
+
+  return "Unknown";
+}
+
+FramePacer::~FramePacer() {
+  releaseFences();
+}
+
+void FramePacer::setMode(const PresentMode mode) {
+  m_mode = mode;
+  m_deadline = m_inputTime = Clock::now();
+
+  if (mode != PresentMode::LowLatency) {
+    releaseFences();
+  }
+}
+
+void FramePacer::waitForNextFrame() {
+  const Clock::time_point start = Clock::now();
+
+  if (m_mode == PresentMode::Limited) {
+    waitForDeadline();
+  } else if (m_mode == PresentMode::LowLatency) {
+    waitForGpu(Config::Window::LOW_LATENCY_FRAMES_IN_FLIGHT);
+  }
+
+  m_inputTime = Clock::now();
+  m_waitMs = millisecondsBetween(start, m_inputTime);
+}
+
+void FramePacer::endFrame(const std::optional<Clock::time_point> submittedInput) {
+  if (m_mode == PresentMode::LowLatency) {
+    m_fences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  }
+
+  if (!submittedInput) {
+    return;
+  }
+
+  FrameLatencyStats &latency = m_latency[static_cast<std::size_t>(m_mode)];
+  latency.lastMs = millisecondsBetween(*submittedInput, Clock::now());
+  latency.maxMs = glm::max(latency.maxMs, latency.lastMs);
+  latency.frames++;
+  latency.averageMs += (latency.lastMs - latency.averageMs) / static_cast<float>(latency.frames);
+}
+
+void FramePacer::waitForDeadline() {
+  using namespace std::chrono;
+
+  const auto period = duration_cast<Clock::duration>(duration<double>(1.0 / m_frameRateLimit));
+  const auto spin = duration_cast<Clock::duration>(duration<float, std::milli>(Config::Window::LIMITER_SPIN_MS));
+
+  m_deadline += period;
+  Clock::time_point now = Clock::now();
+
+  // A frame that ran over starts the schedule again instead of rushing the next ones to catch up
+  if (m_deadline + period < now) {
+    m_deadline = now;
+    return;
+  }
+
+  PROFILE_SCOPE("Frame limiter");
+
+  // Sleeps overshoot by up to a scheduler tick, the last stretch is spun
+  if (m_deadline - now > spin) {
+    std::this_thread::sleep_for(m_deadline - now - spin);
+  }
+
+  while (now < m_deadline) {
+    std::this_thread::yield();
+    now = Clock::now();
+  }
+}
+
+void FramePacer::waitForGpu(const std::size_t framesInFlight) {
+  if (m_fences.empty() || m_fences.size() < framesInFlight) {
+    return;
+  }
+
+  PROFILE_SCOPE("Wait for GPU");
+
+  // The frame about to start counts as one in flight
+  while (!m_fences.empty() && m_fences.size() >= framesInFlight) {
+    while (glClientWaitSync(m_fences.front(), GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000) == GL_TIMEOUT_EXPIRED) {
+    }
+
+    glDeleteSync(m_fences.front());
+    m_fences.pop_front();
+  }
+}
+
+void FramePacer::releaseFences() {
+  for (const GLsync fence : m_fences) {
+    glDeleteSync(fence);
+  }
+
+  m_fences.clear();
+}
+
+} // namespace App
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Config.h"
+
+namespace App {
+
+enum class PresentMode : uint8_t {
+  Vsync,         // Swaps on the vertical blank, the driver may queue a few frames ahead
+  AdaptiveVsync, // Like vsync, but a late frame is shown right away (and tears) instead of a whole refresh later
+  Uncapped,      // No vsync, as fast as the CPU and the GPU go
+  Limited,       // No vsync, a steady frame rate from a sleep that is finished by spinning
+  LowLatency,    // Vsync, with the input only sampled once the GPU has caught up to a frame or so behind
+};
+
+constexpr std::size_t PRESENT_MODE_COUNT = 5;
+
+[[nodiscard]] const char *presentModeName(PresentMode mode);
+
+/// Input to submit latency: from sampling the input a frame was built from to the swap handing that frame over.
+struct FrameLatencyStats {
+  float lastMs = 0.0f;
+  float averageMs = 0.0f;
+  float maxMs = 0.0f;
+  uint64_t frames = 0;
+};
+
+/// Decides when a frame starts and how it is presented. Without it vsync was all there was, and nothing kept the CPU
+/// from running several frames ahead of the GPU, each of them adding a frame of latency.
+///
+/// Every mode waits in `waitForNextFrame`, at the very end of a frame: the limiter for its deadline, low latency mode
+/// for the GPU to finish all but its last frames (fences set by `endFrame`). SDL delivers the events of the next frame
+/// only after that, so waiting there rather than in the swap keeps the input as fresh as possible. Latency is kept per
+/// mode, so switching between them compares them on the same scene.
+class FramePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  FramePacer() = default;
+  ~FramePacer();
+
+  FramePacer(const FramePacer &) = delete;
+  FramePacer &operator=(const FramePacer &) = delete;
+
+  /// Starts pacing frames for the mode. The swap interval is for the window to set, see `swapInterval`.
+  void setMode(PresentMode mode);
+
+  [[nodiscard]] PresentMode getMode() const {
+    return m_mode;
+  }
+
+  /// Swap interval a mode presents with: 1 for vsync, -1 for adaptive vsync (late swap tearing), 0 for none.
+  [[nodiscard]] static int swapInterval(PresentMode mode);
+
+  /// Last thing of a frame, once `endFrame` fenced it: waits until the next frame may start, then marks the moment
+  /// its input starts being sampled. Events are pumped between frames, after this returns.
+  void waitForNextFrame();
+
+  /// Once the swap returned. Records the latency of the input the submitted frame was built from, none when no frame
+  /// was submitted, and fences the frame for low latency mode.
+  void endFrame(std::optional<Clock::time_point> submittedInput);
+
+  /// When the input of the current frame was sampled, to be carried with what is built from it.
+  [[nodiscard]] Clock::time_point getInputTime() const {
+    return m_inputTime;
+  }
+
+  [[nodiscard]] int getFrameRateLimit() const {
+    return m_frameRateLimit;
+  }
+
+  void setFrameRateLimit(const int frameRateLimit) {
+    m_frameRateLimit = glm::max(frameRateLimit, 1);
+  }
+
+  /// Time the last `waitForNextFrame` spent waiting, in milliseconds.
+  [[nodiscard]] float getWaitMs() const {
+    return m_waitMs;
+  }
+
+  [[nodiscard]] const FrameLatencyStats &getLatency(const PresentMode mode) const {
+    return m_latency[static_cast<std::size_t>(mode)];
+  }
+
+  void resetLatency() {
+    m_latency = {};
+  }
+
+private:
+  PresentMode m_mode = PresentMode::Vsync;
+  int m_frameRateLimit = Config::Window::FRAME_RATE_LIMIT;
+  float m_waitMs = 0.0f;
+  Clock::time_point m_inputTime{};
+  Clock::time_point m_deadline{}; // Start of the next frame for the limiter
+  std::deque<GLsync> m_fences;    // Ends of the frames the GPU may still be working on, oldest first
+  std::array<FrameLatencyStats, PRESENT_MODE_COUNT> m_latency{};
+
+  void waitForDeadline();
+  void waitForGpu(std::size_t framesInFlight);
+  void releaseFences();
+};
+
+} // namespace App
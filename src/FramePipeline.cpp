@@ -0,0 +1,210 @@
+#include "FramePipeline.h"
+
+#include <memory>
+#include <utility>
+
+#include "Container.h"
+#include "Profiler.h"
+
+namespace App {
+
+FramePipeline::FramePipeline() {
+  for (std::unique_ptr<FramePacket> &packet : m_packets) {
+    packet = std::make_unique<FramePacket>(Config::Renderer::FRAME_ARENA_BYTES);
+  }
+
+  m_thread = std::jthread([this](const std::stop_token &stopToken) { run(stopToken); });
+}
+
+const FramePacket *FramePipeline::acquire() {
+  PROFILE_SCOPE("Wait for frame packet");
+  const int64_t startNs = Profiler::nowNs();
+  FramePacket *packet;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_prepared.wait(lock, [this] { return !m_pending; });
+    packet = std::exchange(m_ready, nullptr);
+  }
+
+  m_stats.waitMs = static_cast<float>(Profiler::nowNs() - startNs) / 1e6f;
+  m_acquired = packet;
+
+  if (packet) {
+    m_stats.prepareMs = packet->prepareMs;
+    m_lastPacket = packet;
+  }
+
+  return packet;
+}
+
+const FramePacket *FramePipeline::prepare(const FrameView &view) {
+  const FramePacket *acquired = std::exchange(m_acquired, nullptr);
+
+  // Dropping the last pipelined packet would lose its edit latencies, and the shadow cache would take the cascades
+  // it planned to redraw for drawn. It goes out first, serial frames start with the next one.
+  if (!m_pipelined) {
+    return acquired ? acquired : &prepareNow(view);
+  }
+
+  FramePacket &packet = nextPacket();
+
+  {
+    const std::lock_guard lock(m_mutex);
+    m_pending = &packet;
+    m_pendingView = view;
+  }
+
+  m_wake.notify_one();
+  return nullptr;
+}
+
+const FramePacket &FramePipeline::prepareNow(const FrameView &view) {
+  acquire();
+
+  FramePacket &packet = nextPacket();
+  build(packet, view);
+  m_stats.prepareMs = packet.prepareMs;
+  m_lastPacket = &packet;
+  return packet;
+}
+
+void FramePipeline::submit(const FramePacket &packet) {
+  PROFILE_SCOPE("Submit frame");
+
+  const RenderContext ctx{
+      .modelMatrix = glm::mat4(1.0f),
+      .viewMatrix = packet.view.viewMatrix,
+      .projectionMatrix = packet.view.projectionMatrix,
+      .cameraPosition = packet.view.cameraPosition,
+      .lighting = &g_clusteredLighting,
+      .shadows = &g_shadowMaps,
+      .lightBucket = ShaderVariant::bucketFor(packet.lights.stats.busiestCluster),
+  };
+
+  g_clusteredLighting.upload(packet.lights);
+
+  {
+    PROFILE_GPU_SCOPE("Shadows");
+    g_shadowMaps.render(packet.shadows);
+  }
+
+  const glm::ivec2 size(packet.view.viewportSize);
+  const bool prepass = g_depthPrepass.isEnabled();
+
+  // Replaces the frame, the shadows above are still drawn so their cache holds what the next frames expect
+  if (g_overdrawHeatmap.isEnabled()) {
+    PROFILE_GPU_SCOPE("Overdraw");
+    g_overdrawHeatmap.render(packet.chunks, packet.meshes, ctx, prepass ? &g_depthPrepass : nullptr, size);
+    g_world.recordEditLatencies(packet.drawnEdits);
+    return;
+  }
+
+  // Deferred entities go first, the lighting pass would cover terrain drawn before it
+  const bool deferred = g_deferredRenderer.isEnabled();
+
+  if (deferred) {
+    PROFILE_GPU_SCOPE("Entities");
+    g_deferredRenderer.render(packet.meshes, ctx, size);
+  }
+
+  {
+    PROFILE_GPU_SCOPE("Terrain");
+    g_world.draw(packet.chunks, ctx);
+  }
+
+  if (!deferred && prepass) {
+    {
+      PROFILE_GPU_SCOPE("Depth pre-pass");
+      g_depthPrepass.render(packet.meshes, ctx);
+    }
+
+    PROFILE_GPU_SCOPE("Entities");
+    DepthPrepass::beginEqualDepth();
+    Ecs::drawMeshes(packet.meshes, ctx);
+    DepthPrepass::endEqualDepth();
+  } else if (!deferred) {
+    PROFILE_GPU_SCOPE("Entities");
+    Ecs::drawMeshes(packet.meshes, ctx);
+  }
+
+  g_world.recordEditLatencies(packet.drawnEdits);
+}
+
+void FramePipeline::run(const std::stop_token &stopToken) {
+  Profiler::setThreadName("Frame pipeline");
+
+  while (true) {
+    FramePacket *packet;
+    FrameView view;
+
+    {
+      std::unique_lock lock(m_mutex);
+
+      if (!m_wake.wait(lock, stopToken, [this] { return m_pending != nullptr; })) {
+        return;
+      }
+
+      packet = m_pending;
+      view = m_pendingView;
+    }
+
+    build(*packet, view);
+
+    {
+      const std::lock_guard lock(m_mutex);
+      m_pending = nullptr;
+      m_ready = packet;
+    }
+
+    m_prepared.notify_one();
+  }
+}
+
+FramePacket &FramePipeline::nextPacket() {
+  FramePacket &packet = *m_packets[m_nextPacket];
+  m_nextPacket = (m_nextPacket + 1) % m_packets.size();
+  packet.frame = m_frame++;
+  return packet;
+}
+
+void FramePipeline::build(FramePacket &packet, const FrameView &view) {
+  PROFILE_SCOPE("Prepare frame");
+  const int64_t startNs = Profiler::nowNs();
+
+  // Clearing would keep buffers the reset arena hands out again, the lists start over instead (assigning one would
+  // not do either, pmr containers keep their own resource). Reserved for what the packet needed last time.
+  const std::size_t chunkCount = packet.chunks.size();
+  const std::size_t meshCount = packet.meshes.size();
+
+  std::destroy_at(&packet.chunks);
+  std::destroy_at(&packet.meshes);
+  std::destroy_at(&packet.drawnEdits);
+  packet.arena.reset();
+  std::construct_at(&packet.chunks, &packet.arena);
+  std::construct_at(&packet.meshes, &packet.arena);
+  std::construct_at(&packet.drawnEdits, &packet.arena);
+
+  packet.chunks.reserve(chunkCount);
+  packet.meshes.reserve(meshCount);
+  packet.view = view;
+
+  const glm::mat4 viewProjection = view.projectionMatrix * view.viewMatrix;
+  g_occlusionCuller.beginFrame(viewProjection);
+
+  // Terrain first, it fills the occlusion buffer the entities are tested against
+  packet.worldStats =
+      g_world.cull(view.cameraPosition, viewProjection, packet.arena, packet.chunks, packet.drawnEdits);
+
+  Ecs::updateTransforms(g_entities, g_jobSystem);
+  packet.entityStats = Ecs::collectDraws(g_entities, viewProjection, packet.meshes, &g_occlusionCuller);
+  Ecs::computeDrawMatrices(packet.meshes, viewProjection);
+  packet.lights = assignLightClusters(Ecs::collectLights(g_entities, packet.arena), view.viewMatrix,
+                                      view.projectionMatrix, view.viewportSize, packet.arena);
+  packet.shadows = g_shadowMaps.plan(view.viewMatrix, view.projectionMatrix, g_world, g_entities, packet.arena);
+  packet.occlusionStats = g_occlusionCuller.getStats();
+
+  packet.prepareMs = static_cast<float>(Profiler::nowNs() - startNs) / 1e6f;
+}
+
+} // namespace App
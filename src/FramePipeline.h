@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "ClusteredLighting.h"
+#include "Config.h"
+#include "EcsSystems.h"
+#include "FrameArena.h"
+#include "OcclusionCuller.h"
+#include "ShadowMaps.h"
+#include "World.h"
+
+namespace App {
+
+/// Camera a frame is prepared for.
+struct FrameView {
+  glm::mat4 viewMatrix{1.0f};
+  glm::mat4 projectionMatrix{1.0f};
+  glm::vec3 cameraPosition{0.0f};
+  glm::vec2 viewportSize{1.0f};
+  std::chrono::steady_clock::time_point inputTime{}; // When the input the view follows was sampled
+};
+
+/// Everything the GL thread needs to submit one frame. Built in one go by the prepare stage and left alone until the
+/// ring comes back around to it, so the GL thread reads it without locking.
+struct FramePacket {
+  explicit FramePacket(const std::size_t arenaBytes)
+      : arena(arenaBytes), chunks(&arena), meshes(&arena), drawnEdits(&arena) {}
+
+  FrameArena arena; // Backs everything below, reset when the packet is rebuilt
+  uint64_t frame = 0;
+  FrameView view;
+  LightClusters lights;
+  ShadowFrame shadows;
+  std::pmr::vector<ChunkDraw> chunks;
+  std::pmr::vector<Ecs::MeshDraw> meshes;
+  std::pmr::vector<World::Clock::time_point> drawnEdits;
+
+  WorldCullStats worldStats;
+  Ecs::MeshRenderStats entityStats;
+  OcclusionStats occlusionStats;
+  float prepareMs = 0.0f;
+};
+
+struct FramePipelineStats {
+  float prepareMs = 0.0f; // Building the last packet
+  float waitMs = 0.0f;    // The GL thread spent waiting for it
+};
+
+/// Splits a frame into a prepare stage (ECS transforms, culling, light clustering, shadow planning and draw list
+/// collection) and a submit stage (GL calls). Pipelined, the prepare stage of frame N+1 runs on the pipeline's own
+/// thread while the GL thread submits frame N, so a frame costs about the longer of the two rather than their sum, at
+/// one frame of latency. Packets rotate through a ring of `Config::Renderer::FRAME_PACKETS`.
+///
+/// From `prepare` until the next `acquire` the scene (world, entities, occlusion culler, sun) belongs to the pipeline's
+/// thread: the GL thread may submit and present, but not change any of it.
+class FramePipeline {
+public:
+  FramePipeline();
+
+  /// Waits for the packet being prepared and hands it over, null when none was. The scene may change again after.
+  const FramePacket *acquire();
+
+  /// Prepares the next packet for `view`: in the background when pipelined, otherwise right away. Returns the packet
+  /// if it is ready already, null if it comes with the next `acquire`. The first serial frame after switching from
+  /// pipelined ones returns the packet acquired last instead, it still has to be submitted.
+  const FramePacket *prepare(const FrameView &view);
+
+  /// Prepares the next packet on the calling thread, whatever the mode, once any packet in preparation is done.
+  const FramePacket &prepareNow(const FrameView &view);
+
+  /// Draws a packet into the bound framebuffer, GL thread only.
+  static void submit(const FramePacket &packet);
+
+  /// Last packet handed to the GL thread, for stats. Null before the first frame.
+  [[nodiscard]] const FramePacket *getLastPacket() const {
+    return m_lastPacket;
+  }
+
+  [[nodiscard]] const FramePipelineStats &getStats() const {
+    return m_stats;
+  }
+
+  [[nodiscard]] bool isPipelined() const {
+    return m_pipelined;
+  }
+
+  /// Takes effect with the next `prepare`.
+  void setPipelined(const bool pipelined) {
+    m_pipelined = pipelined;
+  }
+
+private:
+  std::array<std::unique_ptr<FramePacket>, Config::Renderer::FRAME_PACKETS> m_packets;
+  std::size_t m_nextPacket = 0;
+  uint64_t m_frame = 0;
+  bool m_pipelined = Config::Renderer::PIPELINED_FRAMES;
+  const FramePacket *m_lastPacket = nullptr;
+  const FramePacket *m_acquired = nullptr; // By the last `acquire`, until the `prepare` after it
+  FramePipelineStats m_stats;
+
+  // Shared with the pipeline's thread
+  std::mutex m_mutex;
+  std::condition_variable_any m_wake;
+  std::condition_variable m_prepared;
+  FramePacket *m_pending = nullptr; // Handed to the thread, back to null once built
+  FramePacket *m_ready = nullptr;   // Built, not acquired yet
+  FrameView m_pendingView;
+
+  std::jthread m_thread; // Last, so it is stopped and joined before the state it prepares with is destroyed
+
+  void run(const std::stop_token &stopToken);
+  FramePacket &nextPacket();
+  static void build(FramePacket &packet, const FrameView &view);
+};
+
+} // namespace App
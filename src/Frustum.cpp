@@ -0,0 +1,32 @@
+#include "Frustum.h"
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+  // Gribb & Hartmann, GLM matrices are column major so rows are read across columns
+  auto row = [&](const int index) {
+    return glm::vec4(viewProjection[0][index], viewProjection[1][index], viewProjection[2][index],
+                     viewProjection[3][index]);
+  };
+
+  m_planes = {
+      row(3) + row(0), // Left
+      row(3) - row(0), // Right
+      row(3) + row(1), // Bottom
+      row(3) - row(1), // Top
+      row(3) + row(2), // Near
+      row(3) - row(2), // Far
+  };
+}
+
+bool Frustum::intersects(const AABB &box) const {
+  for (const glm::vec4 &plane : m_planes) {
+    // Corner of the box furthest along the plane normal
+    const glm::vec3 corner(plane.x > 0.0f ? box.max.x : box.min.x, plane.y > 0.0f ? box.max.y : box.min.y,
+                           plane.z > 0.0f ? box.max.z : box.min.z);
+
+    if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+
+class Frustum {
+public:
+  /// Extracts the six clipping planes from a combined projection * view matrix.
+  explicit Frustum(const glm::mat4 &viewProjection);
+
+  /// Conservative test, boxes close to a frustum corner may pass while being outside.
+  [[nodiscard]] bool intersects(const AABB &box) const;
+
+private:
+  // xyz is the inward facing normal, w the distance
+  std::array<glm::vec4, 6> m_planes;
+};
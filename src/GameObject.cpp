@@ -5,12 +5,8 @@ void GameObject::render(const RenderContext &ctx) const {
     SPDLOG_WARN("No renderer");
   }
 
-  const RenderContext objectCtx = {
-      .modelMatrix = m_transform.GetModelMatrix(),
-      .viewMatrix = ctx.viewMatrix,
-      .projectionMatrix = ctx.projectionMatrix,
-      .cameraPosition = ctx.cameraPosition,
-  };
+  RenderContext objectCtx = ctx;
+  objectCtx.modelMatrix = m_transform.GetModelMatrix();
 
   m_renderer->render(objectCtx);
 }
@@ -7,8 +7,15 @@
 
 class GameObject {
 public:
+  explicit GameObject(std::shared_ptr<Renderable> renderer = nullptr) : m_renderer(std::move(renderer)) {
+  }
+
   void render(const RenderContext &ctx) const;
 
+  [[nodiscard]] Transform &getTransform() {
+    return m_transform;
+  }
+
 private:
   Transform m_transform;
   std::shared_ptr<Renderable> m_renderer = nullptr;
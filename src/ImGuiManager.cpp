@@ -4,9 +4,14 @@
 #include "Config.h"
 
 App::ImGuiManager::~ImGuiManager() {
-  ImGui_ImplOpenGL3_Shutdown();
-  ImGui_ImplSDL3_Shutdown();
-  ImGui::DestroyContext();
+  if (m_hasBackends) {
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplSDL3_Shutdown();
+  }
+
+  if (ImGui::GetCurrentContext()) {
+    ImGui::DestroyContext();
+  }
 }
 
 void App::ImGuiManager::setup() {
@@ -33,6 +38,13 @@ void App::ImGuiManager::setup() {
   // Setup Platform/Renderer backends
   ImGui_ImplSDL3_InitForOpenGL(SDL_GL_GetCurrentWindow(), SDL_GL_GetCurrentContext());
   ImGui_ImplOpenGL3_Init(Config::Core::GLSL_VERSION);
+  m_hasBackends = true;
+}
+
+void App::ImGuiManager::setupHeadless(const float width, const float height) {
+  IMGUI_CHECKVERSION();
+  ImGui::CreateContext();
+  ImGui::GetIO().DisplaySize = ImVec2(width, height);
 }
 
 void App::ImGuiManager::newFrame() {
@@ -12,6 +12,9 @@ public:
 
   void setup();
 
+  /// ImGui context without platform or renderer backends, for offscreen runs that still rely on its IO state.
+  void setupHeadless(float width, float height);
+
   void newFrame();
 
   void populateFrame();
@@ -21,5 +24,8 @@ public:
   void processEvent(const SDL_Event *event);
 
   [[nodiscard]] const ImGuiIO &io() const;
+
+private:
+  bool m_hasBackends = false;
 };
 } // namespace App
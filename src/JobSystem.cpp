@@ -0,0 +1,116 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+namespace App {
+
+JobSystem::JobSystem(unsigned int workerCount) {
+  if (workerCount == 0) {
+    workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+
+  m_workers.reserve(workerCount);
+
+  for (unsigned int i = 0; i < workerCount; i++) {
+    m_workers.emplace_back([this, i] {
+      Profiler::setThreadName("Worker " + std::to_string(i));
+      workerLoop();
+    });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    const std::lock_guard lock(m_mutex);
+    m_stopping = true;
+  }
+
+  m_wakeWorkers.notify_all();
+  m_workers.clear(); // Joins them while the state they wait on still exists
+}
+
+void JobSystem::run(const std::size_t count, const std::size_t grain, const Job job) {
+  if (count == 0) {
+    return;
+  }
+
+  // Not worth waking anyone up
+  if (m_workers.empty() || count <= grain) {
+    job.invoke(job.context, 0, count);
+    return;
+  }
+
+  const std::lock_guard callerLock(m_callerMutex);
+
+  {
+    const std::lock_guard lock(m_mutex);
+    m_batch.job = job;
+    m_batch.count = count;
+    m_batch.grain = std::max<std::size_t>(grain, 1);
+    m_batch.next = 0;
+    m_batch.done = 0;
+    m_batchIndex++;
+  }
+
+  m_wakeWorkers.notify_all();
+  runRanges();
+
+  std::unique_lock lock(m_mutex);
+  m_batchDone.wait(lock, [this] { return m_batch.done == m_batch.count && m_activeWorkers == 0; });
+  m_batch.job = {};
+}
+
+void JobSystem::runRanges() {
+  const std::size_t count = m_batch.count;
+  const std::size_t grain = m_batch.grain;
+
+  while (true) {
+    const std::size_t begin = m_batch.next.fetch_add(grain);
+
+    if (begin >= count) {
+      return;
+    }
+
+    const std::size_t end = std::min(begin + grain, count);
+    m_batch.job.invoke(m_batch.job.context, begin, end);
+
+    if (m_batch.done.fetch_add(end - begin) + (end - begin) == count) {
+      // Locked so the caller cannot miss the notification between its check and its wait
+      const std::lock_guard lock(m_mutex);
+      m_batchDone.notify_one();
+    }
+  }
+}
+
+void JobSystem::workerLoop() {
+  uint64_t seenBatch = 0;
+
+  while (true) {
+    {
+      std::unique_lock lock(m_mutex);
+      m_wakeWorkers.wait(lock, [&] { return m_stopping || (m_batchIndex != seenBatch && m_batch.job.invoke); });
+
+      if (m_stopping) {
+        return;
+      }
+
+      seenBatch = m_batchIndex;
+      m_activeWorkers++;
+    }
+
+    {
+      PROFILE_SCOPE("Job");
+      runRanges();
+    }
+
+    const std::lock_guard lock(m_mutex);
+
+    if (--m_activeWorkers == 0) {
+      m_batchDone.notify_one();
+    }
+  }
+}
+
+} // namespace App
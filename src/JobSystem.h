@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace App {
+
+/// Fixed pool of worker threads for data-parallel loops. The calling thread works along with the pool and only
+/// returns once the whole range is done, so jobs may reference its stack.
+class JobSystem {
+public:
+  /// `workerCount` 0 picks one worker per hardware thread, minus the calling one.
+  explicit JobSystem(unsigned int workerCount = 0);
+  ~JobSystem();
+
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  /// Calls `job(begin, end)` for consecutive ranges covering [0, count), each at least `grain` long except the last.
+  /// One loop runs at a time, concurrent callers wait for each other. The job is only referenced, never copied.
+  template <class F> void parallelFor(const std::size_t count, const std::size_t grain, F &&job) {
+    run(count, grain,
+        {const_cast<void *>(static_cast<const void *>(std::addressof(job))),
+         [](void *context, const std::size_t begin, const std::size_t end) {
+           (*static_cast<std::remove_reference_t<F> *>(context))(begin, end);
+         }});
+  }
+
+  [[nodiscard]] unsigned int getWorkerCount() const {
+    return static_cast<unsigned int>(m_workers.size());
+  }
+
+private:
+  /// Type erased reference to a caller's job, unlike std::function it never allocates.
+  struct Job {
+    void *context = nullptr;
+    void (*invoke)(void *context, std::size_t begin, std::size_t end) = nullptr;
+  };
+
+  struct Batch {
+    Job job;
+    std::size_t count = 0;
+    std::size_t grain = 1;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+  };
+
+  std::vector<std::jthread> m_workers;
+  std::mutex m_callerMutex; // Serializes parallelFor calls
+
+  std::mutex m_mutex;
+  std::condition_variable m_wakeWorkers;
+  std::condition_variable m_batchDone;
+  Batch m_batch;
+  uint64_t m_batchIndex = 0; // Bumped for every batch, so workers notice new work
+  int m_activeWorkers = 0;   // Working on the current batch, which stays untouched until they are done
+  bool m_stopping = false;
+
+  void run(std::size_t count, std::size_t grain, Job job);
+  void workerLoop();
+  void runRanges();
+};
+
+} // namespace App
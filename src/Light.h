@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <glm/glm.hpp>
 
 enum class LightType : uint32_t {
@@ -24,6 +28,30 @@ struct Light {
   float innerCutoff = glm::cos(glm::radians(12.5f));
   float outerCutoff = glm::cos(glm::radians(17.5f));
 
+  /// Share of its brightness below which a light counts as out of reach.
+  static constexpr float ATTENUATION_CUTOFF = 1.0f / 256.0f;
+
+  /// Distance at which the light fades below the cutoff, infinite for directional lights and lights that never fade.
+  [[nodiscard]] float range() const {
+    const float brightness = intensity * std::max({color.x, color.y, color.z});
+    // Attenuation is brightness / (constant + linear * d + quadratic * d^2), solved for the cutoff
+    const float reach = brightness / ATTENUATION_CUTOFF - constant;
+
+    if (type == LightType::Directional || (quadratic <= 0.0f && linear <= 0.0f)) {
+      return std::numeric_limits<float>::infinity();
+    }
+
+    if (reach <= 0.0f) {
+      return 0.0f;
+    }
+
+    if (quadratic <= 0.0f) {
+      return reach / linear;
+    }
+
+    return (-linear + std::sqrt(linear * linear + 4.0f * quadratic * reach)) / (2.0f * quadratic);
+  }
+
   [[nodiscard]] constexpr auto typeStr() const {
     switch (type) {
     case LightType::Directional:
@@ -1,5 +1,48 @@
 #include "Material.h"
 
+#include "Config.h"
+
+App::Shader &Material::getShader(const App::LightBucket lights) {
+  if (m_shader) {
+    return *m_shader;
+  }
+
+  std::shared_ptr<App::Shader> &variant = m_variants[static_cast<std::size_t>(lights)];
+
+  if (!variant) {
+    variant = App::ShaderVariant{.features = getShaderFeatures(), .lights = lights}.load(
+        App::Config::Renderer::DEFAULT_VERTEX_SHADER, App::Config::Renderer::DEFAULT_FRAGMENT_SHADER);
+  }
+
+  return *variant;
+}
+
+uint32_t Material::getShaderFeatures() const {
+  uint32_t features = 0;
+
+  if (m_diffuseTexture) {
+    features |= App::SHADER_DIFFUSE_MAP;
+  }
+
+  if (m_specularTexture) {
+    features |= App::SHADER_SPECULAR_MAP;
+  }
+
+  if (m_normalTexture) {
+    features |= App::SHADER_NORMAL_MAP;
+  }
+
+  if (m_vertexColors) {
+    features |= App::SHADER_VERTEX_COLOR;
+  }
+
+  if (App::Config::Core::DEBUG_MODE) {
+    features |= App::SHADER_DEBUG;
+  }
+
+  return features;
+}
+
 void Material::bindTextures() {
   if (m_diffuseTexture) {
     glActiveTexture(GL_TEXTURE0 + DIFFUSE_TEXTURE_INDEX);
@@ -22,16 +65,20 @@ void Material::bindTextures() {
   }
 }
 
-void Material::applyUniforms() const {
+void Material::applyUniforms(App::Shader &shader) const {
   for (auto const &[name, val] : m_floatUniforms) {
-    m_shader->set(name, val);
+    shader.set(name, val);
   }
 
   for (auto const &[name, val] : m_vec3Uniforms) {
-    m_shader->set(name, val);
+    shader.set(name, val);
+  }
+
+  for (auto const &[name, val] : m_vec4Uniforms) {
+    shader.set(name, val);
   }
 
   for (auto const &[name, val] : m_intUniforms) {
-    m_shader->set(name, val);
+    shader.set(name, val);
   }
 }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
 #include <memory>
 
 #include "Shader.h"
+#include "ShaderVariant.h"
+#include "StringHash.h"
 #include "Texture.h"
 
 enum TextureIndex {
@@ -48,23 +51,37 @@ constexpr auto TRANSPARENCY_FACTOR_UNIFORM_NAME = "uMaterial.transparencyFactor"
 
 class Material {
 public:
-  std::shared_ptr<App::Shader> getShader() {
-    return m_shader;
-  }
+  /// The shader set with `setShader`, otherwise the leanest variant of the default shaders that has the material's
+  /// features and loops over `lights`.
+  App::Shader &getShader(App::LightBucket lights = App::LightBucket::Many);
+
+  /// Shader features the material's data asks for: its textures, and vertex colors when its mesh has them.
+  [[nodiscard]] uint32_t getShaderFeatures() const;
 
   void bindTextures();
-  void applyUniforms() const;
+  void applyUniforms(App::Shader &shader) const;
 
+  /// Replaces the variants for every light bucket.
   void setShader(const std::shared_ptr<App::Shader> &shader) {
     m_shader = shader;
   }
 
+  void setVertexColors(const bool vertexColors) {
+    m_vertexColors = vertexColors;
+    m_variants = {};
+  }
+
   void setUniform(const std::string &name, const float value) {
     m_floatUniforms[name] = value;
   }
 
-  void setIntUniform(const std::string &name, const int value) {
-    m_intUniforms[name] = value;
+  /// Looked up before inserting, `bindTextures` sets its samplers through here every frame.
+  void setIntUniform(const std::string_view name, const int value) {
+    if (const auto uniform = m_intUniforms.find(name); uniform != m_intUniforms.end()) {
+      uniform->second = value;
+    } else {
+      m_intUniforms.emplace(name, value);
+    }
   }
 
   void setUniform(const std::string &name, const glm::vec3 &value) {
@@ -77,23 +94,28 @@ public:
 
   void setDiffuseTex(const std::shared_ptr<Texture> &diffuseTexture) {
     m_diffuseTexture = diffuseTexture;
+    m_variants = {};
   }
 
   void setSpecularTex(const std::shared_ptr<Texture> &specularTexture) {
     m_specularTexture = specularTexture;
+    m_variants = {};
   }
 
   void setNormalTex(const std::shared_ptr<Texture> &normalTexture) {
     m_normalTexture = normalTexture;
+    m_variants = {};
   }
 
 private:
   std::shared_ptr<App::Shader> m_shader;
+  std::array<std::shared_ptr<App::Shader>, App::LIGHT_BUCKET_COUNT> m_variants{}; // Looked up on first use
+  bool m_vertexColors = false;
   std::shared_ptr<Texture> m_diffuseTexture;
   std::shared_ptr<Texture> m_specularTexture;
   std::shared_ptr<Texture> m_normalTexture;
-  std::unordered_map<std::string, float> m_floatUniforms;
-  std::unordered_map<std::string, glm::vec3> m_vec3Uniforms;
-  std::unordered_map<std::string, glm::vec4> m_vec4Uniforms;
-  std::unordered_map<std::string, int> m_intUniforms;
+  StringMap<float> m_floatUniforms;
+  StringMap<glm::vec3> m_vec3Uniforms;
+  StringMap<glm::vec4> m_vec4Uniforms;
+  StringMap<int> m_intUniforms;
 };
@@ -0,0 +1,236 @@
+#include "MemoryAccounting.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+#include <glm/glm.hpp>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+#include "Config.h"
+
+namespace App {
+
+namespace {
+
+struct TagCounters {
+  std::atomic<std::size_t> bytes{0};
+  std::atomic<std::size_t> peakBytes{0};
+  std::atomic<std::size_t> allocations{0};
+};
+
+std::array<std::array<TagCounters, MEMORY_TAG_COUNT>, MEMORY_POOL_COUNT> g_counters;
+
+TagCounters &countersOf(const MemoryTag tag, const MemoryPool pool) {
+  return g_counters[static_cast<std::size_t>(pool)][static_cast<std::size_t>(tag)];
+}
+
+float mebibytes(const std::size_t bytes) {
+  return static_cast<float>(bytes) / (1024.0f * 1024.0f);
+}
+
+std::size_t budgetOf(const MemoryPool pool) {
+  return pool == MemoryPool::Cpu ? Config::Memory::CPU_BUDGET_BYTES : Config::Memory::GPU_BUDGET_BYTES;
+}
+
+const char *poolName(const MemoryPool pool) {
+  return pool == MemoryPool::Cpu ? "cpu" : "gpu";
+}
+
+} // namespace
+
+const char *memoryTagName(const MemoryTag tag) {
+  switch (tag) {
+  case MemoryTag::Meshes:
+    return "Meshes";
+  case MemoryTag::Textures:
+    return "Textures";
+  case MemoryTag::Terrain:
+    return "Terrain";
+  case MemoryTag::Lighting:
+    return "Lighting";
+  case MemoryTag::Shadows:
+    return "Shadows";
+  case MemoryTag::RenderTargets:
+    return "Render targets";
+  case MemoryTag::Streaming:
+    return "Streaming";
+  case MemoryTag::Frames:
+    return "Frames";
+  }
+
+  return "Unknown";
+}
+
+void TrackedMemory::set(const std::size_t bytes) {
+  if (bytes == m_bytes) {
+    return;
+  }
+
+  TagCounters &counters = countersOf(m_tag, m_pool);
+
+  if (m_bytes == 0) {
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  } else if (bytes == 0) {
+    counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  if (bytes < m_bytes) {
+    counters.bytes.fetch_sub(m_bytes - bytes, std::memory_order_relaxed);
+  } else {
+    const std::size_t total = counters.bytes.fetch_add(bytes - m_bytes, std::memory_order_relaxed) + bytes - m_bytes;
+    std::size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+
+    while (peak < total && !counters.peakBytes.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+    }
+  }
+
+  m_bytes = bytes;
+}
+
+namespace MemoryAccounting {
+
+MemoryUsage usage(const MemoryTag tag, const MemoryPool pool) {
+  const TagCounters &counters = countersOf(tag, pool);
+
+  return {
+      .bytes = counters.bytes.load(std::memory_order_relaxed),
+      .peakBytes = counters.peakBytes.load(std::memory_order_relaxed),
+      .allocations = counters.allocations.load(std::memory_order_relaxed),
+  };
+}
+
+std::size_t totalBytes(const MemoryPool pool) {
+  std::size_t total = 0;
+
+  for (std::size_t tag = 0; tag < MEMORY_TAG_COUNT; tag++) {
+    total += usage(static_cast<MemoryTag>(tag), pool).bytes;
+  }
+
+  return total;
+}
+
+std::size_t textureBytes(int width, int height, const std::size_t bytesPerTexel, const bool mipmapped,
+                         const int layers) {
+  std::size_t texels = 0;
+
+  while (true) {
+    texels += static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+
+    if (!mipmapped || (width == 1 && height == 1)) {
+      break;
+    }
+
+    width = glm::max(width / 2, 1);
+    height = glm::max(height / 2, 1);
+  }
+
+  return texels * bytesPerTexel * static_cast<std::size_t>(layers);
+}
+
+void renderPanel() {
+  ImGui::Begin("Memory", nullptr, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing);
+
+  for (const MemoryPool pool : {MemoryPool::Cpu, MemoryPool::Gpu}) {
+    const std::size_t total = totalBytes(pool);
+    const std::size_t budget = budgetOf(pool);
+    const float fraction = static_cast<float>(total) / static_cast<float>(budget);
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "%.1f / %.0f MiB", mebibytes(total), mebibytes(budget));
+
+    ImGui::PushStyleColor(ImGuiCol_PlotHistogram,
+                          fraction > 1.0f ? IM_COL32(220, 60, 60, 255) : IM_COL32(90, 160, 90, 255));
+    ImGui::ProgressBar(glm::min(fraction, 1.0f), ImVec2(240.0f, 0.0f), overlay);
+    ImGui::PopStyleColor();
+    ImGui::SameLine();
+    ImGui::TextUnformatted(pool == MemoryPool::Cpu ? "CPU" : "GPU");
+  }
+
+  if (ImGui::BeginTable("Subsystems", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+    ImGui::TableSetupColumn("MiB by subsystem");
+    ImGui::TableSetupColumn("CPU");
+    ImGui::TableSetupColumn("CPU peak");
+    ImGui::TableSetupColumn("GPU");
+    ImGui::TableSetupColumn("GPU peak");
+    ImGui::TableHeadersRow();
+
+    for (std::size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+      const auto tag = static_cast<MemoryTag>(i);
+      const MemoryUsage cpu = usage(tag, MemoryPool::Cpu);
+      const MemoryUsage gpu = usage(tag, MemoryPool::Gpu);
+
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(memoryTagName(tag));
+
+      if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("%zu CPU and %zu GPU allocations", cpu.allocations, gpu.allocations);
+      }
+
+      for (const float value :
+           {mebibytes(cpu.bytes), mebibytes(cpu.peakBytes), mebibytes(gpu.bytes), mebibytes(gpu.peakBytes)}) {
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f", value);
+      }
+    }
+
+    ImGui::EndTable();
+  }
+
+  if (ImGui::Button("Dump totals")) {
+    exportJson(Config::Memory::DUMP_FILE);
+  }
+
+  ImGui::SameLine();
+  ImGui::TextDisabled("(or F10)");
+
+  ImGui::End();
+}
+
+bool exportJson(const std::filesystem::path &path) {
+  std::ofstream out(path);
+
+  if (!out) {
+    SPDLOG_ERROR("Couldn't open {} for writing", path.string());
+    return false;
+  }
+
+  // Bytes throughout, tags keyed by name so dumps of different builds line up
+  out << "{\n";
+
+  for (const MemoryPool pool : {MemoryPool::Cpu, MemoryPool::Gpu}) {
+    out << "  \"" << poolName(pool) << R"(": {"bytes": )" << totalBytes(pool) << R"(, "budget_bytes": )"
+        << budgetOf(pool) << "},\n";
+  }
+
+  out << "  \"tags\": {";
+
+  for (std::size_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+    const auto tag = static_cast<MemoryTag>(i);
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << memoryTagName(tag) << "\": {";
+
+    for (const MemoryPool pool : {MemoryPool::Cpu, MemoryPool::Gpu}) {
+      const MemoryUsage poolUsage = usage(tag, pool);
+      out << (pool == MemoryPool::Cpu ? "" : ", ") << '"' << poolName(pool) << R"(": {"bytes": )" << poolUsage.bytes
+          << R"(, "peak_bytes": )" << poolUsage.peakBytes << R"(, "allocations": )" << poolUsage.allocations << '}';
+    }
+
+    out << '}';
+  }
+
+  out << "\n  }\n}\n";
+
+  if (!out) {
+    SPDLOG_ERROR("Couldn't write the memory totals to {}", path.string());
+    return false;
+  }
+
+  SPDLOG_INFO("Wrote the memory totals to {}", path.string());
+  return true;
+}
+
+} // namespace MemoryAccounting
+
+} // namespace App
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <utility>
+
+namespace App {
+
+/// Subsystem memory is charged to.
+enum class MemoryTag : uint8_t {
+  Meshes,        // Model geometry, plus its CPU copy when kept
+  Textures,      // Material textures
+  Terrain,       // Chunk blocks and the chunk mesh pool
+  Lighting,      // Light cluster buffers
+  Shadows,       // Shadow cascades
+  RenderTargets, // G-buffer, dynamic resolution and overdraw targets
+  Streaming,     // StreamBuffer rings
+  Frames,        // Frame packet arenas
+};
+
+constexpr std::size_t MEMORY_TAG_COUNT = 8;
+
+/// Where the bytes live. GPU bytes are the sizes of the stores asked of the driver, which may pad or compress them.
+enum class MemoryPool : uint8_t {
+  Cpu,
+  Gpu,
+};
+
+constexpr std::size_t MEMORY_POOL_COUNT = 2;
+
+[[nodiscard]] const char *memoryTagName(MemoryTag tag);
+
+struct MemoryUsage {
+  std::size_t bytes = 0;
+  std::size_t peakBytes = 0;
+  std::size_t allocations = 0; // Live objects holding any of the bytes
+};
+
+/// Bytes held by one object, charged to a subsystem for as long as the object lives. The owner sets the size
+/// whenever its storage changes, releasing it is left to the destructor. Totals are atomic, so objects may live on
+/// any thread, but a single one is only ever resized by the thread owning it.
+class TrackedMemory {
+public:
+  TrackedMemory(const MemoryTag tag, const MemoryPool pool) : m_tag(tag), m_pool(pool) {
+  }
+
+  ~TrackedMemory() {
+    set(0);
+  }
+
+  TrackedMemory(const TrackedMemory &) = delete;
+  TrackedMemory &operator=(const TrackedMemory &) = delete;
+
+  /// The bytes go along, still charged to the tag they were charged to.
+  TrackedMemory(TrackedMemory &&other) noexcept
+      : m_tag(other.m_tag), m_pool(other.m_pool), m_bytes(std::exchange(other.m_bytes, 0)) {
+  }
+
+  TrackedMemory &operator=(TrackedMemory &&other) noexcept {
+    if (this != &other) {
+      set(0);
+      m_tag = other.m_tag;
+      m_pool = other.m_pool;
+      m_bytes = std::exchange(other.m_bytes, 0);
+    }
+
+    return *this;
+  }
+
+  void set(std::size_t bytes);
+
+  [[nodiscard]] std::size_t bytes() const {
+    return m_bytes;
+  }
+
+private:
+  MemoryTag m_tag;
+  MemoryPool m_pool;
+  std::size_t m_bytes = 0;
+};
+
+/// Totals of every TrackedMemory, by subsystem, to fit the game into Config::Memory's budgets.
+namespace MemoryAccounting {
+
+[[nodiscard]] MemoryUsage usage(MemoryTag tag, MemoryPool pool);
+
+[[nodiscard]] std::size_t totalBytes(MemoryPool pool);
+
+/// Size of a texture's storage, with its whole mip chain when `mipmapped`.
+[[nodiscard]] std::size_t textureBytes(int width, int height, std::size_t bytesPerTexel, bool mipmapped = false,
+                                       int layers = 1);
+
+/// Draws the "Memory" window: usage and peak per subsystem, and the totals against the budgets.
+void renderPanel();
+
+/// Writes the totals as JSON. Returns false if the file could not be written.
+bool exportJson(const std::filesystem::path &path);
+
+} // namespace MemoryAccounting
+
+} // namespace App
@@ -7,6 +7,43 @@
   glEnableVertexAttribArray(name##AttrIndex);                                                                          \
   glVertexAttribPointer(name##AttrIndex, _size(name), glType, GL_FALSE, sizeof(Vertex), _offset(name))
 
+Mesh::~Mesh() {
+  if (m_VAO) {
+    glDeleteVertexArrays(1, &m_VAO);
+  }
+
+  if (m_VBO) {
+    glDeleteBuffers(1, &m_VBO);
+  }
+
+  if (m_EBO) {
+    glDeleteBuffers(1, &m_EBO);
+  }
+
+  if (m_positionVAO) {
+    glDeleteVertexArrays(1, &m_positionVAO);
+  }
+
+  if (m_positionVBO) {
+    glDeleteBuffers(1, &m_positionVBO);
+  }
+}
+
+AABB Mesh::computeBounds(const std::vector<Vertex> &vertices) {
+  if (vertices.empty()) {
+    return {glm::vec3(0.0f), glm::vec3(0.0f)};
+  }
+
+  AABB bounds{vertices.front().position, vertices.front().position};
+
+  for (const Vertex &vertex : vertices) {
+    bounds.min = glm::min(bounds.min, vertex.position);
+    bounds.max = glm::max(bounds.max, vertex.position);
+  }
+
+  return bounds;
+}
+
 void Mesh::setup() {
   glGenVertexArrays(1, &m_VAO);
   glGenBuffers(1, &m_VBO);
@@ -26,13 +63,116 @@ void Mesh::setup() {
   _bind(tangent, GL_FLOAT);
   _bind(bitangent, GL_FLOAT);
 
+  glGenVertexArrays(1, &m_positionVAO);
+  glGenBuffers(1, &m_positionVBO);
+
+  glBindVertexArray(m_positionVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, m_positionVBO);
+  uploadPositions(false);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+  glEnableVertexAttribArray(positionAttrIndex);
+  glVertexAttribPointer(positionAttrIndex, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+
   glBindVertexArray(0);
+
+  m_vertexCapacity = m_vertices.size();
+  m_indexCapacity = m_indices.size();
+  applyRetention();
+}
+
+void Mesh::update(std::vector<Vertex> vertices, std::vector<unsigned int> indices) {
+  m_vertices = std::move(vertices);
+  m_indices = std::move(indices);
+  m_indexCount = m_indices.size();
+  m_bounds = computeBounds(m_vertices);
+
+  if (!m_VAO) {
+    setup();
+    return;
+  }
+
+  // The element buffer binding is part of the VAO state
+  glBindVertexArray(m_VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+
+  const bool verticesFit = m_vertices.size() <= m_vertexCapacity;
+
+  if (verticesFit) {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(Vertex), m_vertices.data());
+  } else {
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
+    m_vertexCapacity = m_vertices.size();
+  }
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_positionVBO);
+  uploadPositions(verticesFit);
+
+  if (m_indices.size() <= m_indexCapacity) {
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_indices.size() * sizeof(unsigned int), m_indices.data());
+  } else {
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), m_indices.data(), GL_STATIC_DRAW);
+    m_indexCapacity = m_indices.size();
+  }
+
+  glBindVertexArray(0);
+  applyRetention();
 }
 
 void Mesh::render(const GLuint renderMode) const {
   glBindVertexArray(m_VAO);
-  glDrawElements(renderMode, static_cast<GLuint>(m_indices.size()), GL_UNSIGNED_INT, nullptr);
+  glDrawElements(renderMode, static_cast<GLuint>(m_indexCount), GL_UNSIGNED_INT, nullptr);
   glBindVertexArray(0);
+  countDraw(renderMode);
+}
+
+void Mesh::renderPositions(const GLuint renderMode) const {
+  glBindVertexArray(m_positionVAO);
+  glDrawElements(renderMode, static_cast<GLuint>(m_indexCount), GL_UNSIGNED_INT, nullptr);
+  glBindVertexArray(0);
+  countDraw(renderMode);
+}
+
+void Mesh::uploadPositions(const bool reuse) const {
+  std::vector<glm::vec3> positions;
+  positions.reserve(m_vertices.size());
+
+  for (const Vertex &vertex : m_vertices) {
+    positions.push_back(vertex.position);
+  }
+
+  // Same capacity as the vertex buffer, in positions
+  if (reuse) {
+    glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(glm::vec3), positions.data());
+  } else {
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+  }
+}
+
+void Mesh::countDraw(const GLuint renderMode) const {
+  DrawStats &stats = drawStats();
+  stats.drawCalls++;
+  stats.triangles += renderMode == GL_TRIANGLES ? m_indexCount / 3 : 0;
+}
+
+void Mesh::applyRetention() {
+  if (m_retention == MeshRetention::DropAfterUpload) {
+    // Swapped out rather than cleared, clear keeps the capacity
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
+  }
+
+  trackMemory();
+}
+
+void Mesh::trackMemory() {
+  m_cpuMemory.set(m_vertices.capacity() * sizeof(Vertex) + m_indices.capacity() * sizeof(unsigned int));
+  // The position stream is as long as the vertex buffer
+  m_gpuMemory.set(m_vertexCapacity * (sizeof(Vertex) + sizeof(glm::vec3)) + m_indexCapacity * sizeof(unsigned int));
+}
+
+DrawStats &Mesh::drawStats() {
+  static DrawStats stats;
+  return stats;
 }
 
 #undef _bind
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+#include "AABB.h"
+#include "MemoryAccounting.h"
+
 // 1 Single source of truth
 #define VERTEX_FIELDS(X)                                                                                               \
   X(glm::vec3, position)                                                                                               \
@@ -30,18 +34,85 @@ enum VertexAttributeIndex {
 
 #undef VERTEX_FIELDS
 
+/// Work submitted through Mesh::render, reset by whoever reads it.
+struct DrawStats {
+  std::size_t drawCalls = 0;
+  std::size_t triangles = 0;
+};
+
+/// What becomes of a mesh's vertices and indices once they are on the GPU.
+enum class MeshRetention : uint8_t {
+  Keep,            // Stay in RAM, for collision, picking or anything else reading the geometry back
+  DropAfterUpload, // Freed by every upload, only the count and the bounds are left
+};
+
 class Mesh {
 public:
-  Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices)
-      : m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_VAO(0), m_VBO(0), m_EBO(0) {
+  Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+       const MeshRetention retention = MeshRetention::Keep)
+      : m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_indexCount(m_indices.size()),
+        m_bounds(computeBounds(m_vertices)), m_retention(retention), m_VAO(0), m_VBO(0), m_EBO(0), m_positionVAO(0),
+        m_positionVBO(0) {
+    trackMemory();
   }
 
+  ~Mesh();
+
+  Mesh(const Mesh &) = delete;
+  Mesh &operator=(const Mesh &) = delete;
+
   void setup();
 
+  /// Replaces the geometry of an already set up mesh, reusing its buffers when the new data fits in them.
+  void update(std::vector<Vertex> vertices, std::vector<unsigned int> indices);
+
   void render(GLuint renderMode = GL_TRIANGLES) const;
 
+  /// Draws with only the positions bound, from their own tightly packed buffer. For depth only passes, which would
+  /// otherwise fetch whole vertices to use a sixth of them.
+  void renderPositions(GLuint renderMode = GL_TRIANGLES) const;
+
+  [[nodiscard]] std::size_t getIndexCount() const {
+    return m_indexCount;
+  }
+
+  [[nodiscard]] MeshRetention getRetention() const {
+    return m_retention;
+  }
+
+  /// The geometry as last given, empty once uploaded unless the mesh keeps it.
+  [[nodiscard]] const std::vector<Vertex> &getVertices() const {
+    return m_vertices;
+  }
+
+  [[nodiscard]] const std::vector<unsigned int> &getIndices() const {
+    return m_indices;
+  }
+
+  static DrawStats &drawStats();
+
+  /// Bounds of the vertex positions, in model space.
+  [[nodiscard]] const AABB &getBounds() const {
+    return m_bounds;
+  }
+
 private:
   std::vector<Vertex> m_vertices;
   std::vector<unsigned int> m_indices;
+  std::size_t m_indexCount;
+  AABB m_bounds;
+  MeshRetention m_retention;
   unsigned int m_VAO, m_VBO, m_EBO; // OpenGL handles
+  unsigned int m_positionVAO, m_positionVBO; // Position stream, sharing the element buffer
+  std::size_t m_vertexCapacity = 0, m_indexCapacity = 0; // Sizes of the buffer stores, in elements
+  App::TrackedMemory m_cpuMemory{App::MemoryTag::Meshes, App::MemoryPool::Cpu};
+  App::TrackedMemory m_gpuMemory{App::MemoryTag::Meshes, App::MemoryPool::Gpu};
+
+  static AABB computeBounds(const std::vector<Vertex> &vertices);
+  /// Copies the positions into the position stream, `reuse` when its store is large enough already.
+  void uploadPositions(bool reuse) const;
+  void countDraw(GLuint renderMode) const;
+  /// Frees the CPU copy if the mesh doesn't keep it, once the buffers have it.
+  void applyRetention();
+  void trackMemory();
 };
@@ -2,6 +2,8 @@
 
 #include <spdlog/spdlog.h>
 
+#include "ClusteredLighting.h"
+
 void Model::setup() {
   for (const auto &[mesh, material] : m_meshGroups) {
     if (mesh) {
@@ -17,7 +19,7 @@ void Model::render(const RenderContext &ctx) {
       continue;
     }
 
-    const std::shared_ptr<App::Shader> shader = ctx.customShader.value_or(material->getShader());
+    App::Shader *shader = ctx.customShader ? ctx.customShader : &material->getShader(ctx.lightBucket);
 
     shader->use();
 
@@ -25,39 +27,27 @@ void Model::render(const RenderContext &ctx) {
     shader->set("uProjection", ctx.projectionMatrix);
     shader->set("uView", ctx.viewMatrix);
     shader->set("uModel", ctx.modelMatrix);
+    shader->set("uModelViewProjection", ctx.projectionMatrix * ctx.viewMatrix * ctx.modelMatrix);
+    shader->set("uNormalMatrix", normalMatrix(ctx.modelMatrix));
 
     shader->set("uWorld.viewPosition", ctx.cameraPosition);
 
-    shader->set("uWorld.lightSourceCount", ctx.lights.size());
-
-    for (unsigned int i = 0; i < ctx.lights.size(); ++i) {
-      shader->set(std::format("uWorld.lights[{}].color", i), ctx.lights[i].color);
-      shader->set(std::format("uWorld.lights[{}].intensity", i), ctx.lights[i].intensity);
-      shader->set(std::format("uWorld.lights[{}].position", i), ctx.lights[i].position);
-      shader->set(std::format("uWorld.lights[{}].direction", i), ctx.lights[i].direction);
-      shader->set(std::format("uWorld.lights[{}].constant", i), ctx.lights[i].constant);
-      shader->set(std::format("uWorld.lights[{}].linear", i), ctx.lights[i].linear);
-      shader->set(std::format("uWorld.lights[{}].quadratic", i), ctx.lights[i].quadratic);
-      shader->set(std::format("uWorld.lights[{}].innerCutoff", i), ctx.lights[i].innerCutoff);
-      shader->set(std::format("uWorld.lights[{}].outerCutoff", i), ctx.lights[i].outerCutoff);
-
-      // TODO: use actual light values
-      // shader->set(std::format("uWorld.lights[{}].ambientColor", i), glm::vec4(0.2f, 0.2f, 0.2f, 1.0f));
-      // shader->set(std::format("uWorld.lights[{}].diffuseColor", i), glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
-      // shader->set(std::format("uWorld.lights[{}].specularColor", i), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    if (ctx.lighting) {
+      ctx.lighting->bind(*shader);
     }
 
-    // 2. Set Material-Specific Uniforms (Colors, Shininess, etc.)
-    material->applyUniforms();
-
-    // 3. Bind Textures
+    // 2. Bind Textures, which sets their samplers
     material->bindTextures();
 
+    // 3. Set Material-Specific Uniforms (Colors, Shininess, etc.)
+    material->applyUniforms(*shader);
+
     // 4. Draw
     mesh->render(ctx.renderMode);
   }
 }
 
 void Model::addMeshGroup(const std::shared_ptr<Mesh> &mesh, const std::shared_ptr<Material> &material) {
+  m_bounds = m_meshGroups.empty() ? mesh->getBounds() : m_bounds.merged(mesh->getBounds());
   m_meshGroups.push_back({mesh, material});
 }
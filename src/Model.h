@@ -1,7 +1,7 @@
 #pragma once
 
-#include <vector>
 #include <memory>
+#include <vector>
 
 #include "Material.h"
 #include "Renderable.h"
@@ -9,15 +9,25 @@
 
 class Model : public Renderable {
 public:
-  void setup() override;
-  void render(const RenderContext &ctx) override;
-  void addMeshGroup(const std::shared_ptr<Mesh> &mesh, const std::shared_ptr<Material> &material);
-
-private:
   struct MeshGroup {
     std::shared_ptr<Mesh> mesh;
     std::shared_ptr<Material> material;
   };
 
+  void setup() override;
+  void render(const RenderContext &ctx) override;
+  void addMeshGroup(const std::shared_ptr<Mesh> &mesh, const std::shared_ptr<Material> &material);
+
+  [[nodiscard]] const std::vector<MeshGroup> &getMeshGroups() const {
+    return m_meshGroups;
+  }
+
+  /// Bounds of all meshes, in model space.
+  [[nodiscard]] const AABB &getBounds() const {
+    return m_bounds;
+  }
+
+private:
   std::vector<MeshGroup> m_meshGroups;
+  AABB m_bounds{glm::vec3(0.0f), glm::vec3(0.0f)};
 };
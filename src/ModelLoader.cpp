@@ -6,7 +6,7 @@
 
 #include "Container.h"
 
-std::shared_ptr<Model> ModelLoader::Load(const std::string &path) {
+std::shared_ptr<Model> ModelLoader::Load(const std::string &path, const MeshRetention retention) {
   Assimp::Importer importer;
 
   // Load with common optimizations: Triangulate, Flip UVs, and calculate Tangents
@@ -22,7 +22,7 @@ std::shared_ptr<Model> ModelLoader::Load(const std::string &path) {
   const std::string directory = path.substr(0, path.find_last_of('/'));
   auto model = std::make_shared<Model>();
 
-  processNode(scene->mRootNode, scene, model, directory);
+  processNode(scene->mRootNode, scene, model, directory, retention);
 
   // Finalize the model by setting up GPU buffers for all meshes
   model->setup(); // Calls Mesh::setup() for all internal meshes
@@ -30,14 +30,14 @@ std::shared_ptr<Model> ModelLoader::Load(const std::string &path) {
 }
 
 void ModelLoader::processNode(const aiNode *node, const aiScene *scene, std::shared_ptr<Model> model,
-                              const std::string &directory) {
+                              const std::string &directory, const MeshRetention retention) {
   // 1. Process all the meshes attached to this specific node
   for (unsigned int i = 0; i < node->mNumMeshes; i++) {
     // node->mMeshes contains indices to the actual meshes in the scene object
     aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
 
     // Convert Assimp mesh to your Mesh class
-    auto myMesh = processMesh(mesh, scene);
+    auto myMesh = processMesh(mesh, scene, retention);
 
     // Get the material for this mesh
     auto myMaterial = std::make_shared<Material>();
@@ -46,6 +46,7 @@ void ModelLoader::processNode(const aiNode *node, const aiScene *scene, std::sha
     // So there's no need to check if mesh->mMaterialIndex is valid because it will always exist
     const aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
     myMaterial = loadMaterial(material, directory);
+    myMaterial->setVertexColors(mesh->mColors[0] != nullptr);
 
     // Add the pair to your Model's meshGroups
     // Note: You may need a public method like model->addMeshGroup(mesh, material)
@@ -54,11 +55,11 @@ void ModelLoader::processNode(const aiNode *node, const aiScene *scene, std::sha
 
   // 2. Recursively process each of this node's children
   for (unsigned int i = 0; i < node->mNumChildren; i++) {
-    processNode(node->mChildren[i], scene, model, directory);
+    processNode(node->mChildren[i], scene, model, directory, retention);
   }
 }
 
-std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene) {
+std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene, const MeshRetention retention) {
   std::vector<Vertex> vertices;
   std::vector<unsigned int> indices;
 
@@ -102,17 +103,13 @@ std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh *mesh, const aiScene *scen
   }
 
   // You'll need to update your Mesh.h to accept data in a constructor or setter
-  return std::make_shared<Mesh>(vertices, indices);
+  return std::make_shared<Mesh>(std::move(vertices), std::move(indices), retention);
 }
 
 std::shared_ptr<Material> ModelLoader::loadMaterial(const aiMaterial *mat, const std::string &directory) {
   auto material = std::make_shared<Material>();
 
-  // TODO: find a better way to decide which is the proper shader for current material.
-  //       Using a default material for now (standard.vert, standard.frag)
-  material->setShader(
-      g_shaderCache.get(App::Config::Renderer::DEFAULT_VERTEX_SHADER, App::Config::Renderer::DEFAULT_FRAGMENT_SHADER));
-
+  // No shader is set, the material picks the variant of the default shaders that fits the textures loaded below
   // Pre-populate with safe defaults
   material->setUniform(DIFFUSE_COLOR_UNIFORM_NAME, glm::vec4(1.0f));
   material->setUniform(SPECULAR_COLOR_UNIFORM_NAME, glm::vec4(1.0f));
@@ -13,15 +13,18 @@
 
 class ModelLoader {
 public:
-  static std::shared_ptr<Model> Load(const std::string &path);
+  // Models are only drawn by default, pass MeshRetention::Keep for the ones collision or picking reads back
+  static std::shared_ptr<Model> Load(const std::string &path,
+                                     MeshRetention retention = MeshRetention::DropAfterUpload);
+
+  // Helper to convert Assimp mesh to your Mesh class. CPU only, the GPU buffers are created by Mesh::setup
+  static std::shared_ptr<Mesh> processMesh(aiMesh *mesh, const aiScene *scene,
+                                           MeshRetention retention = MeshRetention::DropAfterUpload);
 
 private:
   // Helper to process Assimp nodes recursively
   static void processNode(const aiNode *node, const aiScene *scene, std::shared_ptr<Model> model,
-                          const std::string &directory);
-
-  // Helper to convert Assimp mesh to your Mesh class
-  static std::shared_ptr<Mesh> processMesh(aiMesh *mesh, const aiScene *scene);
+                          const std::string &directory, MeshRetention retention);
 
   // Helper to load materials and textures
   static std::shared_ptr<Material> loadMaterial(const aiMaterial *mat, const std::string &directory);
@@ -0,0 +1,293 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "Simd.h"
+
+namespace App {
+
+static_assert(OcclusionCuller::WIDTH % 4 == 0, "Rows are rasterized four pixels at a time");
+static_assert(OcclusionCuller::TILE_SIZE % 4 == 0, "Tiles are reduced four pixels at a time");
+
+// Corners of a box are numbered by their max-side bits: x in bit 0, y in bit 1, z in bit 2
+constexpr std::array<std::array<int, 4>, 6> BOX_FACES = {{
+    {0, 4, 6, 2}, // NegX
+    {1, 3, 7, 5}, // PosX
+    {0, 1, 5, 4}, // NegY
+    {2, 6, 7, 3}, // PosY
+    {0, 2, 3, 1}, // NegZ
+    {4, 5, 7, 6}, // PosZ
+}};
+
+// Anything this close to the eye plane is treated as crossing it
+constexpr float MIN_CLIP_W = 1e-4f;
+
+// Slack on depth comparisons, keeps coplanar occluders from hiding the surfaces they were built from
+constexpr float DEPTH_EPSILON = 1e-5f;
+
+static std::array<glm::vec4, 8> boxCorners(const AABB &box, const glm::mat4 &transform) {
+  std::array<glm::vec4, 8> corners;
+
+  for (int i = 0; i < 8; i++) {
+    const glm::vec3 corner(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y,
+                           i & 4 ? box.max.z : box.min.z);
+    corners[i] = transform * glm::vec4(corner, 1.0f);
+  }
+
+  return corners;
+}
+
+static glm::vec3 toWindow(const glm::vec4 &clip) {
+  const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+  return {(ndc.x * 0.5f + 0.5f) * static_cast<float>(OcclusionCuller::WIDTH),
+          (ndc.y * 0.5f + 0.5f) * static_cast<float>(OcclusionCuller::HEIGHT), ndc.z * 0.5f + 0.5f};
+}
+
+OcclusionCuller::OcclusionCuller()
+    : m_depth(static_cast<std::size_t>(WIDTH * HEIGHT), 1.0f),
+      m_tileMaxDepth(static_cast<std::size_t>(TILES_X * TILES_Y), 1.0f) {
+}
+
+void OcclusionCuller::beginFrame(const glm::mat4 &viewProjection) {
+  m_viewProjection = viewProjection;
+  m_stats = {};
+
+  std::ranges::fill(m_depth, 1.0f);
+  std::ranges::fill(m_tileMaxDepth, 1.0f);
+  m_hierarchyDirty = false;
+}
+
+void OcclusionCuller::addOccluder(const AABB &box) {
+  const std::array<glm::vec4, 8> corners = boxCorners(box, m_viewProjection);
+
+  // Whole faces rather than triangle pairs, pixels along the diagonal would be fully covered by neither half
+  for (const std::array<int, 4> &face : BOX_FACES) {
+    const std::array<glm::vec4, 4> quad = {corners[face[0]], corners[face[1]], corners[face[2]], corners[face[3]]};
+    rasterizePolygon(quad);
+  }
+}
+
+void OcclusionCuller::addOccluder(const std::span<const glm::vec3> triangles, const glm::mat4 &modelMatrix) {
+  const glm::mat4 transform = m_viewProjection * modelMatrix;
+
+  for (std::size_t i = 0; i + 2 < triangles.size(); i += 3) {
+    const std::array<glm::vec4, 3> triangle = {transform * glm::vec4(triangles[i], 1.0f),
+                                               transform * glm::vec4(triangles[i + 1], 1.0f),
+                                               transform * glm::vec4(triangles[i + 2], 1.0f)};
+    rasterizePolygon(triangle);
+  }
+}
+
+void OcclusionCuller::rasterizePolygon(const std::span<const glm::vec4> clip) {
+  // Near plane clipping is not worth it for occluders, dropping the polygon only makes the buffer less complete
+  if (std::ranges::any_of(clip, [](const glm::vec4 &vertex) { return vertex.w < MIN_CLIP_W; })) {
+    return;
+  }
+
+  std::array<glm::vec3, MAX_POLYGON_VERTICES> window;
+  const auto count = static_cast<int>(clip.size());
+  float area = 0.0f;
+
+  for (int i = 0; i < count; i++) {
+    window[i] = toWindow(clip[i]);
+  }
+
+  for (int i = 0; i < count; i++) {
+    const glm::vec3 &from = window[i];
+    const glm::vec3 &to = window[(i + 1) % count];
+    area += from.x * to.y - to.x * from.y;
+  }
+
+  // Back faces and slivers are skipped, a closed occluder is fully covered by its front faces
+  if (area <= 0.0f) {
+    return;
+  }
+
+  glm::vec2 minWindow(window[0]);
+  glm::vec2 maxWindow(window[0]);
+
+  for (int i = 1; i < count; i++) {
+    minWindow = glm::min(minWindow, glm::vec2(window[i]));
+    maxWindow = glm::max(maxWindow, glm::vec2(window[i]));
+  }
+
+  const int minX = std::max(static_cast<int>(std::floor(minWindow.x)), 0) & ~3;
+  const int maxX = std::min(static_cast<int>(std::ceil(maxWindow.x)), WIDTH - 1);
+  const int minY = std::max(static_cast<int>(std::floor(minWindow.y)), 0);
+  const int maxY = std::min(static_cast<int>(std::ceil(maxWindow.y)), HEIGHT - 1);
+
+  if (minX > maxX || minY > maxY) {
+    return;
+  }
+
+  m_stats.occluderTriangles += count - 2;
+  m_hierarchyDirty = true;
+
+  // Edge functions as e(x, y) = stepX * x + stepY * y + offset, positive on the inner side of each edge
+  struct Edge {
+    float stepX, stepY, offset;
+  };
+
+  auto makeEdge = [](const glm::vec3 &from, const glm::vec3 &to) {
+    const float stepX = from.y - to.y;
+    const float stepY = to.x - from.x;
+    return Edge{stepX, stepY, -(stepX * from.x + stepY * from.y)};
+  };
+
+  std::array<Edge, MAX_POLYGON_VERTICES> edges;
+
+  for (int i = 0; i < count; i++) {
+    edges[i] = makeEdge(window[i], window[(i + 1) % count]);
+  }
+
+  // The polygon is planar, so its depth is a plane in window space. It is fitted through the first three vertices
+  // with the barycentric weights their edges provide.
+  const Edge edgeBC = makeEdge(window[1], window[2]);
+  const Edge edgeCA = makeEdge(window[2], window[0]);
+  const Edge &edgeAB = edges[0];
+  const float triangleArea = edgeBC.stepX * window[0].x + edgeBC.stepY * window[0].y + edgeBC.offset;
+
+  if (triangleArea <= 0.0f) {
+    return;
+  }
+
+  auto interpolate = [&](const float bc, const float ca, const float ab) {
+    return (bc * window[0].z + ca * window[1].z + ab * window[2].z) / triangleArea;
+  };
+
+  const float depthStepX = interpolate(edgeBC.stepX, edgeCA.stepX, edgeAB.stepX);
+  const float depthStepY = interpolate(edgeBC.stepY, edgeCA.stepY, edgeAB.stepY);
+
+  // Only pixels covered entirely are written, with the furthest depth the polygon reaches inside them. A box
+  // touching any part of a pixel can then be compared against it without leaking through partial coverage.
+  const float depthOffset = interpolate(edgeBC.offset, edgeCA.offset, edgeAB.offset) +
+                            0.5f * (std::abs(depthStepX) + std::abs(depthStepY));
+
+  for (int i = 0; i < count; i++) {
+    edges[i].offset -= 0.5f * (std::abs(edges[i].stepX) + std::abs(edges[i].stepY));
+  }
+
+  const Simd::Float4 zero(0.0f);
+  const Simd::Float4 laneOffsets(0.5f, 1.5f, 2.5f, 3.5f); // Pixel centers
+
+  for (int y = minY; y <= maxY; y++) {
+    const float centerY = static_cast<float>(y) + 0.5f;
+    float *row = m_depth.data() + static_cast<std::ptrdiff_t>(y) * WIDTH;
+
+    for (int x = minX; x <= maxX; x += 4) {
+      const Simd::Float4 centerX = Simd::Float4(static_cast<float>(x)) + laneOffsets;
+      auto insideEdge = [&](const Edge &edge) {
+        return greaterEqual(Simd::Float4(edge.stepX) * centerX + Simd::Float4(edge.stepY * centerY + edge.offset),
+                            zero);
+      };
+
+      Simd::Float4 inside = insideEdge(edges[0]);
+
+      for (int i = 1; i < count; i++) {
+        inside = inside & insideEdge(edges[i]);
+      }
+
+      if (inside.maskBits() == 0) {
+        continue;
+      }
+
+      const Simd::Float4 depth =
+          Simd::Float4(depthStepX) * centerX + Simd::Float4(depthStepY * centerY + depthOffset);
+      const Simd::Float4 stored = Simd::Float4::load(row + x);
+      select(inside, min(stored, depth), stored).store(row + x);
+    }
+  }
+}
+
+void OcclusionCuller::buildHierarchy() {
+  for (int tileY = 0; tileY < TILES_Y; tileY++) {
+    for (int tileX = 0; tileX < TILES_X; tileX++) {
+      Simd::Float4 furthest(0.0f);
+
+      for (int y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; y++) {
+        const float *row = m_depth.data() + static_cast<std::ptrdiff_t>(y) * WIDTH + tileX * TILE_SIZE;
+
+        for (int x = 0; x < TILE_SIZE; x += 4) {
+          furthest = max(furthest, Simd::Float4::load(row + x));
+        }
+      }
+
+      m_tileMaxDepth[tileY * TILES_X + tileX] = furthest.horizontalMax();
+    }
+  }
+
+  m_hierarchyDirty = false;
+}
+
+bool OcclusionCuller::isVisible(const AABB &box) {
+  if (!m_enabled) {
+    return true;
+  }
+
+  m_stats.testedBoxes++;
+
+  if (m_stats.occluderTriangles == 0) {
+    return true;
+  }
+
+  if (m_hierarchyDirty) {
+    buildHierarchy();
+  }
+
+  glm::vec3 minWindow(std::numeric_limits<float>::max());
+  glm::vec3 maxWindow(std::numeric_limits<float>::lowest());
+
+  for (const glm::vec4 &corner : boxCorners(box, m_viewProjection)) {
+    // Boxes reaching behind the eye cover an unbounded part of the screen, leave those to the frustum test
+    if (corner.w < MIN_CLIP_W) {
+      return true;
+    }
+
+    const glm::vec3 window = toWindow(corner);
+    minWindow = glm::min(minWindow, window);
+    maxWindow = glm::max(maxWindow, window);
+  }
+
+  const int minX = std::max(static_cast<int>(std::floor(minWindow.x)), 0);
+  const int maxX = std::min(static_cast<int>(std::ceil(maxWindow.x)), WIDTH - 1);
+  const int minY = std::max(static_cast<int>(std::floor(minWindow.y)), 0);
+  const int maxY = std::min(static_cast<int>(std::ceil(maxWindow.y)), HEIGHT - 1);
+
+  if (minX > maxX || minY > maxY) {
+    return true;
+  }
+
+  const float nearestDepth = minWindow.z - DEPTH_EPSILON;
+
+  for (int tileY = minY / TILE_SIZE; tileY <= maxY / TILE_SIZE; tileY++) {
+    for (int tileX = minX / TILE_SIZE; tileX <= maxX / TILE_SIZE; tileX++) {
+      // Fully behind the furthest occluder of the tile, no need to look at its pixels
+      if (nearestDepth >= m_tileMaxDepth[tileY * TILES_X + tileX]) {
+        continue;
+      }
+
+      const int fromX = std::max(minX, tileX * TILE_SIZE);
+      const int toX = std::min(maxX, (tileX + 1) * TILE_SIZE - 1);
+      const int fromY = std::max(minY, tileY * TILE_SIZE);
+      const int toY = std::min(maxY, (tileY + 1) * TILE_SIZE - 1);
+
+      for (int y = fromY; y <= toY; y++) {
+        const float *row = m_depth.data() + static_cast<std::ptrdiff_t>(y) * WIDTH;
+
+        for (int x = fromX; x <= toX; x++) {
+          if (nearestDepth < row[x]) {
+            return true;
+          }
+        }
+      }
+    }
+  }
+
+  m_stats.occludedBoxes++;
+  return false;
+}
+
+} // namespace App
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AABB.h"
+
+namespace App {
+
+struct OcclusionStats {
+  std::size_t occluderTriangles = 0;
+  std::size_t testedBoxes = 0;
+  std::size_t occludedBoxes = 0;
+};
+
+/// CPU occlusion culling: occluders are rasterized into a small depth buffer, which is then reduced into a
+/// conservative per-tile max depth (hierarchical Z). Boxes that are behind the occluders everywhere they cover on
+/// screen are reported as hidden. Runs entirely on the CPU, so it never waits on the GPU and works headless.
+class OcclusionCuller {
+public:
+  static constexpr int WIDTH = 256;
+  static constexpr int HEIGHT = 128;
+  static constexpr int TILE_SIZE = 8;
+  static constexpr int TILES_X = WIDTH / TILE_SIZE;
+  static constexpr int TILES_Y = HEIGHT / TILE_SIZE;
+
+  OcclusionCuller();
+
+  /// Clears the depth buffer, occluders and tests of this frame use the given camera.
+  void beginFrame(const glm::mat4 &viewProjection);
+
+  /// Solid box, everything inside it must be opaque.
+  void addOccluder(const AABB &box);
+
+  /// Closed, counter-clockwise wound triangle list in model space.
+  void addOccluder(std::span<const glm::vec3> triangles, const glm::mat4 &modelMatrix);
+
+  [[nodiscard]] bool isVisible(const AABB &box);
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+  }
+
+  [[nodiscard]] const OcclusionStats &getStats() const {
+    return m_stats;
+  }
+
+private:
+  glm::mat4 m_viewProjection{1.0f};
+  std::vector<float> m_depth;        // Window space depth in [0, 1], 1 being the far plane
+  std::vector<float> m_tileMaxDepth; // Furthest depth of each tile, any box nearer than it may be visible
+  bool m_hierarchyDirty = false;
+  bool m_enabled = true;
+  OcclusionStats m_stats;
+
+  static constexpr int MAX_POLYGON_VERTICES = 4;
+
+  /// Convex, planar polygon of up to MAX_POLYGON_VERTICES clip space vertices.
+  void rasterizePolygon(std::span<const glm::vec4> clip);
+  void buildHierarchy();
+};
+
+} // namespace App
@@ -0,0 +1,154 @@
+#include "OverdrawHeatmap.h"
+
+#include <algorithm>
+#include <bit>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+
+#include "Mesh.h"
+#include "Profiler.h"
+
+namespace App {
+
+OverdrawHeatmap::~OverdrawHeatmap() {
+  releaseTargets();
+}
+
+void OverdrawHeatmap::setup() {
+  // Same transform as the pre-pass, so counting behind it sees exactly the depths it wrote
+  m_countShader = std::make_unique<Shader>("depth_prepass.vert", "overdraw_count.frag");
+  m_heatmapShader = std::make_unique<Shader>("fullscreen_triangle.vert", "overdraw_heatmap.frag");
+  m_fullScreenTriangle = std::make_unique<DummyVAO>();
+
+  m_heatmapShader->use();
+  m_heatmapShader->set("uCounts", 0);
+}
+
+void OverdrawHeatmap::render(const std::span<const ChunkDraw> chunks, const std::span<const Ecs::MeshDraw> meshes,
+                             const RenderContext &ctx, const DepthPrepass *prepass, const glm::ivec2 size) {
+  PROFILE_SCOPE("OverdrawHeatmap::render");
+
+  if (size.x <= 0 || size.y <= 0) {
+    return;
+  }
+
+  GLint target = 0;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+
+  if (size != m_size) {
+    resize(size);
+  }
+
+  constexpr GLfloat noCounts[] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glClearBufferfv(GL_COLOR, 0, noCounts);
+  glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+  glBlendFunc(GL_ONE, GL_ONE);
+
+  m_countShader->use();
+  const glm::mat4 viewProjection = ctx.projectionMatrix * ctx.viewMatrix;
+
+  // Terrain first with its culling, as World::draw does it
+  glEnable(GL_CULL_FACE);
+
+  for (const auto &[mesh, coord] : chunks) {
+    m_countShader->set("uModelViewProjection", glm::translate(viewProjection, glm::vec3(coord * Chunk::SIZE)));
+    mesh->renderPositions();
+  }
+
+  glDisable(GL_CULL_FACE);
+
+  // Then the forward entities, counting only what passes the equal test when the pre-pass goes first
+  if (prepass) {
+    prepass->render(meshes, ctx);
+    DepthPrepass::beginEqualDepth();
+    m_countShader->use();
+  }
+
+  for (const Ecs::MeshDraw &draw : meshes) {
+    m_countShader->set("uModelViewProjection", draw.modelViewProjection);
+    draw.mesh->renderPositions(draw.renderMode);
+  }
+
+  if (prepass) {
+    DepthPrepass::endEqualDepth();
+  }
+
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  readAverage();
+
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(target));
+  glDisable(GL_DEPTH_TEST);
+  glBindTexture(GL_TEXTURE_2D, m_counts);
+
+  m_heatmapShader->use();
+  m_fullScreenTriangle->render();
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glEnable(GL_DEPTH_TEST);
+}
+
+void OverdrawHeatmap::readAverage() {
+  // Each level averages the one below, so the last one holds the mean of the whole buffer. Only close to it for sizes
+  // that are not powers of two, the box filter drops the odd rows and columns
+  const int lastLevel = std::bit_width(static_cast<unsigned>(std::max(m_size.x, m_size.y))) - 1;
+
+  glBindTexture(GL_TEXTURE_2D, m_counts);
+  glGenerateMipmap(GL_TEXTURE_2D);
+  glGetTexImage(GL_TEXTURE_2D, lastLevel, GL_RED, GL_FLOAT, &m_averageOverdraw);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void OverdrawHeatmap::resize(const glm::ivec2 size) {
+  releaseTargets();
+
+  // Half floats count exactly up to 2048 fragments per pixel and blend everywhere
+  glGenTextures(1, &m_counts);
+  glBindTexture(GL_TEXTURE_2D, m_counts);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, size.x, size.y, 0, GL_RED, GL_FLOAT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glGenRenderbuffers(1, &m_depth);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_depth);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.x, size.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_counts, 0);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    SPDLOG_ERROR("Overdraw framebuffer is incomplete");
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  m_size = size;
+  // Counts are mipmapped down to their average, the depth is not
+  m_gpuMemory.set(MemoryAccounting::textureBytes(size.x, size.y, 2, true) +
+                  MemoryAccounting::textureBytes(size.x, size.y, 4));
+}
+
+void OverdrawHeatmap::releaseTargets() {
+  if (m_framebuffer) {
+    glDeleteFramebuffers(1, &m_framebuffer);
+  }
+
+  if (m_counts) {
+    glDeleteTextures(1, &m_counts);
+  }
+
+  if (m_depth) {
+    glDeleteRenderbuffers(1, &m_depth);
+  }
+
+  m_framebuffer = m_counts = m_depth = 0;
+  m_size = glm::ivec2(0);
+  m_gpuMemory.set(0);
+}
+
+} // namespace App
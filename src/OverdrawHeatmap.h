@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "DepthPrepass.h"
+#include "DummyVAO.h"
+#include "EcsSystems.h"
+#include "MemoryAccounting.h"
+#include "Renderable.h"
+#include "Shader.h"
+#include "World.h"
+
+namespace App {
+
+/// Debug view of overdraw: replays the forward passes with a shader that adds one per fragment into a counter buffer,
+/// under the same depth state they would have, then shows the counts as a heatmap in place of the frame. Turning the
+/// depth pre-pass on and off under it shows what the pre-pass saves in the current scene.
+class OverdrawHeatmap {
+public:
+  OverdrawHeatmap() = default;
+  ~OverdrawHeatmap();
+
+  OverdrawHeatmap(const OverdrawHeatmap &) = delete;
+  OverdrawHeatmap &operator=(const OverdrawHeatmap &) = delete;
+
+  /// Compiles the counting and heatmap shaders, needs a current OpenGL context.
+  void setup();
+
+  /// Counts the fragments terrain and entities shade, the entities behind `prepass` when given, and draws the heatmap
+  /// into the framebuffer bound when called. The counter buffer follows `size`.
+  void render(std::span<const ChunkDraw> chunks, std::span<const Ecs::MeshDraw> meshes, const RenderContext &ctx,
+              const DepthPrepass *prepass, glm::ivec2 size);
+
+  /// Fragments shaded per pixel of the last frame drawn, averaged over the whole screen.
+  [[nodiscard]] float getAverageOverdraw() const {
+    return m_averageOverdraw;
+  }
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+  }
+
+private:
+  bool m_enabled = false;
+  float m_averageOverdraw = 0.0f;
+
+  GLuint m_framebuffer = 0;
+  GLuint m_counts = 0;
+  GLuint m_depth = 0;
+  glm::ivec2 m_size{0};
+  TrackedMemory m_gpuMemory{MemoryTag::RenderTargets, MemoryPool::Gpu};
+
+  std::unique_ptr<Shader> m_countShader;
+  std::unique_ptr<Shader> m_heatmapShader;
+  std::unique_ptr<DummyVAO> m_fullScreenTriangle;
+
+  void resize(glm::ivec2 size);
+  void releaseTargets();
+  /// Reads the average back from the smallest mip level of the counts. Stalls until the GPU is done, which only
+  /// this debug view pays for.
+  void readAverage();
+};
+
+} // namespace App
@@ -0,0 +1,433 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+#include "Container.h"
+
+namespace App {
+
+using namespace Config::Profiler;
+
+namespace {
+
+/// Zones of one thread. Only the owning thread opens and closes zones, the profiler collects the closed ones once
+/// per frame.
+struct ThreadBuffer {
+  uint32_t index = 0;
+  std::string name;
+  std::vector<CpuZone> openZones;
+
+  std::mutex mutex; // Guards the members below
+  std::vector<CpuZone> closedZones;
+};
+
+std::mutex threadRegistryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> threadRegistry;
+
+ThreadBuffer &currentThreadBuffer() {
+  thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto created = std::make_shared<ThreadBuffer>();
+    const std::scoped_lock lock(threadRegistryMutex);
+    created->index = static_cast<uint32_t>(threadRegistry.size());
+    created->name = created->index == 0 ? "Main" : "Thread " + std::to_string(created->index);
+    threadRegistry.push_back(created);
+    return created;
+  }();
+
+  return *buffer;
+}
+
+constexpr uint32_t GPU_TRACK = 1000; // Thread id of the GPU zones in exported traces
+
+/// Stable color per zone name, so a zone keeps its color from one frame to the next.
+ImU32 zoneColor(const char *name) {
+  uint32_t hash = 2166136261u;
+
+  for (const char *c = name; *c; c++) {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+  }
+
+  return IM_COL32(90 + hash % 120, 90 + (hash >> 8) % 120, 90 + (hash >> 16) % 120, 255);
+}
+
+void writeJsonString(std::ostream &out, const char *text) {
+  out << '"';
+
+  for (const char *c = text; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+
+    out << *c;
+  }
+
+  out << '"';
+}
+
+} // namespace
+
+Profiler::~Profiler() {
+  for (const GpuFrameSlot &slot : m_gpuSlots) {
+    if (!slot.queries.empty()) {
+      glDeleteQueries(static_cast<GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+  }
+}
+
+void Profiler::setup() {
+  m_frames.resize(FRAME_HISTORY);
+  m_gpuSlots.resize(GPU_FRAMES_IN_FLIGHT);
+
+  for (GpuFrameSlot &slot : m_gpuSlots) {
+    slot.queries.resize(MAX_GPU_ZONES_PER_FRAME);
+    glGenQueries(MAX_GPU_ZONES_PER_FRAME, slot.queries.data());
+  }
+
+  currentThreadBuffer(); // The thread setting up the profiler is the main thread
+}
+
+int64_t Profiler::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Profiler::setThreadName(std::string name) {
+  ThreadBuffer &buffer = currentThreadBuffer();
+  const std::scoped_lock lock(buffer.mutex);
+  buffer.name = std::move(name);
+}
+
+void Profiler::beginCpuZone(const char *name) {
+  ThreadBuffer &buffer = currentThreadBuffer();
+  const auto depth = static_cast<uint32_t>(buffer.openZones.size());
+  buffer.openZones.push_back({name, nowNs(), 0, buffer.index, depth});
+}
+
+void Profiler::endCpuZone() {
+  ThreadBuffer &buffer = currentThreadBuffer();
+  CpuZone zone = buffer.openZones.back();
+  buffer.openZones.pop_back();
+  zone.endNs = nowNs();
+
+  const std::scoped_lock lock(buffer.mutex);
+  buffer.closedZones.push_back(zone);
+}
+
+void Profiler::beginFrame() {
+  m_currentFrame.index = ++m_frameIndex;
+  m_currentFrame.startNs = nowNs();
+  m_currentFrame.cpuZones.clear();
+  m_currentFrame.gpuZones.clear();
+  m_currentFrame.gpuResolved = false;
+
+  if (m_gpuSlots.empty()) {
+    return;
+  }
+
+  // The slot about to be reused was filled GPU_FRAMES_IN_FLIGHT frames ago, its queries are normally done by now
+  GpuFrameSlot &slot = m_gpuSlots[m_frameIndex % m_gpuSlots.size()];
+  resolveGpuZones(slot);
+  slot.frameIndex = m_frameIndex;
+}
+
+void Profiler::endFrame() {
+  {
+    const std::scoped_lock lock(threadRegistryMutex);
+
+    for (const std::shared_ptr<ThreadBuffer> &buffer : threadRegistry) {
+      const std::scoped_lock bufferLock(buffer->mutex);
+      m_currentFrame.cpuZones.insert(m_currentFrame.cpuZones.end(), buffer->closedZones.begin(),
+                                     buffer->closedZones.end());
+      buffer->closedZones.clear();
+    }
+  }
+
+  m_currentFrame.endNs = nowNs();
+
+  if (m_frames.empty()) {
+    return;
+  }
+
+  ProfiledFrame &stored = m_frames[m_currentFrame.index % m_frames.size()];
+  std::swap(stored, m_currentFrame); // Keeps the vector capacity of the evicted frame for the next one
+}
+
+void Profiler::beginGpuZone(const char *name) {
+  // Only one GL_TIME_ELAPSED query can be active at a time, so only the outermost zone is timed
+  if (m_gpuZoneDepth++ > 0 || m_gpuSlots.empty()) {
+    return;
+  }
+
+  GpuFrameSlot &slot = m_gpuSlots[m_frameIndex % m_gpuSlots.size()];
+
+  if (slot.zones.size() >= slot.queries.size()) {
+    return;
+  }
+
+  const GLuint query = slot.queries[slot.zones.size()];
+  slot.zones.push_back({name, nowNs(), query});
+  glBeginQuery(GL_TIME_ELAPSED, query);
+  m_gpuQueryActive = true;
+}
+
+void Profiler::endGpuZone() {
+  if (--m_gpuZoneDepth > 0 || !m_gpuQueryActive) {
+    return;
+  }
+
+  glEndQuery(GL_TIME_ELAPSED);
+  m_gpuQueryActive = false;
+}
+
+void Profiler::resolveGpuZones(GpuFrameSlot &slot) {
+  if (slot.zones.empty()) {
+    return;
+  }
+
+  // Queries complete in order, so the last one being available means all of them are. Results that are still not
+  // there are dropped rather than waited for.
+  GLint available = GL_FALSE;
+  glGetQueryObjectiv(slot.zones.back().query, GL_QUERY_RESULT_AVAILABLE, &available);
+
+  if (ProfiledFrame *frame = findFrame(slot.frameIndex); frame && available) {
+    for (const auto &[name, cpuStartNs, query] : slot.zones) {
+      GLuint64 elapsed = 0;
+      glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+      frame->gpuZones.push_back({name, cpuStartNs, static_cast<int64_t>(elapsed)});
+    }
+
+    frame->gpuResolved = true;
+  }
+
+  slot.zones.clear();
+}
+
+ProfiledFrame *Profiler::findFrame(const uint64_t index) {
+  if (m_frames.empty()) {
+    return nullptr;
+  }
+
+  ProfiledFrame &frame = m_frames[index % m_frames.size()];
+  return frame.index == index ? &frame : nullptr;
+}
+
+void Profiler::renderPanel() const {
+  ImGui::SetNextWindowSizeConstraints(ImVec2(400, 200), ImVec2(FLT_MAX, FLT_MAX));
+  ImGui::Begin("Profiler", nullptr, ImGuiWindowFlags_NoFocusOnAppearing);
+
+#ifndef PROFILER_ENABLED
+  ImGui::Text("Profiling zones are compiled out of this build.");
+#endif
+
+  // Frame times of the whole history, oldest first
+  std::vector<float> frameTimes;
+  const ProfiledFrame *shown = nullptr;
+
+  for (uint64_t i = 0; i < m_frames.size(); i++) {
+    const ProfiledFrame &frame = m_frames[(m_frameIndex + i) % m_frames.size()];
+
+    if (frame.index == 0) {
+      continue;
+    }
+
+    frameTimes.push_back(static_cast<float>(frame.endNs - frame.startNs) / 1e6f);
+
+    if (frame.gpuResolved || !shown) {
+      shown = &frame;
+    }
+  }
+
+  ImGui::PlotLines("##frameTimes", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, "Frame time (ms)",
+                   0.0f, 33.3f, ImVec2(ImGui::GetContentRegionAvail().x, 50));
+
+  if (ImGui::Button("Export Chrome trace")) {
+    exportChromeTrace(TRACE_FILE);
+  }
+
+  ImGui::SameLine();
+  ImGui::TextDisabled("(or F9)");
+
+  if (!shown) {
+    ImGui::End();
+    return;
+  }
+
+  int64_t gpuTotalNs = 0;
+
+  for (const GpuZone &zone : shown->gpuZones) {
+    gpuTotalNs += zone.durationNs;
+  }
+
+  const auto frameNs = static_cast<float>(std::max<int64_t>(shown->endNs - shown->startNs, 1));
+  ImGui::Text("Frame %llu: CPU %.2f ms, GPU %.2f ms", static_cast<unsigned long long>(shown->index), frameNs / 1e6f,
+              static_cast<float>(gpuTotalNs) / 1e6f);
+
+  // Flame graph, one band per thread and one row per nesting level, followed by the GPU band
+  constexpr float rowHeight = 18.0f;
+  ImDrawList *drawList = ImGui::GetWindowDrawList();
+  const float width = ImGui::GetContentRegionAvail().x;
+
+  auto drawZone = [&](const char *name, const float top, const int64_t startNs, const int64_t durationNs) {
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float left = origin.x + static_cast<float>(startNs - shown->startNs) / frameNs * width;
+    const float right = left + std::max(static_cast<float>(durationNs) / frameNs * width, 1.0f);
+    const ImVec2 min(left, origin.y + top);
+    const ImVec2 max(right, origin.y + top + rowHeight - 1.0f);
+
+    drawList->AddRectFilled(min, max, zoneColor(name));
+
+    if (ImGui::CalcTextSize(name).x < right - left - 4.0f) {
+      drawList->AddText(ImVec2(left + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), name);
+    }
+
+    if (ImGui::IsMouseHoveringRect(min, max)) {
+      ImGui::SetTooltip("%s: %.3f ms", name, static_cast<float>(durationNs) / 1e6f);
+    }
+  };
+
+  std::vector<uint32_t> threads;
+
+  for (const CpuZone &zone : shown->cpuZones) {
+    if (std::ranges::find(threads, zone.threadIndex) == threads.end()) {
+      threads.push_back(zone.threadIndex);
+    }
+  }
+
+  std::ranges::sort(threads);
+
+  for (const uint32_t thread : threads) {
+    uint32_t rows = 0;
+
+    for (const CpuZone &zone : shown->cpuZones) {
+      if (zone.threadIndex == thread) {
+        rows = std::max(rows, zone.depth + 1);
+      }
+    }
+
+    ImGui::Text("Thread %u", thread);
+
+    for (const CpuZone &zone : shown->cpuZones) {
+      if (zone.threadIndex == thread) {
+        drawZone(zone.name, static_cast<float>(zone.depth) * rowHeight, zone.startNs, zone.endNs - zone.startNs);
+      }
+    }
+
+    ImGui::Dummy(ImVec2(width, static_cast<float>(rows) * rowHeight));
+  }
+
+  if (!shown->gpuZones.empty()) {
+    ImGui::Text("GPU");
+
+    // Zones are laid out back to back from their submission time, the GPU clock is not synchronized with the CPU
+    int64_t gpuCursorNs = shown->gpuZones.front().cpuStartNs;
+
+    for (const GpuZone &zone : shown->gpuZones) {
+      gpuCursorNs = std::max(gpuCursorNs, zone.cpuStartNs);
+      drawZone(zone.name, 0.0f, gpuCursorNs, zone.durationNs);
+      gpuCursorNs += zone.durationNs;
+    }
+
+    ImGui::Dummy(ImVec2(width, rowHeight));
+  }
+
+  ImGui::End();
+}
+
+bool Profiler::exportChromeTrace(const std::filesystem::path &path) const {
+  std::ofstream out(path);
+
+  if (!out) {
+    SPDLOG_ERROR("Couldn't open {} for writing", path.string());
+    return false;
+  }
+
+  // Timestamps are microseconds relative to the oldest recorded frame
+  int64_t originNs = std::numeric_limits<int64_t>::max();
+
+  for (const ProfiledFrame &frame : m_frames) {
+    if (frame.index != 0) {
+      originNs = std::min(originNs, frame.startNs);
+    }
+  }
+
+  auto micros = [&](const int64_t ns) { return static_cast<double>(ns - originNs) / 1000.0; };
+  bool first = true;
+
+  auto writeEvent = [&](const char *name, const char *category, const uint32_t thread, const int64_t startNs,
+                        const int64_t durationNs) {
+    out << (first ? "\n" : ",\n") << R"({"name":)";
+    writeJsonString(out, name);
+    out << R"(,"cat":")" << category << R"(","ph":"X","pid":1,"tid":)" << thread << R"(,"ts":)" << micros(startNs)
+        << R"(,"dur":)" << static_cast<double>(durationNs) / 1000.0 << '}';
+    first = false;
+  };
+
+  out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+  {
+    const std::scoped_lock lock(threadRegistryMutex);
+
+    for (const std::shared_ptr<ThreadBuffer> &buffer : threadRegistry) {
+      const std::scoped_lock bufferLock(buffer->mutex);
+      out << (first ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->index
+          << R"(,"args":{"name":)";
+      writeJsonString(out, buffer->name.c_str());
+      out << "}}";
+      first = false;
+    }
+  }
+
+  out << (first ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << GPU_TRACK
+      << R"(,"args":{"name":"GPU"}})";
+  first = false;
+
+  for (const ProfiledFrame &frame : m_frames) {
+    if (frame.index == 0) {
+      continue;
+    }
+
+    writeEvent("Frame", "frame", 0, frame.startNs, frame.endNs - frame.startNs);
+
+    for (const CpuZone &zone : frame.cpuZones) {
+      writeEvent(zone.name, "cpu", zone.threadIndex, zone.startNs, zone.endNs - zone.startNs);
+    }
+
+    int64_t gpuCursorNs = std::numeric_limits<int64_t>::min();
+
+    for (const GpuZone &zone : frame.gpuZones) {
+      gpuCursorNs = std::max(gpuCursorNs, zone.cpuStartNs);
+      writeEvent(zone.name, "gpu", GPU_TRACK, gpuCursorNs, zone.durationNs);
+      gpuCursorNs += zone.durationNs;
+    }
+  }
+
+  out << "\n]}\n";
+
+  if (!out) {
+    SPDLOG_ERROR("Couldn't write the trace to {}", path.string());
+    return false;
+  }
+
+  SPDLOG_INFO("Wrote the last {} frames to {}", m_frames.size(), path.string());
+  return true;
+}
+
+#ifdef PROFILER_ENABLED
+GpuProfileScope::GpuProfileScope(const char *name) : m_cpuScope(name) {
+  g_profiler.beginGpuZone(name);
+}
+
+GpuProfileScope::~GpuProfileScope() {
+  g_profiler.endGpuZone();
+}
+#endif
+
+} // namespace App
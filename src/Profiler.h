@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Zones only exist in builds defining PROFILER_ENABLED (everything but Release), elsewhere the macros expand to
+// nothing and cost nothing
+#ifdef PROFILER_ENABLED
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+/// Times the enclosing scope on the calling thread, `name` must outlive the profiler (a string literal).
+#define PROFILE_SCOPE(name) const ::App::CpuProfileScope PROFILER_CONCAT(profileScope, __LINE__)(name)
+/// Times the GPU work submitted in the enclosing scope. GPU zones cannot nest, nested ones are ignored.
+#define PROFILE_GPU_SCOPE(name) const ::App::GpuProfileScope PROFILER_CONCAT(gpuProfileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#define PROFILE_GPU_SCOPE(name) static_cast<void>(0)
+#endif
+
+namespace App {
+
+struct CpuZone {
+  const char *name;
+  int64_t startNs;
+  int64_t endNs;
+  uint32_t threadIndex;
+  uint32_t depth;
+};
+
+struct GpuZone {
+  const char *name;
+  int64_t cpuStartNs; // When the zone was submitted, the GPU runs it some time later
+  int64_t durationNs;
+};
+
+struct ProfiledFrame {
+  uint64_t index = 0;
+  int64_t startNs = 0;
+  int64_t endNs = 0;
+  std::vector<CpuZone> cpuZones;
+  std::vector<GpuZone> gpuZones;
+  bool gpuResolved = false; // GPU timings arrive a few frames after the frame itself
+};
+
+/// Collects CPU zones from every thread and GPU zones from timer queries, and keeps the last frames around for the
+/// flame graph and for Chrome trace exports (chrome://tracing, Perfetto).
+class Profiler {
+public:
+  Profiler() = default;
+  ~Profiler();
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  /// Creates the GPU timer queries, needs a current OpenGL context.
+  void setup();
+
+  void beginFrame();
+  void endFrame();
+
+  /// Draws the "Profiler" window with the flame graph of the last frame whose GPU timings are known.
+  void renderPanel() const;
+
+  /// Writes the recorded frames as Chrome trace_event JSON. Returns false if the file could not be written.
+  bool exportChromeTrace(const std::filesystem::path &path) const;
+
+  /// Name of the calling thread in exported traces.
+  static void setThreadName(std::string name);
+
+  [[nodiscard]] static int64_t nowNs();
+
+  // Used by the scope guards
+  static void beginCpuZone(const char *name);
+  static void endCpuZone();
+  void beginGpuZone(const char *name);
+  void endGpuZone();
+
+private:
+  struct PendingGpuZone {
+    const char *name;
+    int64_t cpuStartNs;
+    GLuint query;
+  };
+
+  struct GpuFrameSlot {
+    uint64_t frameIndex = 0;
+    std::vector<GLuint> queries;
+    std::vector<PendingGpuZone> zones;
+  };
+
+  std::vector<ProfiledFrame> m_frames; // Ring buffer of the last frames
+  ProfiledFrame m_currentFrame;
+  uint64_t m_frameIndex = 0;
+
+  std::vector<GpuFrameSlot> m_gpuSlots; // One per frame in flight
+  int m_gpuZoneDepth = 0;
+  bool m_gpuQueryActive = false;
+
+  void resolveGpuZones(GpuFrameSlot &slot);
+  [[nodiscard]] ProfiledFrame *findFrame(uint64_t index);
+};
+
+#ifdef PROFILER_ENABLED
+class CpuProfileScope {
+public:
+  explicit CpuProfileScope(const char *name) {
+    Profiler::beginCpuZone(name);
+  }
+
+  ~CpuProfileScope() {
+    Profiler::endCpuZone();
+  }
+
+  CpuProfileScope(const CpuProfileScope &) = delete;
+  CpuProfileScope &operator=(const CpuProfileScope &) = delete;
+};
+
+class GpuProfileScope {
+public:
+  explicit GpuProfileScope(const char *name);
+  ~GpuProfileScope();
+
+  GpuProfileScope(const GpuProfileScope &) = delete;
+  GpuProfileScope &operator=(const GpuProfileScope &) = delete;
+
+private:
+  const CpuProfileScope m_cpuScope;
+};
+#endif
+
+} // namespace App
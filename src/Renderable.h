@@ -1,20 +1,46 @@
 #pragma once
 
+#include <type_traits>
+
 #include <glm/glm.hpp>
 
 #include "Shader.h"
-#include "Light.h"
+#include "ShaderVariant.h"
+
+namespace App {
+class ClusteredLighting;
+class ShadowMaps;
+} // namespace App
 
+/// Plain view of what a draw needs, cheap to copy and tweak per object. The lighting and the shader are owned
+/// elsewhere, usually by the container and the shader cache.
 struct RenderContext {
   glm::mat4 modelMatrix;
   glm::mat4 viewMatrix;
   glm::mat4 projectionMatrix;
   glm::vec3 cameraPosition;
-  std::vector<Light> lights;
+  const App::ClusteredLighting *lighting = nullptr; // The frame's light clusters, unlit when null
+  const App::ShadowMaps *shadows = nullptr;          // The sun's shadows, none when null
   GLuint renderMode = GL_TRIANGLES;
-  std::optional<std::shared_ptr<App::Shader>> customShader = std::nullopt;
+  App::LightBucket lightBucket = App::LightBucket::Many; // Of the materials' shader variants
+  App::Shader *customShader = nullptr;                   // Replaces the materials' shaders when set
 };
 
+static_assert(std::is_trivially_copyable_v<RenderContext>);
+
+/// transpose(inverse(mat3(model))), what normals are transformed with. The inverse's rows are the cross products of the
+/// other two columns over the determinant, so its transpose has them as columns.
+inline glm::mat3 normalMatrix(const glm::mat4 &model) {
+  const glm::vec3 x(model[0]);
+  const glm::vec3 y(model[1]);
+  const glm::vec3 z(model[2]);
+  const glm::vec3 yz = glm::cross(y, z);
+  const float determinant = glm::dot(x, yz);
+
+  // A flattened object has no normals to speak of, and nothing of it is visible either
+  return glm::mat3(yz, glm::cross(z, x), glm::cross(x, y)) * (determinant != 0.0f ? 1.0f / determinant : 0.0f);
+}
+
 class Renderable {
 public:
   virtual ~Renderable() = default;
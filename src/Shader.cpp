@@ -5,11 +5,14 @@
 #include <iostream>
 
 #include "Config.h"
+#include "ShaderVariant.h"
 
 constexpr auto SHADER_PATH = "resources/shaders/";
 
 namespace App {
 
+/// Reads a shader source, replacing every `#include "name"` line with the file of that name in the same directory.
+/// GLSL has no includes of its own, shared code like the clustered lighting lookup lives in files pulled in this way.
 std::string loadShaderFile(const char *path) {
   std::string content;
   std::ifstream file;
@@ -27,16 +30,47 @@ std::string loadShaderFile(const char *path) {
     SPDLOG_ERROR("ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: {} {}", path, e.what());
   }
 
+  constexpr std::string_view directive = "#include \"";
+  const std::string_view pathView(path);
+  const std::string directory(pathView.substr(0, pathView.find_last_of('/') + 1));
+
+  for (std::size_t start = content.find(directive); start != std::string::npos; start = content.find(directive, start)) {
+    const std::size_t nameStart = start + directive.size();
+    const std::size_t nameEnd = content.find('"', nameStart);
+    const std::size_t lineEnd = content.find('\n', nameStart);
+
+    if (nameEnd == std::string::npos || nameEnd > lineEnd) {
+      SPDLOG_ERROR("ERROR::SHADER::MALFORMED_INCLUDE in {}", path);
+      break;
+    }
+
+    const std::string included = loadShaderFile((directory + content.substr(nameStart, nameEnd - nameStart)).c_str());
+    content.replace(start, nameEnd + 1 - start, included);
+    start += included.size();
+  }
+
   return content;
 }
 
+/// Puts `defines` after the `#version` line, which has to stay the first one.
+std::string injectDefines(std::string source, const std::string_view defines) {
+  if (defines.empty()) {
+    return source;
+  }
+
+  const std::size_t version = source.find("#version");
+  const std::size_t lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+  source.insert(lineEnd == std::string::npos ? 0 : lineEnd + 1, defines);
+  return source;
+}
+
 Shader::Shader(const std::string &name) : Shader(SHADER_PATH + name + ".vert", SHADER_PATH + name + ".frag") {
 }
 
-Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath)
+Shader::Shader(const std::string &vertexPath, const std::string &fragmentPath, const std::string_view defines)
     : m_vertexPath(vertexPath), m_fragmentPath(fragmentPath) {
-  const std::string vertexCode = loadShaderFile(vertexPath.c_str());
-  const std::string fragmentCode = loadShaderFile(fragmentPath.c_str());
+  const std::string vertexCode = injectDefines(loadShaderFile(vertexPath.c_str()), defines);
+  const std::string fragmentCode = injectDefines(loadShaderFile(fragmentPath.c_str()), defines);
 
   const uint vertex = compile(vertexCode, ShaderType::VERTEX);
   const uint fragment = compile(fragmentCode, ShaderType::FRAGMENT);
@@ -58,6 +92,11 @@ Shader::Shader(const char *const vertexName, const char *const fragmentName)
     : Shader(std::string(SHADER_PATH) + vertexName, std::string(SHADER_PATH) + fragmentName) {
 }
 
+Shader::Shader(const char *const vertexName, const char *const fragmentName, const uint32_t variantKey)
+    : Shader(std::string(SHADER_PATH) + vertexName, std::string(SHADER_PATH) + fragmentName,
+             ShaderVariant::fromKey(variantKey).defines()) {
+}
+
 Shader::~Shader() {
   glDeleteProgram(m_id);
 }
@@ -94,12 +133,14 @@ uint Shader::compile(const std::string &code, const ShaderType type) {
   return shaderId;
 }
 
-GLint Shader::getUniformLocation(const std::string &name) {
+GLint Shader::getUniformLocation(const std::string_view name) {
   if (const auto locationPtr = m_uniformLocations.find(name); locationPtr != m_uniformLocations.end()) {
     return locationPtr->second;
   }
 
-  const GLint location = glGetUniformLocation(m_id, name.c_str());
+  const auto [locationPtr, inserted] = m_uniformLocations.emplace(name, -1);
+  const GLint location = glGetUniformLocation(m_id, locationPtr->first.c_str());
+  locationPtr->second = location;
 
   if (Config::Core::DEBUG_MODE) {
     if (location == -1) {
@@ -109,7 +150,6 @@ GLint Shader::getUniformLocation(const std::string &name) {
     }
   }
 
-  m_uniformLocations.insert({name, location});
   return location;
 }
 
@@ -1,13 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <spdlog/spdlog.h>
 
+#include "StringHash.h"
+
 namespace App {
 enum class ShaderType {
   VERTEX,
@@ -20,8 +23,11 @@ constexpr const char *const shaderTypes[] = {"VERTEX", "FRAGMENT", "PROGRAM"};
 class Shader {
 public:
   explicit Shader(const std::string &name);
-  Shader(const std::string &vertexPath, const std::string &fragmentPath);
+  /// `defines` go right after the `#version` line of both stages.
+  Shader(const std::string &vertexPath, const std::string &fragmentPath, std::string_view defines = {});
   Shader(const char *vertexName, const char *fragmentName);
+  /// A variant of the pair, see ShaderVariant::key.
+  Shader(const char *vertexName, const char *fragmentName, uint32_t variantKey);
 
   ~Shader();
 
@@ -29,55 +35,59 @@ public:
     glUseProgram(m_id);
   }
 
-  void set(const std::string &name, const bool value) {
+  void set(const std::string_view name, const bool value) {
     glUniform1i(getUniformLocation(name), static_cast<int>(value));
   }
 
-  void set(const std::string &name, const std::size_t value) {
+  void set(const std::string_view name, const std::size_t value) {
     glUniform1ui(getUniformLocation(name), value);
   }
 
-  void set(const std::string &name, const int value) {
+  void set(const std::string_view name, const int value) {
     glUniform1i(getUniformLocation(name), value);
   }
 
-  void set(const std::string &name, const float value) {
+  void set(const std::string_view name, const float value) {
     glUniform1f(getUniformLocation(name), value);
   }
 
-  void set(const std::string &name, const glm::vec2 &value) {
+  void set(const std::string_view name, const glm::vec2 &value) {
     glUniform2fv(getUniformLocation(name), 1, &value[0]);
   }
 
-  void set(const std::string &name, const float x, const float y) {
+  void set(const std::string_view name, const float x, const float y) {
     glUniform2f(getUniformLocation(name), x, y);
   }
 
-  void set(const std::string &name, const glm::vec3 &value) {
+  void set(const std::string_view name, const glm::vec3 &value) {
     glUniform3fv(getUniformLocation(name), 1, &value[0]);
   }
 
-  void set(const std::string &name, const float x, const float y, const float z) {
+  void set(const std::string_view name, const glm::ivec3 &value) {
+    glUniform3iv(getUniformLocation(name), 1, &value[0]);
+  }
+
+  void set(const std::string_view name, const float x, const float y, const float z) {
     glUniform3f(getUniformLocation(name), x, y, z);
   }
 
-  void set(const std::string &name, const glm::vec4 &value) {
+  void set(const std::string_view name, const glm::vec4 &value) {
     glUniform4fv(getUniformLocation(name), 1, &value[0]);
   }
 
-  void set(const std::string &name, const float x, const float y, const float z, const float w) {
+  void set(const std::string_view name, const float x, const float y, const float z, const float w) {
     glUniform4f(getUniformLocation(name), x, y, z, w);
   }
 
-  void set(const std::string &name, const glm::mat2 &mat) {
+  void set(const std::string_view name, const glm::mat2 &mat) {
     glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
   }
 
-  void set(const std::string &name, const glm::mat3 &mat) {
+  void set(const std::string_view name, const glm::mat3 &mat) {
     glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
   }
 
-  void set(const std::string &name, const glm::mat4 &mat) {
+  void set(const std::string_view name, const glm::mat4 &mat) {
     glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(mat));
   }
 
@@ -86,9 +96,9 @@ private:
 
   std::string m_vertexPath;
   std::string m_fragmentPath;
-  std::unordered_map<std::string, GLint> m_uniformLocations{};
+  StringMap<GLint> m_uniformLocations{};
 
-  GLint getUniformLocation(const std::string &name);
+  GLint getUniformLocation(std::string_view name);
   static void checkCompileErrors(GLuint shader, ShaderType type);
   static uint compile(const std::string &code, ShaderType type);
 };
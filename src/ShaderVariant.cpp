@@ -0,0 +1,52 @@
+#include "ShaderVariant.h"
+
+#include <format>
+#include <iterator>
+
+#include "Container.h"
+
+namespace App {
+
+LightBucket ShaderVariant::bucketFor(const std::size_t lights) {
+  if (lights == 0) {
+    return LightBucket::Unlit;
+  }
+
+  return lights <= Config::Renderer::FEW_LIGHTS_PER_CLUSTER ? LightBucket::Few : LightBucket::Many;
+}
+
+ShaderVariant ShaderVariant::fromKey(const uint32_t key) {
+  return {.features = key & 0xFFu, .lights = static_cast<LightBucket>(key >> 8)};
+}
+
+std::string ShaderVariant::defines() const {
+  constexpr std::pair<ShaderFeature, const char *> names[] = {
+      {SHADER_DIFFUSE_MAP, "HAS_DIFFUSE_MAP"}, {SHADER_SPECULAR_MAP, "HAS_SPECULAR_MAP"},
+      {SHADER_NORMAL_MAP, "HAS_NORMAL_MAP"},   {SHADER_VERTEX_COLOR, "HAS_VERTEX_COLOR"},
+      {SHADER_DEBUG, "DEBUG"},
+  };
+
+  std::string defines;
+
+  for (const auto &[feature, name] : names) {
+    if (features & feature) {
+      std::format_to(std::back_inserter(defines), "#define {}\n", name);
+    }
+  }
+
+  if (lights == LightBucket::Unlit) {
+    defines += "#define UNLIT\n";
+  } else {
+    std::format_to(std::back_inserter(defines), "#define MAX_FRAGMENT_LIGHTS {}\n",
+                   lights == LightBucket::Few ? Config::Renderer::FEW_LIGHTS_PER_CLUSTER
+                                              : Config::Renderer::MAX_LIGHTS_PER_CLUSTER);
+  }
+
+  return defines;
+}
+
+const std::shared_ptr<Shader> &ShaderVariant::load(const char *vertexName, const char *fragmentName) const {
+  return g_shaderCache.get(vertexName, fragmentName, key());
+}
+
+} // namespace App
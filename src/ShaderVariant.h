@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace App {
+
+class Shader;
+
+/// Optional parts of a shader, each one a `#define` injected after its `#version` line.
+enum ShaderFeature : uint32_t {
+  SHADER_DIFFUSE_MAP = 1u << 0,  // HAS_DIFFUSE_MAP, the diffuse color otherwise
+  SHADER_SPECULAR_MAP = 1u << 1, // HAS_SPECULAR_MAP, not metallic otherwise
+  SHADER_NORMAL_MAP = 1u << 2,   // HAS_NORMAL_MAP, the interpolated normal otherwise
+  SHADER_VERTEX_COLOR = 1u << 3, // HAS_VERTEX_COLOR, tints the albedo
+  SHADER_DEBUG = 1u << 4,        // DEBUG, keeps every uniform alive so setting one is never reported as unknown
+};
+
+/// Most lights a fragment loops over (MAX_FRAGMENT_LIGHTS), picked once per frame from its busiest cluster.
+enum class LightBucket : uint8_t {
+  Unlit, // UNLIT, not even the cluster lookup is left
+  Few,   // Up to Config::Renderer::FEW_LIGHTS_PER_CLUSTER, short enough to unroll
+  Many,  // Up to Config::Renderer::MAX_LIGHTS_PER_CLUSTER
+};
+
+constexpr std::size_t LIGHT_BUCKET_COUNT = 3;
+
+/// A base shader and the features it is compiled with. Each combination is a program of its own, compiled the first
+/// time it is asked for and kept in g_shaderCache, so a draw only pays for the textures and lights it has instead of
+/// every draw sampling and looping as if it had all of them.
+struct ShaderVariant {
+  uint32_t features = 0;
+  LightBucket lights = LightBucket::Many;
+
+  /// Leanest bucket holding a frame whose busiest cluster has `lights` lights.
+  [[nodiscard]] static LightBucket bucketFor(std::size_t lights);
+
+  /// Features and bucket in one number, what the shader cache tells variants apart by.
+  [[nodiscard]] uint32_t key() const {
+    return features | static_cast<uint32_t>(lights) << 8;
+  }
+
+  [[nodiscard]] static ShaderVariant fromKey(uint32_t key);
+
+  /// The `#define` lines of the variant, one per line.
+  [[nodiscard]] std::string defines() const;
+
+  /// This variant of a vertex and fragment shader pair, from the shader cache.
+  [[nodiscard]] const std::shared_ptr<Shader> &load(const char *vertexName, const char *fragmentName) const;
+};
+
+} // namespace App
@@ -0,0 +1,279 @@
+#include "ShadowMaps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+
+#include "Frustum.h"
+#include "Profiler.h"
+
+namespace App {
+
+namespace {
+using namespace Config::Renderer;
+
+/// Copies a scratch list into the frame's arena, where it stays until the frame is rebuilt.
+template <class T> std::span<const T> copyToArena(FrameArena &arena, const std::pmr::vector<T> &items) {
+  const std::span<T> copy = arena.allocateArray<T>(items.size());
+  std::ranges::copy(items, copy.begin());
+  return copy;
+}
+} // namespace
+
+ShadowMaps::~ShadowMaps() {
+  if (m_framebuffer) {
+    glDeleteFramebuffers(1, &m_framebuffer);
+  }
+
+  if (m_texture) {
+    glDeleteTextures(1, &m_texture);
+  }
+}
+
+void ShadowMaps::setup() {
+  glGenTextures(1, &m_texture);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+  glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, SHADOW_CASCADES, 0,
+               GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+  // 24 bit depth is stored in 32 bits
+  m_gpuMemory.set(MemoryAccounting::textureBytes(SHADOW_MAP_SIZE, SHADOW_MAP_SIZE, 4, false, SHADOW_CASCADES));
+
+  // Compared in hardware, linear filtering blends the results of the four nearest texels. Outside the map is lit
+  constexpr GLfloat border[] = {1.0f, 1.0f, 1.0f, 1.0f};
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+  glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, border);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+  glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+  glGenFramebuffers(1, &m_framebuffer);
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, 0);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    SPDLOG_ERROR("Shadow map framebuffer is incomplete");
+  }
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  m_depthShader = std::make_unique<Shader>("shadow_depth.vert", "depth_only.frag");
+
+  for (int i = 0; i < SHADOW_CASCADES; i++) {
+    m_matrixNames[i] = std::format("uSun.matrices[{}]", i);
+    m_farDepthNames[i] = std::format("uSun.farDepths[{}]", i);
+    m_texelSizeNames[i] = std::format("uSun.texelSizes[{}]", i);
+  }
+}
+
+ShadowFrame ShadowMaps::plan(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, const World &world,
+                             Ecs::Registry &entities, FrameArena &arena) {
+  PROFILE_SCOPE("Plan shadows");
+
+  ShadowFrame frame;
+  const bool hasSun = glm::length(m_sun.direction) > 0.0f;
+  frame.enabled = m_enabled && hasSun;
+
+  // Lighting follows the sun with or without its shadows
+  if (hasSun) {
+    frame.sunDirection = -glm::normalize(m_sun.direction);
+  }
+
+  if (!frame.enabled) {
+    // Nothing keeps the maps up to date meanwhile
+    for (CachedCascade &cache : m_cache) {
+      cache.valid = false;
+    }
+
+    return frame;
+  }
+
+  const bool sunMoved = frame.sunDirection != m_plannedSunDirection;
+  m_plannedSunDirection = frame.sunDirection;
+
+  // Corners of the view frustum on its near and far planes. Along each corner ray, points move linearly with depth
+  const glm::mat4 inverseViewProjection = glm::inverse(projectionMatrix * viewMatrix);
+  std::array<glm::vec3, 4> nearCorners{};
+  std::array<glm::vec3, 4> farCorners{};
+
+  for (int i = 0; i < 4; i++) {
+    const glm::vec2 ndc(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f);
+    const glm::vec4 nearCorner = inverseViewProjection * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+    const glm::vec4 farCorner = inverseViewProjection * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+    nearCorners[i] = glm::vec3(nearCorner) / nearCorner.w;
+    farCorners[i] = glm::vec3(farCorner) / farCorner.w;
+  }
+
+  float sliceNear = NEAR_PLANE;
+
+  for (int i = 0; i < SHADOW_CASCADES; i++) {
+    const float share = static_cast<float>(i + 1) / SHADOW_CASCADES;
+    const float logSplit = NEAR_PLANE * std::pow(SHADOW_DISTANCE / NEAR_PLANE, share);
+    const float evenSplit = NEAR_PLANE + (SHADOW_DISTANCE - NEAR_PLANE) * share;
+    const float sliceFar = glm::mix(evenSplit, logSplit, SHADOW_SPLIT_LAMBDA);
+
+    // Bounding sphere of the slice. Its radius only depends on the projection, turning the camera leaves it alone
+    std::array<glm::vec3, 8> corners{};
+    glm::vec3 center(0.0f);
+
+    for (int corner = 0; corner < 4; corner++) {
+      corners[corner] = glm::mix(nearCorners[corner], farCorners[corner],
+                                 (sliceNear - NEAR_PLANE) / (FAR_PLANE - NEAR_PLANE));
+      corners[corner + 4] = glm::mix(nearCorners[corner], farCorners[corner],
+                                     (sliceFar - NEAR_PLANE) / (FAR_PLANE - NEAR_PLANE));
+      center += corners[corner] + corners[corner + 4];
+    }
+
+    center /= 8.0f;
+    float radius = 0.0f;
+
+    for (const glm::vec3 &corner : corners) {
+      radius = std::max(radius, glm::length(corner - center));
+    }
+
+    // Rounded up, float noise in the radius would change the texel size and make the edges crawl
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+
+    ShadowCascade &cascade = frame.cascades[i];
+    CachedCascade &cache = m_cache[i];
+    cascade.farDepth = sliceFar;
+    cascade.cached = i >= SHADOW_CASCADES - CACHED_SHADOW_CASCADES;
+
+    if (!cascade.cached) {
+      cache = {.valid = false, .center = center, .radius = radius,
+               .viewProjection = fitCascade(frame.sunDirection, center, radius)};
+      cascade.redraw = true;
+    } else if (!cache.valid || sunMoved || glm::distance(center, cache.center) + radius > cache.radius) {
+      const float cachedRadius = radius * (1.0f + SHADOW_CACHE_MARGIN);
+      cache = {.valid = true, .center = center, .radius = cachedRadius,
+               .viewProjection = fitCascade(frame.sunDirection, center, cachedRadius)};
+      cascade.redraw = true;
+    } else {
+      const Frustum frustum(cache.viewProjection);
+      cascade.redraw = std::ranges::any_of(world.getChangedMeshes(), [&](const glm::ivec3 &coord) {
+        return frustum.intersects(World::chunkBounds(coord));
+      });
+    }
+
+    cascade.viewProjection = cache.viewProjection;
+    cascade.texelSize = 2.0f * cache.radius / SHADOW_MAP_SIZE;
+
+    if (cascade.redraw) {
+      m_casterChunks.clear();
+      world.cullShadowCasters(cascade.viewProjection, m_casterChunks);
+      cascade.chunks = copyToArena(arena, m_casterChunks);
+
+      // Entities move all the time, cached cascades would be redrawn every frame for them
+      if (!cascade.cached) {
+        m_casterMeshes.clear();
+        Ecs::collectDraws(entities, cascade.viewProjection, m_casterMeshes);
+        cascade.meshes = copyToArena(arena, m_casterMeshes);
+      }
+
+      frame.stats.redrawnCascades++;
+      frame.stats.casterChunks += cascade.chunks.size();
+      frame.stats.casterMeshes += cascade.meshes.size();
+    }
+
+    sliceNear = sliceFar;
+  }
+
+  return frame;
+}
+
+void ShadowMaps::render(const ShadowFrame &frame) {
+  m_rendered = frame;
+
+  for (ShadowCascade &cascade : m_rendered.cascades) {
+    cascade.chunks = {};
+    cascade.meshes = {};
+  }
+
+  if (!frame.enabled || frame.stats.redrawnCascades == 0) {
+    return;
+  }
+
+  PROFILE_SCOPE("ShadowMaps::render");
+
+  GLint target = 0;
+  GLint viewport[4];
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+
+  // Slope scaled, the receivers add a normal offset on top
+  glEnable(GL_POLYGON_OFFSET_FILL);
+  glPolygonOffset(1.5f, 4.0f);
+  m_depthShader->use();
+
+  for (int i = 0; i < SHADOW_CASCADES; i++) {
+    const ShadowCascade &cascade = frame.cascades[i];
+
+    if (!cascade.redraw) {
+      continue;
+    }
+
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_texture, 0, i);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    m_depthShader->set("uLightViewProjection", cascade.viewProjection);
+
+    for (const auto &[mesh, coord] : cascade.chunks) {
+      m_depthShader->set("uModel", glm::translate(glm::mat4(1.0f), glm::vec3(coord * Chunk::SIZE)));
+      mesh->renderPositions();
+    }
+
+    for (const Ecs::MeshDraw &draw : cascade.meshes) {
+      m_depthShader->set("uModel", draw.world);
+      draw.mesh->renderPositions(draw.renderMode);
+    }
+  }
+
+  glDisable(GL_POLYGON_OFFSET_FILL);
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(target));
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void ShadowMaps::bind(Shader &shader) const {
+  glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_TEXTURE_INDEX);
+  glBindTexture(GL_TEXTURE_2D_ARRAY, m_texture);
+  glActiveTexture(GL_TEXTURE0);
+
+  shader.set("uShadowMap", static_cast<int>(SHADOW_MAP_TEXTURE_INDEX));
+  shader.set("uSun.direction", m_rendered.sunDirection);
+  shader.set("uSun.cascades", m_rendered.enabled ? SHADOW_CASCADES : 0);
+
+  for (int i = 0; i < SHADOW_CASCADES; i++) {
+    const ShadowCascade &cascade = m_rendered.cascades[i];
+    shader.set(m_matrixNames[i], cascade.viewProjection);
+    shader.set(m_farDepthNames[i], cascade.farDepth);
+    shader.set(m_texelSizeNames[i], cascade.texelSize);
+  }
+}
+
+glm::mat4 ShadowMaps::fitCascade(const glm::vec3 &sunDirection, const glm::vec3 &center, const float radius) {
+  // Only a rotation, so whole texels line up with the same grid wherever the cascade is
+  const glm::vec3 up = std::abs(sunDirection.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+  const glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), -sunDirection, up);
+
+  const float texelSize = 2.0f * radius / SHADOW_MAP_SIZE;
+  glm::vec3 lightCenter(lightRotation * glm::vec4(center, 1.0f));
+  lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+  lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+  // The sun looks down -z, casters up to SHADOW_CASTER_REACH past the sphere towards it are kept
+  const glm::mat4 projection =
+      glm::ortho(lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius,
+                 -(lightCenter.z + radius + SHADOW_CASTER_REACH), -(lightCenter.z - radius));
+  return projection * lightRotation;
+}
+
+} // namespace App
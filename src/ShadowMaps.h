@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Config.h"
+#include "DeferredRenderer.h"
+#include "EcsSystems.h"
+#include "FrameArena.h"
+#include "Light.h"
+#include "MemoryAccounting.h"
+#include "Shader.h"
+#include "World.h"
+
+namespace App {
+
+/// Texture unit of the shadow map array, after the chunk origins.
+enum ShadowTextureIndex {
+  SHADOW_MAP_TEXTURE_INDEX = CHUNK_ORIGINS_TEXTURE_INDEX + 1,
+};
+
+struct ShadowCascade {
+  glm::mat4 viewProjection{1.0f}; // World to the cascade's clip space
+  float farDepth = 0.0f;          // View depth up to which the cascade is used
+  float texelSize = 0.0f;         // World units per shadow map texel
+  bool cached = false;            // Kept across frames
+  bool redraw = false;            // Drawn this frame, otherwise the map still holds it
+  /// Casters, only collected when the cascade is redrawn. Entities only cast into the cascades that are not cached.
+  std::span<const ChunkDraw> chunks;
+  std::span<const Ecs::MeshDraw> meshes;
+};
+
+struct ShadowStats {
+  std::size_t redrawnCascades = 0;
+  std::size_t casterChunks = 0;
+  std::size_t casterMeshes = 0;
+};
+
+/// Sun shadows of one frame, planned with the rest of it. Caster lists live in the frame's arena.
+struct ShadowFrame {
+  bool enabled = false;
+  glm::vec3 sunDirection{0.0f, 1.0f, 0.0f}; // Towards the sun
+  std::array<ShadowCascade, Config::Renderer::SHADOW_CASCADES> cascades{};
+  ShadowStats stats;
+};
+
+/// Cascaded shadow maps for the sun, one layer of a depth texture array per cascade. Cascades are bounding spheres of
+/// slices of the view frustum, seen by an orthographic camera that only moves in whole texels, so shadow edges stay
+/// put while the camera turns and moves.
+///
+/// `plan` runs with the rest of frame preparation and owns the cache bookkeeping, `render` and `bind` run on the GL
+/// thread and only touch GL objects. The near cascades are redrawn every frame, the far ones only when something in
+/// them changed, so the cost follows what changes rather than the size of the world.
+class ShadowMaps {
+public:
+  ShadowMaps() = default;
+  ~ShadowMaps();
+
+  ShadowMaps(const ShadowMaps &) = delete;
+  ShadowMaps &operator=(const ShadowMaps &) = delete;
+
+  /// Creates the depth texture array and the depth only shader, needs a current OpenGL context.
+  void setup();
+
+  /// Fits the cascades to a view and collects the casters of those needing a redraw. Reads the world and the
+  /// entities, so it runs wherever the frame is prepared.
+  ShadowFrame plan(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix, const World &world,
+                   Ecs::Registry &entities, FrameArena &arena);
+
+  /// Redraws the cascades the frame asks for, leaving the bound framebuffer and viewport as they were.
+  void render(const ShadowFrame &frame);
+
+  /// Binds the maps and sets the sun uniforms (shadows.glsl) of a shader that is in use.
+  void bind(Shader &shader) const;
+
+  [[nodiscard]] bool isEnabled() const {
+    return m_enabled;
+  }
+
+  void setEnabled(const bool enabled) {
+    m_enabled = enabled;
+  }
+
+  /// The sun, a directional light. Scene state: only change it while the scene is not being prepared.
+  [[nodiscard]] Light &getSun() {
+    return m_sun;
+  }
+
+private:
+  struct CachedCascade {
+    bool valid = false;
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+    glm::mat4 viewProjection{1.0f};
+  };
+
+  // Planning side
+  bool m_enabled = Config::Renderer::SUN_SHADOWS;
+  Light m_sun = Light::Directional(-Config::Renderer::SUN_DIRECTION);
+  glm::vec3 m_plannedSunDirection{0.0f};
+  std::array<CachedCascade, Config::Renderer::SHADOW_CASCADES> m_cache{};
+  std::pmr::vector<ChunkDraw> m_casterChunks;
+  std::pmr::vector<Ecs::MeshDraw> m_casterMeshes;
+
+  // GL side
+  GLuint m_texture = 0;
+  GLuint m_framebuffer = 0;
+  TrackedMemory m_gpuMemory{MemoryTag::Shadows, MemoryPool::Gpu};
+  std::unique_ptr<Shader> m_depthShader;
+  ShadowFrame m_rendered; // Matrices of what the maps hold, the caster lists are not kept
+  std::array<std::string, Config::Renderer::SHADOW_CASCADES> m_matrixNames;
+  std::array<std::string, Config::Renderer::SHADOW_CASCADES> m_farDepthNames;
+  std::array<std::string, Config::Renderer::SHADOW_CASCADES> m_texelSizeNames;
+
+  /// Orthographic view of a sphere from the sun, snapped to whole texels of the cascade.
+  static glm::mat4 fitCascade(const glm::vec3 &sunDirection, const glm::vec3 &center, float radius);
+};
+
+} // namespace App
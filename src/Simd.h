@@ -0,0 +1,170 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define APP_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define APP_SIMD_SSE2 0
+#include <algorithm>
+#endif
+
+namespace Simd {
+
+/// Four packed floats. Maps to SSE2 on x86 and to plain arrays elsewhere, so callers are written once.
+struct Float4 {
+#if APP_SIMD_SSE2
+  __m128 v;
+
+  Float4() : v(_mm_setzero_ps()) {
+  }
+
+  explicit Float4(const __m128 value) : v(value) {
+  }
+
+  explicit Float4(const float value) : v(_mm_set1_ps(value)) {
+  }
+
+  Float4(const float a, const float b, const float c, const float d) : v(_mm_setr_ps(a, b, c, d)) {
+  }
+
+  static Float4 load(const float *source) {
+    return Float4(_mm_loadu_ps(source));
+  }
+
+  void store(float *target) const {
+    _mm_storeu_ps(target, v);
+  }
+
+  friend Float4 operator+(const Float4 a, const Float4 b) {
+    return Float4(_mm_add_ps(a.v, b.v));
+  }
+
+  friend Float4 operator-(const Float4 a, const Float4 b) {
+    return Float4(_mm_sub_ps(a.v, b.v));
+  }
+
+  friend Float4 operator*(const Float4 a, const Float4 b) {
+    return Float4(_mm_mul_ps(a.v, b.v));
+  }
+
+  friend Float4 operator/(const Float4 a, const Float4 b) {
+    return Float4(_mm_div_ps(a.v, b.v));
+  }
+
+  friend Float4 min(const Float4 a, const Float4 b) {
+    return Float4(_mm_min_ps(a.v, b.v));
+  }
+
+  friend Float4 max(const Float4 a, const Float4 b) {
+    return Float4(_mm_max_ps(a.v, b.v));
+  }
+
+  /// Lane mask, all bits set where a >= b.
+  friend Float4 greaterEqual(const Float4 a, const Float4 b) {
+    return Float4(_mm_cmpge_ps(a.v, b.v));
+  }
+
+  friend Float4 lessEqual(const Float4 a, const Float4 b) {
+    return Float4(_mm_cmple_ps(a.v, b.v));
+  }
+
+  /// Combines lane masks, not meant for arbitrary values.
+  friend Float4 operator&(const Float4 a, const Float4 b) {
+    return Float4(_mm_and_ps(a.v, b.v));
+  }
+
+  /// Picks `ifTrue` where the mask lanes are set and `ifFalse` elsewhere.
+  friend Float4 select(const Float4 mask, const Float4 ifTrue, const Float4 ifFalse) {
+    return Float4(_mm_or_ps(_mm_and_ps(mask.v, ifTrue.v), _mm_andnot_ps(mask.v, ifFalse.v)));
+  }
+
+  /// One bit per lane of a mask, lane 0 in bit 0.
+  [[nodiscard]] int maskBits() const {
+    return _mm_movemask_ps(v);
+  }
+
+  [[nodiscard]] float horizontalMax() const {
+    const __m128 high = _mm_movehl_ps(v, v);
+    const __m128 pairs = _mm_max_ps(v, high);
+    return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+  }
+#else
+  float v[4];
+
+  Float4() : v{0.0f, 0.0f, 0.0f, 0.0f} {
+  }
+
+  explicit Float4(const float value) : v{value, value, value, value} {
+  }
+
+  Float4(const float a, const float b, const float c, const float d) : v{a, b, c, d} {
+  }
+
+  static Float4 load(const float *source) {
+    return {source[0], source[1], source[2], source[3]};
+  }
+
+  void store(float *target) const {
+    std::copy(v, v + 4, target);
+  }
+
+  template <class Op> static Float4 map(const Float4 a, const Float4 b, Op op) {
+    return {op(a.v[0], b.v[0]), op(a.v[1], b.v[1]), op(a.v[2], b.v[2]), op(a.v[3], b.v[3])};
+  }
+
+  static float maskLane(const bool set) {
+    return set ? -1.0f : 0.0f; // Only the sign bit is ever read back
+  }
+
+  friend Float4 operator+(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x + y; });
+  }
+
+  friend Float4 operator-(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x - y; });
+  }
+
+  friend Float4 operator*(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x * y; });
+  }
+
+  friend Float4 operator/(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x / y; });
+  }
+
+  friend Float4 min(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x < y ? x : y; });
+  }
+
+  friend Float4 max(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return x > y ? x : y; });
+  }
+
+  friend Float4 greaterEqual(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return maskLane(x >= y); });
+  }
+
+  friend Float4 lessEqual(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return maskLane(x <= y); });
+  }
+
+  friend Float4 operator&(const Float4 a, const Float4 b) {
+    return map(a, b, [](const float x, const float y) { return maskLane(x < 0.0f && y < 0.0f); });
+  }
+
+  friend Float4 select(const Float4 mask, const Float4 ifTrue, const Float4 ifFalse) {
+    return {mask.v[0] < 0.0f ? ifTrue.v[0] : ifFalse.v[0], mask.v[1] < 0.0f ? ifTrue.v[1] : ifFalse.v[1],
+            mask.v[2] < 0.0f ? ifTrue.v[2] : ifFalse.v[2], mask.v[3] < 0.0f ? ifTrue.v[3] : ifFalse.v[3]};
+  }
+
+  [[nodiscard]] int maskBits() const {
+    return (v[0] < 0.0f) | (v[1] < 0.0f) << 1 | (v[2] < 0.0f) << 2 | (v[3] < 0.0f) << 3;
+  }
+
+  [[nodiscard]] float horizontalMax() const {
+    return std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+  }
+#endif
+};
+
+} // namespace Simd
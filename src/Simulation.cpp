@@ -0,0 +1,148 @@
+#include "Simulation.h"
+
+#include <algorithm>
+
+#include "Config.h"
+#include "Profiler.h"
+
+namespace App {
+
+Simulation::Simulation() : m_ticksPerSecond(Config::Simulation::TICKS_PER_SECOND) {
+  m_published.currentTime = Clock::now();
+}
+
+Simulation::Clock::duration Simulation::tickDuration() const {
+  return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_ticksPerSecond));
+}
+
+void Simulation::update(const DeltaTime frameDelta) {
+  if (isThreaded()) {
+    return;
+  }
+
+  const Clock::duration step = tickDuration();
+  const DeltaTime stepSeconds = std::chrono::duration<DeltaTime>(step).count();
+  const DeltaTime maxBacklog = stepSeconds * Config::Simulation::MAX_TICKS_PER_UPDATE;
+
+  m_accumulator += frameDelta;
+
+  if (m_accumulator > maxBacklog) {
+    const std::lock_guard lock(m_mutex);
+    m_stats.droppedTicks += static_cast<uint64_t>((m_accumulator - maxBacklog) / stepSeconds);
+    m_accumulator = maxBacklog;
+  }
+
+  const Clock::time_point now = Clock::now();
+
+  while (m_accumulator >= stepSeconds) {
+    m_accumulator -= stepSeconds;
+    tick(now - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<DeltaTime>(m_accumulator)));
+  }
+}
+
+void Simulation::tick(const Clock::time_point due) {
+  PROFILE_SCOPE("Simulation tick");
+  const int64_t startNs = Profiler::nowNs();
+  const DeltaTime stepSeconds = 1.0f / static_cast<DeltaTime>(m_ticksPerSecond);
+
+  SimulationInput input;
+  SimulationState previous = m_state;
+
+  {
+    const std::lock_guard lock(m_mutex);
+    input = m_input;
+
+    if (m_teleport) {
+      m_state.playerPosition = *m_teleport;
+      previous.playerPosition = *m_teleport;
+      m_teleport.reset();
+    }
+  }
+
+  m_state.tick++;
+  m_state.playerPosition += input.playerVelocity * stepSeconds;
+
+  const std::lock_guard lock(m_mutex);
+  m_published = {previous, m_state, due};
+  m_stats.ticks++;
+  m_stats.lastTickMs = static_cast<float>(Profiler::nowNs() - startNs) / 1e6f;
+}
+
+void Simulation::run(const std::stop_token &stopToken) {
+  Profiler::setThreadName("Simulation");
+  Clock::time_point due = Clock::now();
+
+  while (!stopToken.stop_requested()) {
+    std::this_thread::sleep_until(due);
+
+    const Clock::duration step = tickDuration();
+    const Clock::time_point now = Clock::now();
+
+    // Too far behind to catch up without a burst of ticks, resume from now instead
+    if (now - due > step * Config::Simulation::MAX_TICKS_PER_UPDATE) {
+      const std::lock_guard lock(m_mutex);
+      m_stats.droppedTicks += static_cast<uint64_t>((now - due) / step);
+      due = now;
+    }
+
+    while (due <= now && !stopToken.stop_requested()) {
+      tick(due);
+      due += step;
+    }
+  }
+}
+
+void Simulation::setInput(const SimulationInput &input) {
+  const std::lock_guard lock(m_mutex);
+  m_input = input;
+}
+
+void Simulation::teleport(const glm::vec3 &position) {
+  const std::lock_guard lock(m_mutex);
+  m_teleport = position;
+  m_published.previous.playerPosition = position;
+  m_published.current.playerPosition = position;
+}
+
+SimulationState Simulation::interpolate() const {
+  Snapshots snapshots;
+
+  {
+    const std::lock_guard lock(m_mutex);
+    snapshots = m_published;
+  }
+
+  const float alpha = std::clamp(std::chrono::duration<float>(Clock::now() - snapshots.currentTime) /
+                                     std::chrono::duration<float>(tickDuration()),
+                                 0.0f, 1.0f);
+
+  return {
+      .tick = snapshots.current.tick,
+      .playerPosition = glm::mix(snapshots.previous.playerPosition, snapshots.current.playerPosition, alpha),
+  };
+}
+
+SimulationStats Simulation::getStats() const {
+  const std::lock_guard lock(m_mutex);
+  return m_stats;
+}
+
+void Simulation::setThreaded(const bool threaded) {
+  if (threaded == isThreaded()) {
+    return;
+  }
+
+  if (threaded) {
+    m_accumulator = 0.0f;
+    m_thread = std::jthread([this](const std::stop_token &stopToken) { run(stopToken); });
+  } else {
+    m_thread.request_stop();
+    m_thread.join();
+  }
+}
+
+void Simulation::setTickRate(const int ticksPerSecond) {
+  m_ticksPerSecond = std::max(ticksPerSecond, 1);
+}
+
+} // namespace App
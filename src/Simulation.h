@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "Time.h"
+
+namespace App {
+
+/// What the player asks for, sampled every frame and consumed by the next tick.
+struct SimulationInput {
+  glm::vec3 playerVelocity{0.0f}; // In blocks per second
+};
+
+struct SimulationState {
+  uint64_t tick = 0;
+  glm::vec3 playerPosition{0.0f};
+};
+
+struct SimulationStats {
+  uint64_t ticks = 0;
+  float lastTickMs = 0.0f;
+  uint64_t droppedTicks = 0; // Skipped because the simulation fell too far behind
+};
+
+/// Advances the game state at a fixed tick rate, independent of the frame rate. Each tick publishes the previous and
+/// the new state together, renderers interpolate between them for the current time.
+///
+/// Ticks run either from `update` on the calling thread, driven by the frame delta, or on a thread of their own so a
+/// heavy tick never stalls a frame.
+class Simulation {
+public:
+  Simulation();
+
+  Simulation(const Simulation &) = delete;
+  Simulation &operator=(const Simulation &) = delete;
+
+  /// Runs the ticks due after `frameDelta` more seconds. Does nothing while the simulation runs on its own thread.
+  void update(DeltaTime frameDelta);
+
+  void setInput(const SimulationInput &input);
+
+  /// Moves the player without interpolating from its previous position.
+  void teleport(const glm::vec3 &position);
+
+  /// State between the last two ticks, as far from the previous one as the current time is from the last tick.
+  [[nodiscard]] SimulationState interpolate() const;
+
+  [[nodiscard]] SimulationStats getStats() const;
+
+  [[nodiscard]] bool isThreaded() const {
+    return m_thread.joinable();
+  }
+
+  void setThreaded(bool threaded);
+
+  [[nodiscard]] int getTickRate() const {
+    return m_ticksPerSecond;
+  }
+
+  void setTickRate(int ticksPerSecond);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Snapshots {
+    SimulationState previous;
+    SimulationState current;
+    Clock::time_point currentTime; // When `current` was due
+  };
+
+  std::atomic<int> m_ticksPerSecond;
+
+  // Owned by whichever thread runs the ticks
+  SimulationState m_state;
+  DeltaTime m_accumulator = 0.0f;
+
+  // Shared with the ticking thread
+  mutable std::mutex m_mutex;
+  SimulationInput m_input;
+  std::optional<glm::vec3> m_teleport;
+  Snapshots m_published;
+  SimulationStats m_stats;
+
+  std::jthread m_thread; // Last, so it is stopped and joined before the state it ticks is destroyed
+
+  [[nodiscard]] Clock::duration tickDuration() const;
+
+  void tick(Clock::time_point due);
+  void run(const std::stop_token &stopToken);
+};
+
+} // namespace App
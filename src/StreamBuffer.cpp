@@ -0,0 +1,175 @@
+#include "StreamBuffer.h"
+
+#include <cstring>
+#include <string_view>
+
+#include "Profiler.h"
+
+// GL_ARB_buffer_storage, core in 4.4. glad was generated for 3.3 and has none of it
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// GL_ARB_texture_buffer_range, core in 4.3
+#ifndef GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT
+#define GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT 0x919F
+#endif
+
+namespace App {
+
+using BufferStorageProc = void(APIENTRYP)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+using TexBufferRangeProc = void(APIENTRYP)(GLenum target, GLenum internalFormat, GLuint buffer, GLintptr offset,
+                                           GLsizeiptr size);
+
+namespace {
+BufferStorageProc bufferStorage = nullptr;
+TexBufferRangeProc texBufferRange = nullptr;
+
+/// Offsets are rounded up to this within a region, the largest uniform buffer offset alignment drivers ask for.
+constexpr std::size_t REGION_ALIGNMENT = 256;
+
+std::size_t textureBufferOffsetAlignment = REGION_ALIGNMENT;
+} // namespace
+
+void StreamBuffer::loadExtensions(const GLADloadproc load) {
+  GLint extensionCount = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+  for (GLint i = 0; i < extensionCount; i++) {
+    const auto *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+
+    if (!name) {
+      continue;
+    }
+
+    if (std::string_view(name) == "GL_ARB_buffer_storage") {
+      bufferStorage = reinterpret_cast<BufferStorageProc>(load("glBufferStorage"));
+    } else if (std::string_view(name) == "GL_ARB_texture_buffer_range") {
+      texBufferRange = reinterpret_cast<TexBufferRangeProc>(load("glTexBufferRange"));
+    }
+  }
+
+  if (texBufferRange) {
+    GLint alignment = 0;
+    glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    textureBufferOffsetAlignment = alignment > 0 ? static_cast<std::size_t>(alignment) : REGION_ALIGNMENT;
+  }
+}
+
+bool StreamBuffer::hasBufferStorage() {
+  return bufferStorage != nullptr;
+}
+
+bool StreamBuffer::hasTextureBufferRange() {
+  return texBufferRange != nullptr;
+}
+
+std::size_t StreamBuffer::textureBufferAlignment() {
+  return textureBufferOffsetAlignment;
+}
+
+StreamBuffer::StreamBuffer(const std::size_t bytesPerFrame, const std::size_t frames)
+    : m_regionBytes((bytesPerFrame + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT),
+      m_fences(frames, nullptr) {
+  const auto totalBytes = static_cast<GLsizeiptr>(m_regionBytes * frames);
+
+  // Through the copy target, binding it anywhere else could change a VAO
+  glGenBuffers(1, &m_buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+
+  if (bufferStorage) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    bufferStorage(GL_COPY_WRITE_BUFFER, totalBytes, nullptr, flags);
+    m_mapped = static_cast<std::byte *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalBytes, flags));
+  } else {
+    glBufferData(GL_COPY_WRITE_BUFFER, totalBytes, nullptr, GL_STREAM_DRAW);
+  }
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  m_stats.capacityBytes = m_regionBytes;
+  m_gpuMemory.set(static_cast<std::size_t>(totalBytes));
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (const GLsync fence : m_fences) {
+    if (fence) {
+      glDeleteSync(fence);
+    }
+  }
+
+  if (m_mapped) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
+
+  if (m_buffer) {
+    glDeleteBuffers(1, &m_buffer);
+  }
+}
+
+void StreamBuffer::beginFrame() {
+  m_region = (m_region + 1) % m_fences.size();
+  m_cursor = 0;
+
+  GLsync &fence = m_fences[m_region];
+
+  if (!fence) {
+    return;
+  }
+
+  // Usually signalled long ago, a frame in flight per region is what the ring is sized for
+  if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+    PROFILE_SCOPE("Wait for stream buffer");
+    m_stats.stalls++;
+
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000) == GL_TIMEOUT_EXPIRED) {
+    }
+  }
+
+  glDeleteSync(fence);
+  fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+  m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_stats.usedBytes = m_cursor;
+}
+
+std::optional<GLintptr> StreamBuffer::write(const void *data, const std::size_t bytes, const std::size_t alignment) {
+  // Aligned within the whole buffer, binding offsets and vertex indices count from its start
+  const std::size_t regionStart = m_region * m_regionBytes;
+  const std::size_t offset = (regionStart + m_cursor + alignment - 1) / alignment * alignment;
+
+  if (offset + bytes > regionStart + m_regionBytes) {
+    m_stats.overflows++;
+    return std::nullopt;
+  }
+
+  m_cursor = offset + bytes - regionStart;
+
+  if (m_mapped) {
+    std::memcpy(m_mapped + offset, data, bytes);
+  } else if (bytes > 0) {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    void *range = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+                                   static_cast<GLsizeiptr>(bytes), flags);
+    std::memcpy(range, data, bytes);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
+
+  return static_cast<GLintptr>(offset);
+}
+
+void StreamBuffer::attachTexture(const GLuint texture, const GLenum format, const GLintptr offset,
+                                 const std::size_t bytes) const {
+  glBindTexture(GL_TEXTURE_BUFFER, texture);
+  texBufferRange(GL_TEXTURE_BUFFER, format, m_buffer, offset, static_cast<GLsizeiptr>(bytes));
+  glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+} // namespace App
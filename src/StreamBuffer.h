@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Config.h"
+#include "MemoryAccounting.h"
+
+namespace App {
+
+struct StreamBufferStats {
+  std::size_t usedBytes = 0;     // By the last frame
+  std::size_t capacityBytes = 0; // Per frame
+  std::size_t overflows = 0;     // Writes that didn't fit, since creation
+  std::size_t stalls = 0;        // Frames that had to wait for the GPU to release their region, since creation
+};
+
+/// Ring buffer for data written every frame and read by that frame's draws: instance data, uniform block ranges,
+/// debug geometry. The buffer is split into one region per frame in flight. A frame only writes into its own region,
+/// and a fence placed behind its commands tells when the GPU is done with it, so the CPU never waits on a draw it
+/// has just submitted and the driver never has to copy or rename the storage.
+///
+/// With GL_ARB_buffer_storage the whole buffer stays mapped (persistent, coherent) and a write is a memcpy. Without
+/// it each write maps its range unsynchronized, the fences being what makes that safe.
+///
+/// With GL_ARB_texture_buffer_range, buffer textures can read a frame's writes in place (see `attachTexture`).
+class StreamBuffer {
+public:
+  /// Picks up glBufferStorage and glTexBufferRange where the driver has them, glad only loads OpenGL 3.3. Call once
+  /// after glad.
+  static void loadExtensions(GLADloadproc load);
+
+  [[nodiscard]] static bool hasBufferStorage();
+
+  [[nodiscard]] static bool hasTextureBufferRange();
+
+  /// What offsets of ranges attached to buffer textures must be multiples of.
+  [[nodiscard]] static std::size_t textureBufferAlignment();
+
+  explicit StreamBuffer(std::size_t bytesPerFrame, std::size_t frames = Config::Renderer::STREAM_BUFFER_FRAMES);
+  ~StreamBuffer();
+
+  StreamBuffer(const StreamBuffer &) = delete;
+  StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+  /// Moves on to the next region, waiting if the GPU still reads the frame that used it last.
+  void beginFrame();
+
+  /// Fences the region behind the commands submitted so far.
+  void endFrame();
+
+  /// Copies `bytes` into this frame's region and returns their offset in the buffer, nothing once the region is full.
+  /// Offsets are multiples of `alignment`, which need not be a power of two (vertex strides aren't).
+  std::optional<GLintptr> write(const void *data, std::size_t bytes, std::size_t alignment = 16);
+
+  template <class T> std::optional<GLintptr> write(std::span<const T> data, const std::size_t alignment = alignof(T)) {
+    return write(data.data(), data.size_bytes(), alignment);
+  }
+
+  /// Points a buffer texture at `bytes` (not zero) written at `offset` this frame, until it is pointed elsewhere.
+  /// Needs `hasTextureBufferRange`, and `offset` aligned to `textureBufferAlignment`.
+  void attachTexture(GLuint texture, GLenum format, GLintptr offset, std::size_t bytes) const;
+
+  [[nodiscard]] GLuint getBuffer() const {
+    return m_buffer;
+  }
+
+  [[nodiscard]] bool isPersistent() const {
+    return m_mapped != nullptr;
+  }
+
+  [[nodiscard]] const StreamBufferStats &getStats() const {
+    return m_stats;
+  }
+
+private:
+  GLuint m_buffer = 0;
+  std::byte *m_mapped = nullptr; // Whole buffer, while persistently mapped
+  std::size_t m_regionBytes;
+  std::vector<GLsync> m_fences; // One per region, null until its first frame ended
+  std::size_t m_region = 0;
+  std::size_t m_cursor = 0; // Within the region
+  StreamBufferStats m_stats;
+  TrackedMemory m_gpuMemory{MemoryTag::Streaming, MemoryPool::Gpu};
+};
+
+} // namespace App
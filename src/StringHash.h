@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// Lets string keyed maps be searched with a string_view or a literal, without building a std::string per lookup.
+struct StringHash {
+  using is_transparent = void;
+
+  std::size_t operator()(const std::string_view value) const {
+    return std::hash<std::string_view>{}(value);
+  }
+};
+
+template <class T> using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
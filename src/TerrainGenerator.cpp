@@ -0,0 +1,75 @@
+#include "TerrainGenerator.h"
+
+#include <cmath>
+
+TerrainGenerator::TerrainGenerator(const unsigned int seed) : m_seed(seed) {
+}
+
+void TerrainGenerator::generate(Chunk &chunk) const {
+  const glm::ivec3 origin = chunk.getWorldOrigin();
+  constexpr int seaLevel = App::Config::World::SEA_LEVEL;
+
+  for (int z = 0; z < Chunk::SIZE; z++) {
+    for (int x = 0; x < Chunk::SIZE; x++) {
+      const int height = heightAt(origin.x + x, origin.z + z);
+
+      for (int y = 0; y < Chunk::SIZE; y++) {
+        const int worldY = origin.y + y;
+        BlockType type = BlockType::Air;
+
+        if (worldY < height - 3) {
+          type = BlockType::Stone;
+        } else if (worldY < height) {
+          type = height <= seaLevel + 1 ? BlockType::Sand : BlockType::Dirt;
+        } else if (worldY == height) {
+          type = height <= seaLevel + 1 ? BlockType::Sand : BlockType::Grass;
+        } else if (worldY <= seaLevel) {
+          type = BlockType::Water;
+        }
+
+        chunk.set(x, y, z, type);
+      }
+    }
+  }
+}
+
+int TerrainGenerator::heightAt(const int worldX, const int worldZ) const {
+  float amplitude = 1.0f;
+  float frequency = 1.0f / 64.0f;
+  float noise = 0.0f;
+  float amplitudeSum = 0.0f;
+
+  for (int octave = 0; octave < 4; octave++) {
+    noise += amplitude * valueNoise(static_cast<float>(worldX) * frequency, static_cast<float>(worldZ) * frequency);
+    amplitudeSum += amplitude;
+    amplitude *= 0.5f;
+    frequency *= 2.0f;
+  }
+
+  // Maps [0, 1] noise to roughly [-16, 16] blocks around the origin
+  return static_cast<int>(std::floor(noise / amplitudeSum * 32.0f)) - 16;
+}
+
+float TerrainGenerator::valueNoise(const float x, const float z) const {
+  const float cellX = std::floor(x);
+  const float cellZ = std::floor(z);
+  const int ix = static_cast<int>(cellX);
+  const int iz = static_cast<int>(cellZ);
+
+  // Smoothstep the fractional part to hide the lattice
+  const float tx = (x - cellX) * (x - cellX) * (3.0f - 2.0f * (x - cellX));
+  const float tz = (z - cellZ) * (z - cellZ) * (3.0f - 2.0f * (z - cellZ));
+
+  const float top = glm::mix(latticeValue(ix, iz), latticeValue(ix + 1, iz), tx);
+  const float bottom = glm::mix(latticeValue(ix, iz + 1), latticeValue(ix + 1, iz + 1), tx);
+
+  return glm::mix(top, bottom, tz);
+}
+
+float TerrainGenerator::latticeValue(const int x, const int z) const {
+  auto hash = static_cast<unsigned int>(x) * 374761393u + static_cast<unsigned int>(z) * 668265263u + m_seed;
+  hash = (hash ^ (hash >> 13)) * 1274126177u;
+  hash ^= hash >> 16;
+
+  return static_cast<float>(hash & 0xFFFFu) / 65535.0f;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Chunk.h"
+
+/// Fills chunks with a heightmap terrain built from a few octaves of value noise.
+class TerrainGenerator {
+public:
+  explicit TerrainGenerator(unsigned int seed);
+
+  void generate(Chunk &chunk) const;
+
+  [[nodiscard]] int heightAt(int worldX, int worldZ) const;
+
+private:
+  unsigned int m_seed;
+
+  [[nodiscard]] float valueNoise(float x, float z) const;
+  [[nodiscard]] float latticeValue(int x, int z) const;
+};
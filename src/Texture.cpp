@@ -52,6 +52,7 @@ void Texture::load() {
 
   glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
   glGenerateMipmap(GL_TEXTURE_2D);
+  m_gpuMemory.set(App::MemoryAccounting::textureBytes(width, height, static_cast<std::size_t>(channels), true));
 
   stbi_image_free(data);
 
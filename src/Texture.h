@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "MemoryAccounting.h"
+
 class Texture {
 public:
   explicit Texture(std::string path);
@@ -13,6 +15,7 @@ public:
 private:
   unsigned int m_id;
   std::string m_path;
+  App::TrackedMemory m_gpuMemory{App::MemoryTag::Textures, App::MemoryPool::Gpu};
 
   void free() const;
 };
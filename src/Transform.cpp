@@ -1,111 +1,130 @@
 #include "Transform.h"
 
-Transform::Transform()
-    : m_localPosition(0.0f), m_localRotation(glm::vec3(0.0f)), m_localScale(1.0f), m_parent(nullptr),
-      m_modelMatrix(1.0f), m_isDirty(true) {
+#include <utility>
+
+namespace {
+TransformSystem &transforms() {
+  return TransformSystem::getInstance();
 }
+} // namespace
 
-void Transform::SetDirty() {
-  // If we are already dirty, no need to recurse,
-  // BUT children might assume their parent is clean if we don't signal.
-  // Simple approach: Always flag self and recurse down.
-  if (!m_isDirty) {
-    m_isDirty = true;
-    for (Transform *child : m_children) {
-      child->SetDirty();
-    }
+Transform::Transform() : m_slot(transforms().create(this)) {
+}
+
+Transform::~Transform() {
+  if (m_slot != TransformSystem::NONE) {
+    transforms().destroy(m_slot);
   }
 }
 
-glm::mat4 Transform::GetLocalModelMatrix() const {
-  const glm::mat4 translation = glm::translate(glm::mat4(1.0f), m_localPosition);
-  const glm::mat4 rotation = glm::mat4_cast(m_localRotation);
-  const glm::mat4 scale = glm::scale(glm::mat4(1.0f), m_localScale);
+Transform::Transform(const Transform &other) : Transform() {
+  *this = other;
+}
 
-  return translation * rotation * scale;
+Transform &Transform::operator=(const Transform &other) {
+  if (this != &other) {
+    TransformSystem &system = transforms();
+    system.localPosition(m_slot) = system.localPosition(other.m_slot);
+    system.localRotation(m_slot) = system.localRotation(other.m_slot);
+    system.localScale(m_slot) = system.localScale(other.m_slot);
+    system.setParent(m_slot, system.parent(other.m_slot));
+    SetDirty();
+  }
+
+  return *this;
 }
 
-const glm::mat4 &Transform::GetModelMatrix() const {
-  if (m_isDirty) {
-    const glm::mat4 localMatrix = GetLocalModelMatrix();
+Transform::Transform(Transform &&other) noexcept : m_slot(std::exchange(other.m_slot, TransformSystem::NONE)) {
+  if (m_slot != TransformSystem::NONE) {
+    transforms().setOwner(m_slot, this);
+  }
+}
 
-    if (m_parent) {
-      m_modelMatrix = m_parent->GetModelMatrix() * localMatrix;
-    } else {
-      m_modelMatrix = localMatrix;
+Transform &Transform::operator=(Transform &&other) noexcept {
+  if (this != &other) {
+    if (m_slot != TransformSystem::NONE) {
+      transforms().destroy(m_slot);
+    }
+
+    m_slot = std::exchange(other.m_slot, TransformSystem::NONE);
+
+    if (m_slot != TransformSystem::NONE) {
+      transforms().setOwner(m_slot, this);
     }
-    m_isDirty = false;
   }
 
-  return m_modelMatrix;
+  return *this;
+}
+
+void Transform::SetDirty() {
+  transforms().markDirty(m_slot);
+}
+
+const glm::mat4 &Transform::GetModelMatrix() const {
+  TransformSystem &system = transforms();
+
+  if (system.isStale(m_slot)) {
+    system.update();
+  }
+
+  return system.worldMatrix(m_slot);
 }
 
 // --- Hierarchy ---
 
 void Transform::SetParent(Transform *parent, const bool keepWorldTransform) {
-  if (m_parent == parent)
+  if (GetParent() == parent)
     return;
 
+  const TransformSystem::Slot parentSlot = parent ? parent->m_slot : TransformSystem::NONE;
+
   // Logic to maintain world position despite new parent
   if (keepWorldTransform) {
     const glm::vec3 worldPos = GetPosition();
     const glm::quat worldRot = GetRotation();
     // Scale is tricky, usually ignored or approximations used in simple engines
 
-    // Remove self from old parent
-    if (m_parent) {
-      auto &siblings = m_parent->m_children;
-      std::erase(siblings, this);
-    }
-
-    m_parent = parent;
-
-    if (m_parent) {
-      m_parent->m_children.push_back(this);
-
-      // Convert World to New Local
-      // NewLocal = Inv(ParentWorld) * World
-      glm::mat4 parentModelInv = glm::inverse(m_parent->GetModelMatrix());
-      glm::vec3 newLocalPos = glm::vec3(parentModelInv * glm::vec4(worldPos, 1.0f));
+    transforms().setParent(m_slot, parentSlot);
 
-      SetLocalPosition(newLocalPos);
-      // Rotation is slightly more complex, simplified here:
-      SetRotation(worldRot);
-    } else {
-      // Unparenting (Becoming root)
-      SetLocalPosition(worldPos);
-      SetRotation(worldRot);
-    }
+    // Convert World to New Local
+    SetPosition(worldPos);
+    SetRotation(worldRot);
   } else {
     // Just swap parent, keeping local transforms (object will jump)
-    if (m_parent) {
-      auto &siblings = m_parent->m_children;
-      std::erase(siblings, this);
-    }
-    m_parent = parent;
-    if (m_parent)
-      m_parent->m_children.push_back(this);
+    transforms().setParent(m_slot, parentSlot);
   }
-  SetDirty();
+}
+
+Transform *Transform::GetParent() const {
+  const TransformSystem &system = transforms();
+  const TransformSystem::Slot parent = system.parent(m_slot);
+  return parent == TransformSystem::NONE ? nullptr : system.owner(parent);
+}
+
+std::vector<Transform *> Transform::GetChildren() const {
+  return transforms().children(m_slot);
 }
 
 // --- Position ---
 
 void Transform::SetLocalPosition(const glm::vec3 &pos) {
-  m_localPosition = pos;
+  transforms().localPosition(m_slot) = pos;
   SetDirty();
 }
 
 void Transform::SetPosition(const glm::vec3 &pos) {
-  if (m_parent) {
+  glm::vec3 localPosition = pos;
+
+  if (const Transform *parent = GetParent()) {
     // Calculate local position relative to parent
     // Local = Inverse(ParentMatrix) * WorldPos
-    glm::mat4 parentMatrix = m_parent->GetModelMatrix();
+    glm::mat4 parentMatrix = parent->GetModelMatrix();
     glm::mat4 inverseParent = glm::inverse(parentMatrix);
-    m_localPosition = glm::vec3(inverseParent * glm::vec4(pos, 1.0f));
-  } else {
-    m_localPosition = pos;
+    localPosition = glm::vec3(inverseParent * glm::vec4(pos, 1.0f));
   }
+
+  // Reading the parent can update the system and move our slot, so it is only looked up now
+  transforms().localPosition(m_slot) = localPosition;
   SetDirty();
 }
 
@@ -116,42 +135,47 @@ glm::vec3 Transform::GetPosition() const {
 // --- Rotation ---
 
 void Transform::SetLocalRotation(const glm::quat &rot) {
-  m_localRotation = rot;
+  transforms().localRotation(m_slot) = rot;
   SetDirty();
 }
 
 void Transform::SetRotation(const glm::quat &rot) {
-  if (m_parent) {
+  glm::quat localRotation = rot;
+
+  if (const Transform *parent = GetParent()) {
     // WorldRot = ParentRot * LocalRot
     // LocalRot = Inverse(ParentRot) * WorldRot
-    const glm::quat parentRot = m_parent->GetRotation();
-    m_localRotation = glm::inverse(parentRot) * rot;
-  } else {
-    m_localRotation = rot;
+    const glm::quat parentRot = parent->GetRotation();
+    localRotation = glm::inverse(parentRot) * rot;
   }
+
+  transforms().localRotation(m_slot) = localRotation;
   SetDirty();
 }
 
 glm::quat Transform::GetRotation() const {
-  if (m_parent) {
-    return m_parent->GetRotation() * m_localRotation;
+  TransformSystem &system = transforms();
+
+  if (system.isStale(m_slot)) {
+    system.update();
   }
-  return m_localRotation;
+
+  return system.worldRotation(m_slot);
 }
 
 void Transform::SetLocalEulerAngles(const glm::vec3 &eulerAngles) {
-  m_localRotation = glm::quat(glm::radians(eulerAngles));
+  transforms().localRotation(m_slot) = glm::quat(glm::radians(eulerAngles));
   SetDirty();
 }
 
 glm::vec3 Transform::GetLocalEulerAngles() const {
-  return glm::degrees(glm::eulerAngles(m_localRotation));
+  return glm::degrees(glm::eulerAngles(GetLocalRotation()));
 }
 
 // --- Scale ---
 
 void Transform::SetLocalScale(const glm::vec3 &scale) {
-  m_localScale = scale;
+  transforms().localScale(m_slot) = scale;
   SetDirty();
 }
 
@@ -172,17 +196,18 @@ glm::vec3 Transform::GetRight() const {
 // --- Operations ---
 
 void Transform::Translate(const glm::vec3 &translation) {
-  m_localPosition += translation;
+  transforms().localPosition(m_slot) += translation;
   SetDirty();
 }
 
 void Transform::Rotate(const glm::vec3 &axis, const float angle) {
-  m_localRotation = glm::rotate(m_localRotation, glm::radians(angle), axis);
+  glm::quat &localRotation = transforms().localRotation(m_slot);
+  localRotation = glm::rotate(localRotation, glm::radians(angle), axis);
   SetDirty();
 }
 
 void Transform::Rotate(const glm::quat &rotation) {
-  m_localRotation = rotation * m_localRotation;
+  transforms().localRotation(m_slot) = rotation * GetLocalRotation();
   SetDirty();
 }
 
@@ -4,24 +4,30 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "TransformSystem.h"
+
+/// Handle to a slot of the TransformSystem, which stores the data and updates world matrices in bulk. A moved-from
+/// transform may only be destroyed or assigned to.
 class Transform final {
 public:
   Transform();
-  ~Transform() = default;
+  ~Transform();
+
+  Transform(const Transform &other);
+  Transform &operator=(const Transform &other);
+
+  Transform(Transform &&other) noexcept;
+  Transform &operator=(Transform &&other) noexcept;
 
   // --- Hierarchy Management ---
   void SetParent(Transform *parent, bool keepWorldTransform = true);
-  Transform *GetParent() const {
-    return m_parent;
-  }
-  const std::vector<Transform *> &GetChildren() const {
-    return m_children;
-  }
+  Transform *GetParent() const;
+  std::vector<Transform *> GetChildren() const;
 
   // --- Position ---
   void SetLocalPosition(const glm::vec3 &pos);
   glm::vec3 GetLocalPosition() const {
-    return m_localPosition;
+    return TransformSystem::getInstance().localPosition(m_slot);
   }
 
   void SetPosition(const glm::vec3 &pos); // World Position
@@ -30,7 +36,7 @@ public:
   // --- Rotation ---
   void SetLocalRotation(const glm::quat &rot);
   glm::quat GetLocalRotation() const {
-    return m_localRotation;
+    return TransformSystem::getInstance().localRotation(m_slot);
   }
 
   void SetRotation(const glm::quat &rot); // World Rotation
@@ -43,7 +49,7 @@ public:
   // --- Scale ---
   void SetLocalScale(const glm::vec3 &scale);
   glm::vec3 GetLocalScale() const {
-    return m_localScale;
+    return TransformSystem::getInstance().localScale(m_slot);
   }
 
   // Note: World scale is complex due to skewing, Unity calls this "lossyScale"
@@ -65,23 +71,11 @@ public:
   void LookAt(const glm::vec3 &target, const glm::vec3 &worldUp = glm::vec3(0, 1, 0));
 
 protected:
-  // Internal method to mark this and all children as dirty
+  // Flags this transform, the system's next update also recomputes its children
   void SetDirty();
 
 private:
-  // Local Space Data
-  glm::vec3 m_localPosition;
-  glm::quat m_localRotation;
-  glm::vec3 m_localScale;
-
-  // Hierarchy
-  Transform *m_parent;
-  std::vector<Transform *> m_children;
-
-  // Cached Model Matrix (Optimization)
-  mutable glm::mat4 m_modelMatrix;
-  mutable bool m_isDirty;
+  friend class TransformSystem; // Moves slots around when sorting
 
-  // Helper to update the matrix if dirty
-  glm::mat4 GetLocalModelMatrix() const;
+  TransformSystem::Slot m_slot;
 };
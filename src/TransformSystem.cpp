@@ -0,0 +1,251 @@
+#include "TransformSystem.h"
+
+#include <type_traits>
+#include <utility>
+
+#include "Transform.h"
+
+namespace {
+/// Below this many holes compacting costs more than walking over them.
+constexpr std::size_t COMPACT_MIN_HOLES = 1024;
+} // namespace
+
+TransformSystem::Slot TransformSystem::create(Transform *owner) {
+  Slot slot;
+
+  if (m_freeSlots.empty()) {
+    slot = static_cast<Slot>(m_owners.size());
+    m_localPositions.emplace_back();
+    m_localRotations.emplace_back();
+    m_localScales.emplace_back();
+    m_parents.emplace_back();
+    m_dirty.emplace_back();
+    m_worldMatrices.emplace_back();
+    m_worldRotations.emplace_back();
+    m_owners.emplace_back();
+    m_childCounts.emplace_back();
+  } else {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+
+  // An identity root is already up to date, creating transforms never costs the next update anything
+  m_localPositions[slot] = glm::vec3(0.0f);
+  m_localRotations[slot] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  m_localScales[slot] = glm::vec3(1.0f);
+  m_parents[slot] = NONE;
+  m_dirty[slot] = 0;
+  m_worldMatrices[slot] = glm::mat4(1.0f);
+  m_worldRotations[slot] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+  m_owners[slot] = owner;
+  m_childCounts[slot] = 0;
+
+  return slot;
+}
+
+void TransformSystem::destroy(const Slot slot) {
+  if (m_childCounts[slot] > 0) {
+    for (Slot i = 0; i < m_owners.size(); i++) {
+      if (m_owners[i] && m_parents[i] == slot) {
+        m_parents[i] = NONE;
+        markDirty(i);
+      }
+    }
+  }
+
+  if (m_parents[slot] != NONE) {
+    m_childCounts[m_parents[slot]]--;
+  }
+
+  m_owners[slot] = nullptr;
+  m_parents[slot] = NONE;
+  m_dirty[slot] = 0;
+  m_childCounts[slot] = 0;
+  m_freeSlots.push_back(slot);
+
+  if (m_freeSlots.size() == m_owners.size()) {
+    m_localPositions.clear();
+    m_localRotations.clear();
+    m_localScales.clear();
+    m_parents.clear();
+    m_dirty.clear();
+    m_worldMatrices.clear();
+    m_worldRotations.clear();
+    m_owners.clear();
+    m_childCounts.clear();
+    m_freeSlots.clear();
+    m_firstDirty = NONE;
+    m_needsSort = false;
+  } else if (m_freeSlots.size() >= COMPACT_MIN_HOLES && m_freeSlots.size() > size()) {
+    m_needsSort = true;
+  }
+}
+
+void TransformSystem::setParent(const Slot slot, const Slot parent) {
+  if (m_parents[slot] == parent) {
+    return;
+  }
+
+  for (Slot ancestor = parent; ancestor != NONE; ancestor = m_parents[ancestor]) {
+    if (ancestor == slot) {
+      return;
+    }
+  }
+
+  if (m_parents[slot] != NONE) {
+    m_childCounts[m_parents[slot]]--;
+  }
+
+  m_parents[slot] = parent;
+
+  if (parent != NONE) {
+    m_childCounts[parent]++;
+    m_needsSort |= parent > slot;
+  }
+
+  markDirty(slot);
+}
+
+std::vector<Transform *> TransformSystem::children(const Slot slot) const {
+  std::vector<Transform *> owners;
+
+  if (m_childCounts[slot] == 0) {
+    return owners;
+  }
+
+  for (Slot i = 0; i < m_owners.size(); i++) {
+    if (m_owners[i] && m_parents[i] == slot) {
+      owners.push_back(m_owners[i]);
+    }
+  }
+
+  return owners;
+}
+
+void TransformSystem::update() {
+  if (m_needsSort) {
+    sort();
+  }
+
+  const auto count = static_cast<Slot>(m_owners.size());
+
+  // Dirtiness flows down first. Parents come before their children, so one pass reaches every descendant
+  for (Slot i = m_firstDirty; i < count; i++) {
+    if (const Slot parent = m_parents[i]; parent != NONE) {
+      m_dirty[i] |= m_dirty[parent];
+    }
+  }
+
+  for (Slot i = m_firstDirty; i < count; i++) {
+    if (!m_dirty[i]) {
+      continue;
+    }
+
+    // Same as translate * rotate * scale, without the two matrix products
+    glm::mat4 local = glm::mat4_cast(m_localRotations[i]);
+    local[0] *= m_localScales[i].x;
+    local[1] *= m_localScales[i].y;
+    local[2] *= m_localScales[i].z;
+    local[3] = glm::vec4(m_localPositions[i], 1.0f);
+
+    if (const Slot parent = m_parents[i]; parent != NONE) {
+      m_worldMatrices[i] = m_worldMatrices[parent] * local;
+      m_worldRotations[i] = m_worldRotations[parent] * m_localRotations[i];
+    } else {
+      m_worldMatrices[i] = local;
+      m_worldRotations[i] = m_localRotations[i];
+    }
+
+    m_dirty[i] = 0;
+  }
+
+  m_firstDirty = NONE;
+}
+
+void TransformSystem::sort() {
+  const auto count = static_cast<Slot>(m_owners.size());
+
+  // Children of every slot, grouped by parent
+  std::vector<Slot> childOffsets(count + 1, 0);
+
+  for (Slot i = 0; i < count; i++) {
+    if (m_owners[i] && m_parents[i] != NONE) {
+      childOffsets[m_parents[i] + 1]++;
+    }
+  }
+
+  for (Slot i = 0; i < count; i++) {
+    childOffsets[i + 1] += childOffsets[i];
+  }
+
+  std::vector<Slot> children(childOffsets[count]);
+  std::vector<Slot> cursor(childOffsets.begin(), childOffsets.end() - 1);
+
+  for (Slot i = 0; i < count; i++) {
+    if (m_owners[i] && m_parents[i] != NONE) {
+      children[cursor[m_parents[i]]++] = i;
+    }
+  }
+
+  // Depth first from every root, which also keeps each subtree contiguous
+  std::vector<Slot> order;
+  order.reserve(size());
+  std::vector<Slot> stack;
+
+  for (Slot root = 0; root < count; root++) {
+    if (!m_owners[root] || m_parents[root] != NONE) {
+      continue;
+    }
+
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+      const Slot slot = stack.back();
+      stack.pop_back();
+      order.push_back(slot);
+
+      for (Slot child = childOffsets[slot + 1]; child > childOffsets[slot]; child--) {
+        stack.push_back(children[child - 1]);
+      }
+    }
+  }
+
+  std::vector<Slot> newSlots(count, NONE);
+
+  for (Slot i = 0; i < order.size(); i++) {
+    newSlots[order[i]] = i;
+  }
+
+  const auto permute = [&](auto &values) {
+    std::remove_reference_t<decltype(values)> sorted;
+    sorted.reserve(order.size());
+
+    for (const Slot slot : order) {
+      sorted.push_back(values[slot]);
+    }
+
+    values = std::move(sorted);
+  };
+
+  permute(m_localPositions);
+  permute(m_localRotations);
+  permute(m_localScales);
+  permute(m_parents);
+  permute(m_dirty);
+  permute(m_worldMatrices);
+  permute(m_worldRotations);
+  permute(m_owners);
+  permute(m_childCounts);
+
+  for (Slot i = 0; i < order.size(); i++) {
+    if (m_parents[i] != NONE) {
+      m_parents[i] = newSlots[m_parents[i]];
+    }
+
+    m_owners[i]->m_slot = i;
+  }
+
+  m_freeSlots.clear();
+  m_firstDirty = 0; // Dirty slots moved, let the update find them again
+  m_needsSort = false;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+class Transform;
+
+/// Owns the data of every Transform, one slot per transform in parallel arrays. Slots are kept in parent-before-child
+/// order, so dirty world matrices and rotations are brought up to date by a single linear pass instead of recursing
+/// through the hierarchy.
+class TransformSystem final {
+public:
+  using Slot = uint32_t;
+  static constexpr Slot NONE = std::numeric_limits<Slot>::max();
+
+  TransformSystem(const TransformSystem &) = delete;
+  TransformSystem &operator=(const TransformSystem &) = delete;
+
+  static TransformSystem &getInstance() {
+    static TransformSystem instance;
+    return instance;
+  }
+
+  /// New root slot with an identity transform.
+  Slot create(Transform *owner);
+
+  /// Frees the slot, its children become roots keeping their local transform. Holes are compacted away by the next
+  /// update once they outnumber the live slots.
+  void destroy(Slot slot);
+
+  /// Reparents `slot`, or makes it a root with NONE. Cycles are refused.
+  void setParent(Slot slot, Slot parent);
+
+  /// Recomputes the world data of every dirty slot and its descendants. Runs once per frame, reads of stale data
+  /// also trigger it.
+  void update();
+
+  /// Whether the world data of `slot` could be out of date.
+  [[nodiscard]] bool isStale(const Slot slot) const {
+    return m_needsSort || m_firstDirty <= slot;
+  }
+
+  void markDirty(const Slot slot) {
+    m_dirty[slot] = 1;
+    m_firstDirty = std::min(m_firstDirty, slot);
+  }
+
+  /// Owners of the children of `slot`. Scans the arrays, only meant for tools.
+  [[nodiscard]] std::vector<Transform *> children(Slot slot) const;
+
+  [[nodiscard]] glm::vec3 &localPosition(const Slot slot) {
+    return m_localPositions[slot];
+  }
+
+  [[nodiscard]] glm::quat &localRotation(const Slot slot) {
+    return m_localRotations[slot];
+  }
+
+  [[nodiscard]] glm::vec3 &localScale(const Slot slot) {
+    return m_localScales[slot];
+  }
+
+  [[nodiscard]] Slot parent(const Slot slot) const {
+    return m_parents[slot];
+  }
+
+  [[nodiscard]] Transform *owner(const Slot slot) const {
+    return m_owners[slot];
+  }
+
+  void setOwner(const Slot slot, Transform *owner) {
+    m_owners[slot] = owner;
+  }
+
+  /// Only valid while the slot isn't stale.
+  [[nodiscard]] const glm::mat4 &worldMatrix(const Slot slot) const {
+    return m_worldMatrices[slot];
+  }
+
+  /// Only valid while the slot isn't stale.
+  [[nodiscard]] const glm::quat &worldRotation(const Slot slot) const {
+    return m_worldRotations[slot];
+  }
+
+  /// Live transforms.
+  [[nodiscard]] std::size_t size() const {
+    return m_owners.size() - m_freeSlots.size();
+  }
+
+private:
+  TransformSystem() = default;
+  ~TransformSystem() = default;
+
+  // Walked by `update`, kept apart so the pass streams through exactly what it needs
+  std::vector<glm::vec3> m_localPositions;
+  std::vector<glm::quat> m_localRotations;
+  std::vector<glm::vec3> m_localScales;
+  std::vector<Slot> m_parents;
+  std::vector<uint8_t> m_dirty;
+  std::vector<glm::mat4> m_worldMatrices;
+  std::vector<glm::quat> m_worldRotations;
+
+  std::vector<Transform *> m_owners; // Null for free slots
+  std::vector<uint32_t> m_childCounts;
+  std::vector<Slot> m_freeSlots;
+
+  Slot m_firstDirty = NONE; // Nothing before it needs an update
+  bool m_needsSort = false; // A child was parented to a later slot, or there are too many holes
+
+  void sort();
+};
@@ -0,0 +1,106 @@
+#include "VoxelRaycaster.h"
+
+#include <bit>
+#include <limits>
+
+static_assert((Chunk::SIZE & (Chunk::SIZE - 1)) == 0, "Chunk lookups below rely on a power of two chunk size");
+
+constexpr int CHUNK_SHIFT = std::countr_zero(static_cast<unsigned int>(Chunk::SIZE));
+constexpr int CHUNK_MASK = Chunk::SIZE - 1;
+
+std::optional<RaycastHit> VoxelRaycaster::cast(const ChunkMap &chunks, const Ray &ray) {
+  ChunkLookupCache cache(chunks);
+  return cast(cache, ray);
+}
+
+void VoxelRaycaster::castBatch(const ChunkMap &chunks, const std::span<const Ray> rays,
+                               const std::span<std::optional<RaycastHit>> hits) {
+  ChunkLookupCache cache(chunks);
+
+  for (std::size_t i = 0; i < rays.size() && i < hits.size(); i++) {
+    hits[i] = cast(cache, rays[i]);
+  }
+}
+
+bool VoxelRaycaster::hasLineOfSight(const ChunkMap &chunks, const glm::vec3 &from, const glm::vec3 &to) {
+  const float distance = glm::length(to - from);
+
+  if (distance <= 0.0f) {
+    return true;
+  }
+
+  return !cast(chunks, {from, (to - from) / distance, distance}).has_value();
+}
+
+std::optional<RaycastHit> VoxelRaycaster::cast(ChunkLookupCache &cache, const Ray &ray) {
+  const float length = glm::length(ray.direction);
+
+  if (length <= 0.0f) {
+    return std::nullopt;
+  }
+
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+  const glm::vec3 direction = ray.direction / length;
+
+  glm::ivec3 cell(glm::floor(ray.origin));
+  glm::ivec3 step(0);
+  glm::vec3 tMax(infinity);   // Ray distance at which the next cell boundary is crossed, per axis
+  glm::vec3 tDelta(infinity); // Ray distance between two cell boundaries, per axis
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (direction[axis] > 0.0f) {
+      step[axis] = 1;
+      tDelta[axis] = 1.0f / direction[axis];
+      tMax[axis] = (static_cast<float>(cell[axis] + 1) - ray.origin[axis]) * tDelta[axis];
+    } else if (direction[axis] < 0.0f) {
+      step[axis] = -1;
+      tDelta[axis] = -1.0f / direction[axis];
+      tMax[axis] = (ray.origin[axis] - static_cast<float>(cell[axis])) * tDelta[axis];
+    }
+  }
+
+  // Starting inside a block reports it as entered through the face pointing back along the ray
+  int enteredAxis = 0;
+
+  for (int axis = 1; axis < 3; axis++) {
+    if (std::abs(direction[axis]) > std::abs(direction[enteredAxis])) {
+      enteredAxis = axis;
+    }
+  }
+
+  glm::ivec3 previous = cell;
+  float distance = 0.0f;
+
+  glm::ivec3 chunkCoord = cell >> CHUNK_SHIFT;
+  const Chunk *chunk = cache.find(chunkCoord);
+
+  while (distance <= ray.maxDistance) {
+    if (const glm::ivec3 cellChunk = cell >> CHUNK_SHIFT; cellChunk != chunkCoord) {
+      chunkCoord = cellChunk;
+      chunk = cache.find(chunkCoord);
+    }
+
+    if (chunk) {
+      const glm::ivec3 local = cell & CHUNK_MASK;
+
+      if (const BlockType type = chunk->get(local.x, local.y, local.z); isOpaque(type)) {
+        // Entering along +axis means going through the negative face of the block, and vice versa
+        const auto face = static_cast<BlockFace>(enteredAxis * 2 + (step[enteredAxis] > 0 ? 0 : 1));
+        return RaycastHit{cell, previous, face, type, distance};
+      }
+    }
+
+    enteredAxis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+
+    if (tMax[enteredAxis] == infinity) {
+      break;
+    }
+
+    previous = cell;
+    cell[enteredAxis] += step[enteredAxis];
+    distance = tMax[enteredAxis];
+    tMax[enteredAxis] += tDelta[enteredAxis];
+  }
+
+  return std::nullopt;
+}
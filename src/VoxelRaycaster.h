@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "ChunkMap.h"
+
+struct Ray {
+  glm::vec3 origin;
+  glm::vec3 direction;
+  float maxDistance;
+};
+
+struct RaycastHit {
+  glm::ivec3 block;    // World position of the block that was hit
+  glm::ivec3 previous; // Last empty cell the ray crossed, where a placed block would go
+  BlockFace face;      // Face of the hit block the ray entered through
+  BlockType type;
+  float distance;
+};
+
+/// Caches chunk pointers by coordinate so consecutive lookups in the same area skip the hash map.
+/// Missing chunks are cached too, as null pointers.
+class ChunkLookupCache {
+public:
+  explicit ChunkLookupCache(const ChunkMap &chunks) : m_chunks(chunks) {
+  }
+
+  [[nodiscard]] const Chunk *find(const glm::ivec3 &coord) {
+    Entry &entry = m_entries[slot(coord)];
+
+    if (!entry.valid || entry.coord != coord) {
+      entry = {coord, m_chunks.find(coord), true};
+    }
+
+    return entry.chunk;
+  }
+
+private:
+  static constexpr std::size_t SLOT_COUNT = 64;
+
+  struct Entry {
+    glm::ivec3 coord{0};
+    const Chunk *chunk = nullptr;
+    bool valid = false;
+  };
+
+  const ChunkMap &m_chunks;
+  std::array<Entry, SLOT_COUNT> m_entries{};
+
+  static std::size_t slot(const glm::ivec3 &coord) {
+    return (coord.x & 3) | (coord.y & 3) << 2 | (coord.z & 3) << 4;
+  }
+};
+
+/// Amanatides-Woo voxel traversal over the loaded chunks. Rays stop at the first opaque block.
+class VoxelRaycaster {
+public:
+  static std::optional<RaycastHit> cast(const ChunkMap &chunks, const Ray &ray);
+
+  /// Casts many rays through one shared chunk cache, rays close to each other (e.g. line-of-sight checks of nearby
+  /// entities) then resolve their chunks without touching the chunk map.
+  static void castBatch(const ChunkMap &chunks, std::span<const Ray> rays, std::span<std::optional<RaycastHit>> hits);
+
+  static bool hasLineOfSight(const ChunkMap &chunks, const glm::vec3 &from, const glm::vec3 &to);
+
+private:
+  static std::optional<RaycastHit> cast(ChunkLookupCache &cache, const Ray &ray);
+};
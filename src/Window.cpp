@@ -1,22 +1,49 @@
 #include "Window.h"
 
+#include <cmath>
 #include <memory>
+#include <optional>
+#include <random>
+#include <vector>
 
 #include <imgui.h>
 
+#include "AllocationCounter.h"
 #include "Container.h"
 #include "Model.h"
 #include "Config.h"
 #include "DummyVAO.h"
+#include "MemoryAccounting.h"
 #include "ModelLoader.h"
+#include "StreamBuffer.h"
+#include "VoxelRaycaster.h"
 
 namespace App {
 
 std::shared_ptr<Model> g_model3d, g_cube;
-Light g_light = Light::Point(glm::vec3(-0.460f, -0.490f, 1.170f), glm::vec4(1.0f));
+Ecs::Entity g_lightEntity;
+std::vector<Ecs::Entity> g_torches;
+uint64_t g_renderAllocations = 0; // Made while submitting the last frame
 
 #define g_lightDirection (glm::normalize(-g_lightPosition))
 
+/// Paces frames for the mode and sets the swap interval of the current context to match. Adaptive vsync falls back to
+/// vsync where the driver has no late swap tearing.
+void setPresentMode(const PresentMode mode) {
+  g_framePacer.setMode(mode);
+
+  if (SDL_GL_SetSwapInterval(FramePacer::swapInterval(mode))) {
+    return;
+  }
+
+  if (mode == PresentMode::AdaptiveVsync) {
+    SPDLOG_WARN("Adaptive vsync is not supported, using vsync: {}", SDL_GetError());
+    SDL_GL_SetSwapInterval(1);
+  } else {
+    SPDLOG_WARN("Couldn't set the swap interval: {}", SDL_GetError());
+  }
+}
+
 SDL_AppResult Window::setup() {
   SDL_SetAppMetadata("Minecraft", "0.1.0", "com.example.minecraft");
 
@@ -62,8 +89,10 @@ SDL_AppResult Window::setup() {
     return SDL_APP_FAILURE;
   }
 
+  StreamBuffer::loadExtensions(openGlProcedureLoader);
+
   SDL_GL_MakeCurrent(m_sdlWindow, m_glContext);
-  SDL_GL_SetSwapInterval(1); // Enable vsync
+  setPresentMode(PresentMode::Vsync);
 
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_BLEND);
@@ -77,14 +106,85 @@ SDL_AppResult Window::setup() {
 
   SPDLOG_INFO("SDL and OpenGL initialized successfully");
 
+  setupScene();
+  g_camera.setActive(false);
+
+  g_simulation.teleport(g_camera.getPosition());
+  g_simulation.setThreaded(Config::Simulation::RUN_ON_THREAD);
+
+  return SDL_APP_CONTINUE;
+}
+
+void Window::setupScene() {
+  g_profiler.setup();
+
   g_model3d = ModelLoader::Load("resources/models/pbr/rusted_sphere/rusted_sphere.obj");
   g_cube = ModelLoader::Load("resources/models/cube/cube.obj");
 
-  g_camera.setActive(false);
   g_floorGrid.setup();
   g_axis.setup();
+  g_clusteredLighting.setup();
+  g_deferredRenderer.setup();
+  g_shadowMaps.setup();
+  g_depthPrepass.setup();
+  g_overdrawHeatmap.setup();
+  g_dynamicResolution.setup();
 
-  return SDL_APP_CONTINUE;
+  g_lightEntity = g_entities.create(Light::Point(glm::vec3(-0.460f, -0.490f, 1.170f), glm::vec4(1.0f)));
+
+  for (const auto &[mesh, material] : g_model3d->getMeshGroups()) {
+    g_entities.create(Ecs::Transform{}, Ecs::MeshRenderer{.mesh = mesh.get(), .material = material.get()});
+  }
+}
+
+/// Scatters point lights over the terrain around the camera, replacing the previous ones.
+void placeTorches(const int count) {
+  constexpr float spread = 96.0f;
+  constexpr auto color = glm::vec4(1.0f, 0.6f, 0.25f, 1.0f);
+
+  for (const Ecs::Entity torch : g_torches) {
+    g_entities.destroy(torch);
+  }
+
+  g_torches.clear();
+
+  std::mt19937 rng(static_cast<uint32_t>(count));
+  std::uniform_real_distribution offset(-spread, spread);
+  const glm::vec3 center = g_camera.getPosition();
+
+  for (int i = 0; i < count; i++) {
+    glm::ivec3 position(std::floor(center.x + offset(rng)), (Config::World::MAX_CHUNK_Y + 1) * Chunk::SIZE - 1,
+                        std::floor(center.z + offset(rng)));
+
+    // Down to the ground, the torch floats a block above it
+    while (position.y > Config::World::MIN_CHUNK_Y * Chunk::SIZE &&
+           !isSolid(g_world.getChunks().getBlock(position))) {
+      position.y--;
+    }
+
+    const glm::vec3 torchPosition = glm::vec3(position) + glm::vec3(0.5f, 1.5f, 0.5f);
+    g_torches.push_back(g_entities.create(Light::Point(torchPosition, color, 1.0f, 1.0f, 0.35f, 0.44f)));
+  }
+}
+
+/// Left click breaks the block under the cursor, middle click places stone against it.
+void editTargetBlock(const Uint8 button) {
+  if (button != SDL_BUTTON_LEFT && button != SDL_BUTTON_MIDDLE) {
+    return;
+  }
+
+  const auto target = VoxelRaycaster::cast(g_world.getChunks(), {g_camera.getPosition(), g_camera.getFront(),
+                                                                  Config::World::PICK_DISTANCE});
+
+  if (!target) {
+    return;
+  }
+
+  if (button == SDL_BUTTON_LEFT) {
+    g_world.setBlock(target->block, BlockType::Air, EditPriority::Immediate);
+  } else {
+    g_world.setBlock(target->previous, BlockType::Stone, EditPriority::Immediate);
+  }
 }
 
 SDL_AppResult Window::processEvent(const SDL_Event *event) {
@@ -106,7 +206,20 @@ SDL_AppResult Window::processEvent(const SDL_Event *event) {
   if (event->type == SDL_EVENT_KEY_DOWN) {
     if (event->key.scancode == SDL_SCANCODE_KP_0) {
       g_camera.reset();
+      g_simulation.teleport(g_camera.getPosition());
+    }
+
+    if (event->key.scancode == SDL_SCANCODE_F9) {
+      g_profiler.exportChromeTrace(Config::Profiler::TRACE_FILE);
     }
+
+    if (event->key.scancode == SDL_SCANCODE_F10) {
+      MemoryAccounting::exportJson(Config::Memory::DUMP_FILE);
+    }
+  }
+
+  if (event->type == SDL_EVENT_MOUSE_BUTTON_DOWN && !g_imguiManager.io().WantCaptureMouse) {
+    editTargetBlock(event->button.button);
   }
 
   return SDL_APP_CONTINUE;
@@ -135,40 +248,36 @@ void Window::dispose() {
 glm::mat4 getProjectionMatrix() {
   const ImGuiIO &io = g_imguiManager.io();
   const auto aspectRatio = io.DisplaySize.x / io.DisplaySize.y;
-  return glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+  return glm::perspective(glm::radians(45.0f), aspectRatio, Config::Renderer::NEAR_PLANE, Config::Renderer::FAR_PLANE);
 }
 
-RenderContext getDefaultRenderContext() {
+glm::ivec2 displaySize() {
+  return {static_cast<int>(g_imguiManager.io().DisplaySize.x), static_cast<int>(g_imguiManager.io().DisplaySize.y)};
+}
+
+FrameView getFrameView() {
   return {
-      .modelMatrix = glm::mat4(1.0f),
       .viewMatrix = g_camera.getViewMatrix(),
       .projectionMatrix = getProjectionMatrix(),
       .cameraPosition = g_camera.getPosition(),
-      .lights = {g_light},
-      .customShader =
-          g_shaderCache.get(Config::Renderer::DEFAULT_VERTEX_SHADER, Config::Renderer::DEFAULT_FRAGMENT_SHADER),
+      .viewportSize = glm::vec2(g_dynamicResolution.renderSize(displaySize())),
+      .inputTime = g_framePacer.getInputTime(),
   };
 }
 
-void renderLightIndicator() {
+void renderLightIndicator(const RenderContext &ctx) {
   auto model = glm::mat4(1.0f);
-  model = glm::translate(model, g_light.position);
+  model = glm::translate(model, g_entities.get<Light>(g_lightEntity)->position);
   model = glm::scale(model, glm::vec3(0.1f));
 
-  RenderContext renderContext = getDefaultRenderContext();
+  RenderContext renderContext = ctx;
 
   renderContext.modelMatrix = model;
-  renderContext.customShader = g_shaderCache.get("cube");
+  renderContext.customShader = g_shaderCache.get("cube").get();
 
   g_cube->render(renderContext);
 }
 
-void render3DModel() {
-  const RenderContext renderContext = getDefaultRenderContext();
-
-  g_model3d->render(renderContext);
-}
-
 void renderGrid() {
   const Shader &shader = *g_shaderCache.get("grid");
   shader.use();
@@ -187,13 +296,53 @@ void renderAxis() {
 void Window::renderOpenGlData() {
   // renderGrid();
   // renderAxis();
-  // renderLightIndicator();
-  render3DModel();
+  // renderLightIndicator(ctx);
+  const FramePacket &packet = g_framePipeline.prepareNow(getFrameView());
+  g_dynamicResolution.begin(glm::ivec2(packet.view.viewportSize), displaySize());
+  FramePipeline::submit(packet);
+  g_dynamicResolution.end();
+}
+
+const FramePacket *Window::renderPipelinedOpenGlData(const FramePacket *acquired) {
+  // Serial frames are prepared here, pipelined ones start on the pipeline's thread and the packet acquired before is
+  // submitted meanwhile. Right after switching to pipelined frames neither exists, the last packet is drawn again.
+  const FramePacket *packet = g_framePipeline.prepare(getFrameView());
+
+  if (!packet) {
+    packet = acquired ? acquired : g_framePipeline.getLastPacket();
+  }
+
+  // The world goes offscreen at the size its packet was prepared for, ImGui stays at the display resolution
+  if (packet) {
+    g_dynamicResolution.begin(glm::ivec2(packet->view.viewportSize), displaySize());
+    const uint64_t allocationsBefore = AllocationCounter::threadAllocations();
+    FramePipeline::submit(*packet);
+    g_renderAllocations = AllocationCounter::threadAllocations() - allocationsBefore;
+    g_dynamicResolution.end();
+  }
+
+  return packet;
 }
 
 void Window::render() const {
-  g_camera.update();
+  {
+    PROFILE_SCOPE("Update");
+    g_camera.update();
+    g_simulation.setInput({.playerVelocity = g_camera.getMovementVelocity()});
+    g_simulation.update(g_time.deltaTime());
+    g_camera.setPosition(g_simulation.interpolate().playerPosition);
+  }
 
+  // Prepared during the last frame. Until it is done the world and the entities belong to the pipeline's thread
+  const FramePacket *acquired = g_framePipeline.acquire();
+
+  {
+    PROFILE_SCOPE("Update world");
+    g_world.update(g_camera.getPosition());
+    g_transforms.update();
+  }
+
+  PROFILE_SCOPE("Render");
   g_imguiManager.newFrame();
   g_imguiManager.populateFrame();
 
@@ -207,16 +356,197 @@ void Window::render() const {
   ImGui::Text("Position: %.2f, %.2f, %.2f", g_camera.getPosition().x, g_camera.getPosition().y,
               g_camera.getPosition().z);
 
+  if (const auto target = VoxelRaycaster::cast(g_world.getChunks(), {g_camera.getPosition(), g_camera.getFront(),
+                                                                     Config::World::PICK_DISTANCE})) {
+    ImGui::Text("Looking at: %d, %d, %d (face %d, %.2f away)", target->block.x, target->block.y, target->block.z,
+                static_cast<int>(target->face), target->distance);
+  } else {
+    ImGui::Text("Looking at: nothing");
+  }
+
+  ImGui::SeparatorText("Simulation");
+
+  if (int tickRate = g_simulation.getTickRate(); ImGui::SliderInt("Ticks per second", &tickRate, 1, 120)) {
+    g_simulation.setTickRate(tickRate);
+  }
+
+  if (bool threaded = g_simulation.isThreaded(); ImGui::Checkbox("Run on its own thread", &threaded)) {
+    g_simulation.setThreaded(threaded);
+  }
+
+  const SimulationStats simulationStats = g_simulation.getStats();
+  ImGui::Text("Ticks: %llu (%llu dropped)", static_cast<unsigned long long>(simulationStats.ticks),
+              static_cast<unsigned long long>(simulationStats.droppedTicks));
+  ImGui::Text("Last tick: %.3f ms", simulationStats.lastTickMs);
+
   ImGui::SeparatorText("Light");
-  ImGui::Text("Type: %s", g_light.typeStr());
-  ImGui::ColorEdit4("Color", glm::value_ptr(g_light.color));
-  ImGui::DragFloat3("Position", glm::value_ptr(g_light.position), 0.01);
-  ImGui::DragFloat3("Direction", glm::value_ptr(g_light.direction), 0.01);
+  Light &light = *g_entities.get<Light>(g_lightEntity);
+  ImGui::Text("Type: %s", light.typeStr());
+  ImGui::ColorEdit4("Color", glm::value_ptr(light.color));
+  ImGui::DragFloat3("Position", glm::value_ptr(light.position), 0.01);
+  ImGui::DragFloat3("Direction", glm::value_ptr(light.direction), 0.01);
+
+  static int torchCount = 0;
+  ImGui::SliderInt("Torches", &torchCount, 0, 4096);
+
+  if (ImGui::IsItemDeactivatedAfterEdit()) {
+    placeTorches(torchCount);
+  }
+
+  // Stats of the last packet, empty ones before the first frame
+  static const FramePacket noPacket(0);
+  const FramePacket &lastPacket = g_framePipeline.getLastPacket() ? *g_framePipeline.getLastPacket() : noPacket;
+
+  const LightClusterStats &clusterStats = lastPacket.lights.stats;
+  ImGui::Text("Lights: %zu (%zu culled)", clusterStats.lights, clusterStats.culledLights);
+  ImGui::Text("Cluster assignments: %zu (%zu dropped), busiest cluster %zu", clusterStats.assignments,
+              clusterStats.droppedAssignments, clusterStats.busiestCluster);
+
+  ImGui::SeparatorText("Sun");
+
+  if (bool shadows = g_shadowMaps.isEnabled(); ImGui::Checkbox("Shadows", &shadows)) {
+    g_shadowMaps.setEnabled(shadows);
+  }
+
+  ImGui::DragFloat3("Sun direction", glm::value_ptr(g_shadowMaps.getSun().direction), 0.01f, -1.0f, 1.0f);
+
+  const ShadowStats &shadowStats = lastPacket.shadows.stats;
+  ImGui::Text("Cascades redrawn: %zu / %d", shadowStats.redrawnCascades, Config::Renderer::SHADOW_CASCADES);
+  ImGui::Text("Shadow casters: %zu chunks, %zu meshes", shadowStats.casterChunks, shadowStats.casterMeshes);
+
+  ImGui::SeparatorText("Entities");
+  ImGui::Text("Entities: %zu", g_entities.size());
+  ImGui::Text("Drawn: %zu (%zu culled)", lastPacket.entityStats.drawnEntities, lastPacket.entityStats.culledEntities);
+
+  ImGui::SeparatorText("World");
+  const WorldStats &worldStats = g_world.getStats();
+  const WorldCullStats &cullStats = lastPacket.worldStats;
+  ImGui::Text("Loaded chunks: %zu", worldStats.loadedChunks);
+
+  if (bool caveCulling = g_world.isCaveCullingEnabled(); ImGui::Checkbox("Cave culling", &caveCulling)) {
+    g_world.setCaveCulling(caveCulling);
+  }
+
+  ImGui::Text("Visible chunks: %zu / %zu", cullStats.renderedChunks, cullStats.meshedChunks);
+  ImGui::Text("Culled chunks: %zu frustum, %zu cave, %zu occluded", cullStats.frustumCulledChunks,
+              cullStats.caveCulledChunks, cullStats.occlusionCulledChunks);
+  ImGui::Text("Chunks per LOD: %zu / %zu / %zu / %zu", cullStats.renderedChunksPerLod[0],
+              cullStats.renderedChunksPerLod[1], cullStats.renderedChunksPerLod[2],
+              cullStats.renderedChunksPerLod[3]);
+  ImGui::Text("Triangles: %zu", cullStats.renderedTriangles);
+  ImGui::Text("Remeshed chunks: %zu", worldStats.remeshedChunks);
+  ImGui::Text("Block edits: %zu", worldStats.appliedEdits);
+  ImGui::Text("Edit to visible: %.2f ms (max %.2f ms)", worldStats.lastEditLatencyMs, worldStats.maxEditLatencyMs);
+
+  ImGui::SeparatorText("Occlusion");
+
+  if (bool occlusion = g_occlusionCuller.isEnabled(); ImGui::Checkbox("Occlusion culling", &occlusion)) {
+    g_occlusionCuller.setEnabled(occlusion);
+  }
+
+  const OcclusionStats &occlusionStats = lastPacket.occlusionStats;
+  ImGui::Text("Occluder triangles: %zu", occlusionStats.occluderTriangles);
+  ImGui::Text("Occluded boxes: %zu / %zu", occlusionStats.occludedBoxes, occlusionStats.testedBoxes);
 
   ImGui::SeparatorText("Renderer");
   ImGui::ColorEdit3("Clear Color", Config::Window::CLEAR_COLOR);
+
+  if (bool pipelined = g_framePipeline.isPipelined(); ImGui::Checkbox("Pipelined frames", &pipelined)) {
+    g_framePipeline.setPipelined(pipelined);
+  }
+
+  if (bool deferred = g_deferredRenderer.isEnabled(); ImGui::Checkbox("Deferred shading", &deferred)) {
+    g_deferredRenderer.setEnabled(deferred);
+  }
+
+  if (bool prepass = g_depthPrepass.isEnabled(); ImGui::Checkbox("Depth pre-pass", &prepass)) {
+    g_depthPrepass.setEnabled(prepass);
+  }
+
+  if (bool overdraw = g_overdrawHeatmap.isEnabled(); ImGui::Checkbox("Overdraw heatmap", &overdraw)) {
+    g_overdrawHeatmap.setEnabled(overdraw);
+  }
+
+  if (g_overdrawHeatmap.isEnabled()) {
+    ImGui::Text("Overdraw: %.2f fragments per pixel", g_overdrawHeatmap.getAverageOverdraw());
+  }
+
+  if (bool dynamic = g_dynamicResolution.isEnabled(); ImGui::Checkbox("Dynamic resolution", &dynamic)) {
+    g_dynamicResolution.setEnabled(dynamic);
+  }
+
+  if (float targetMs = g_dynamicResolution.getTargetMs();
+      ImGui::SliderFloat("GPU target (ms)", &targetMs, 2.0f, 33.0f)) {
+    g_dynamicResolution.setTargetMs(targetMs);
+  }
+
+  const glm::ivec2 renderSize = g_dynamicResolution.renderSize(displaySize());
+  ImGui::Text("World: %dx%d (%.0f%%), GPU %.2f ms", renderSize.x, renderSize.y, g_dynamicResolution.getScale() * 100.0f,
+              g_dynamicResolution.getGpuMs());
+
+  ImGui::SeparatorText("Presentation");
+
+  if (const PresentMode mode = g_framePacer.getMode(); ImGui::BeginCombo("Mode", presentModeName(mode))) {
+    for (std::size_t i = 0; i < PRESENT_MODE_COUNT; i++) {
+      const auto option = static_cast<PresentMode>(i);
+
+      if (ImGui::Selectable(presentModeName(option), option == mode)) {
+        setPresentMode(option);
+      }
+    }
+
+    ImGui::EndCombo();
+  }
+
+  if (int limit = g_framePacer.getFrameRateLimit(); ImGui::SliderInt("Frame rate limit", &limit, 20, 360)) {
+    g_framePacer.setFrameRateLimit(limit);
+  }
+
+  ImGui::Text("Paced: %.3f ms before sampling input", g_framePacer.getWaitMs());
+
+  if (ImGui::BeginTable("Latency", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedFit)) {
+    ImGui::TableSetupColumn("Input to submit");
+    ImGui::TableSetupColumn("Last (ms)");
+    ImGui::TableSetupColumn("Average (ms)");
+    ImGui::TableSetupColumn("Max (ms)");
+    ImGui::TableHeadersRow();
+
+    for (std::size_t i = 0; i < PRESENT_MODE_COUNT; i++) {
+      const FrameLatencyStats &latency = g_framePacer.getLatency(static_cast<PresentMode>(i));
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(presentModeName(static_cast<PresentMode>(i)));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", latency.lastMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", latency.averageMs);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.2f", latency.maxMs);
+    }
+
+    ImGui::EndTable();
+  }
+
+  if (ImGui::Button("Reset latency")) {
+    g_framePacer.resetLatency();
+  }
+
+  ImGui::SeparatorText("Frame pipeline");
+  const FramePipelineStats &pipelineStats = g_framePipeline.getStats();
+  ImGui::Text("Prepare: %.3f ms, waited %.3f ms", pipelineStats.prepareMs, pipelineStats.waitMs);
+
+  const FrameArenaStats &arenaStats = lastPacket.arena.getStats();
+  ImGui::Text("Packet arena: %.1f / %.1f KiB (%zu spilled)", static_cast<float>(arenaStats.usedBytes) / 1024.0f,
+              static_cast<float>(arenaStats.capacityBytes) / 1024.0f, arenaStats.spilledAllocations);
+
+  if constexpr (AllocationCounter::ENABLED) {
+    ImGui::Text("Heap allocations while submitting: %llu", static_cast<unsigned long long>(g_renderAllocations));
+  }
   ImGui::End();
 
+  g_profiler.renderPanel();
+  MemoryAccounting::renderPanel();
+
   ImGui::Render();
 
   auto [width, height] = g_imguiManager.io().DisplaySize;
@@ -226,9 +556,19 @@ void Window::render() const {
   glClearColor(r, g, b, 1.0f);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  renderOpenGlData();
+  const FramePacket *packet = renderPipelinedOpenGlData(acquired);
+
+  {
+    PROFILE_GPU_SCOPE("ImGui");
+    g_imguiManager.renderFrame();
+  }
+
+  {
+    PROFILE_SCOPE("Present");
+    SDL_GL_SwapWindow(m_sdlWindow);
+  }
 
-  g_imguiManager.renderFrame();
-  SDL_GL_SwapWindow(m_sdlWindow);
+  // Pipelined frames submit the packet prepared last frame, their latency counts from that frame's input
+  g_framePacer.endFrame(packet ? std::optional(packet->view.inputTime) : std::nullopt);
 }
 } // namespace App
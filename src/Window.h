@@ -4,17 +4,25 @@
 
 namespace App {
 
+struct FramePacket;
+
 struct Window {
   SDL_AppResult setup();
   static SDL_AppResult processEvent(const SDL_Event *event);
   void dispose();
   void render() const;
 
+  /// Loads the scene content, needs a current OpenGL context.
+  static void setupScene();
+  /// Draws the scene into the bound framebuffer, without UI.
+  static void renderOpenGlData();
+  /// Like `renderOpenGlData`, in the pipeline's current mode: pipelined, submits `acquired` (from the
+  /// `FramePipeline::acquire` of this frame) while the next packet is prepared. Returns the packet submitted.
+  static const FramePacket *renderPipelinedOpenGlData(const FramePacket *acquired);
+
 private:
   SDL_Window *m_sdlWindow = nullptr;
   SDL_Renderer *m_sdlRenderer = nullptr;
   SDL_GLContext m_glContext = nullptr;
-
-  static void renderOpenGlData();
 };
 } // namespace App
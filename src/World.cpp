@@ -0,0 +1,575 @@
+#include "World.h"
+
+#include <algorithm>
+
+#include "ChunkMesher.h"
+#include "ClusteredLighting.h"
+#include "Config.h"
+#include "Container.h"
+#include "ShadowMaps.h"
+
+namespace App {
+
+using namespace Config::World;
+
+World::World() : m_generator(SEED) {
+  for (int z = -VIEW_DISTANCE; z <= VIEW_DISTANCE; z++) {
+    for (int x = -VIEW_DISTANCE; x <= VIEW_DISTANCE; x++) {
+      if (x * x + z * z <= VIEW_DISTANCE * VIEW_DISTANCE) {
+        m_columnOffsets.emplace_back(x, z);
+      }
+    }
+  }
+
+  std::ranges::sort(m_columnOffsets, {},
+                    [](const glm::ivec2 &offset) { return offset.x * offset.x + offset.y * offset.y; });
+}
+
+void World::update(const glm::vec3 &cameraPosition) {
+  // Whatever packet could still draw these was submitted by now
+  m_retiredMeshes.clear();
+  m_changedMeshes.clear();
+
+  const glm::ivec3 cameraChunk = ChunkMap::toChunkCoord(glm::ivec3(glm::floor(cameraPosition)));
+
+  if (cameraChunk != m_cameraChunk) {
+    m_cameraChunk = cameraChunk;
+    m_streamCursor = 0;
+    unloadFarChunks();
+  }
+
+  PROFILE_SCOPE("World::update");
+
+  applyEdits();
+
+  {
+    PROFILE_SCOPE("Stream chunks");
+    streamChunks();
+  }
+
+  selectLods(cameraPosition);
+
+  {
+    PROFILE_SCOPE("Rebuild meshes");
+    rebuildMeshes();
+  }
+
+  m_stats.loadedChunks = m_chunks.size();
+}
+
+WorldCullStats World::cull(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection, FrameArena &arena,
+                           std::pmr::vector<ChunkDraw> &draws, std::pmr::vector<Clock::time_point> &drawnEdits) {
+  PROFILE_SCOPE("World::cull");
+  const Frustum frustum(viewProjection);
+
+  {
+    PROFILE_SCOPE("Visibility");
+
+    if (m_caveCulling) {
+      collectVisibleChunks(cameraPosition, frustum);
+    } else {
+      collectChunksInFrustum(frustum);
+    }
+  }
+
+  {
+    PROFILE_SCOPE("Occlusion culling");
+    cullOccludedChunks(frustum, arena);
+  }
+
+  m_cullStats.renderedChunks = 0;
+  m_cullStats.renderedTriangles = 0;
+  m_cullStats.renderedChunksPerLod.fill(0);
+  draws.reserve(draws.size() + m_visibleChunks.size());
+
+  for (const glm::ivec3 &coord : m_visibleChunks) {
+    const ChunkRenderState &state = m_renderStates.at(coord);
+    draws.push_back({state.mesh.get(), coord});
+
+    m_cullStats.renderedChunks++;
+    m_cullStats.renderedTriangles += state.mesh->getIndexCount() / 3;
+    m_cullStats.renderedChunksPerLod[state.meshLod]++;
+  }
+
+  // Edited sections count as visible once the frame drawing their new mesh is submitted, culled or not
+  for (const glm::ivec3 &coord : m_editedMeshes) {
+    if (const auto state = m_renderStates.find(coord); state != m_renderStates.end() && state->second.pendingEdit) {
+      drawnEdits.push_back(*state->second.pendingEdit);
+      state->second.pendingEdit.reset();
+    }
+  }
+
+  m_editedMeshes.clear();
+  return m_cullStats;
+}
+
+void World::cullShadowCasters(const glm::mat4 &lightViewProjection, std::pmr::vector<ChunkDraw> &casters) const {
+  PROFILE_SCOPE("World::cullShadowCasters");
+  const Frustum frustum(lightViewProjection);
+
+  for (const auto &[coord, state] : m_renderStates) {
+    if (state.mesh && frustum.intersects(chunkBounds(coord))) {
+      casters.push_back({state.mesh.get(), coord});
+    }
+  }
+}
+
+void World::draw(const std::span<const ChunkDraw> draws, const RenderContext &ctx) {
+  PROFILE_SCOPE("World::draw");
+  Shader &shader = *g_shaderCache.get("chunk");
+  const auto [r, g, b] = Config::Window::CLEAR_COLOR;
+
+  shader.use();
+  shader.set("uView", ctx.viewMatrix);
+  shader.set("uProjection", ctx.projectionMatrix);
+  shader.set("uViewPosition", ctx.cameraPosition);
+  shader.set("uFogColor", glm::vec3(r, g, b));
+  shader.set("uFogEnd", static_cast<float>(VIEW_DISTANCE * Chunk::SIZE));
+
+  if (ctx.lighting) {
+    ctx.lighting->bind(shader);
+  }
+
+  if (ctx.shadows) {
+    ctx.shadows->bind(shader);
+  } else {
+    shader.set("uSun.direction", glm::normalize(Config::Renderer::SUN_DIRECTION));
+    shader.set("uSun.cascades", 0);
+  }
+
+  shader.set("uChunkOrigins", static_cast<int>(CHUNK_ORIGINS_TEXTURE_INDEX));
+  m_meshPool.bindOrigins();
+  glEnable(GL_CULL_FACE);
+
+  m_meshPool.drawLayer(draws, ChunkLayer::Opaque);
+  m_meshPool.drawLayer(draws, ChunkLayer::Translucent);
+
+  glDisable(GL_CULL_FACE);
+}
+
+void World::recordEditLatencies(const std::span<const Clock::time_point> drawnEdits) {
+  const Clock::time_point now = Clock::now();
+
+  for (const Clock::time_point editTime : drawnEdits) {
+    const float latency = std::chrono::duration<float, std::milli>(now - editTime).count();
+    m_stats.lastEditLatencyMs = latency;
+    m_stats.maxEditLatencyMs = std::max(m_stats.maxEditLatencyMs, latency);
+  }
+}
+
+void World::setBlock(const glm::ivec3 &worldPos, const BlockType type, const EditPriority priority) {
+  m_editQueue.push_back({worldPos, type, priority, Clock::now()});
+}
+
+int World::selectLod(const float distance, const int currentLod) {
+  int lod = 0;
+
+  while (lod < Chunk::MAX_LOD && distance >= LOD_DISTANCES[lod]) {
+    lod++;
+  }
+
+  if (currentLod >= 0 && lod != currentLod) {
+    // Only the boundary between the two levels matters, stay on the current level while close to it
+    const float boundary = LOD_DISTANCES[std::min(lod, currentLod)];
+
+    if (std::abs(distance - boundary) < LOD_HYSTERESIS) {
+      return currentLod;
+    }
+  }
+
+  return lod;
+}
+
+void World::applyEdits() {
+  for (const auto &[position, type, priority, time] : m_editQueue) {
+    const glm::ivec3 coord = ChunkMap::toChunkCoord(position);
+    Chunk *chunk = m_chunks.find(coord);
+
+    if (!chunk) {
+      continue;
+    }
+
+    const glm::ivec3 local = ChunkMap::toLocalPos(position);
+    const BlockType previous = chunk->get(local.x, local.y, local.z);
+
+    if (previous == type) {
+      continue;
+    }
+
+    chunk->set(local.x, local.y, local.z, type);
+    m_stats.appliedEdits++;
+    markDirty(coord, priority, time);
+
+    // Blocks on the border also hide faces of the neighbouring section, which only needs a new mesh if one of
+    // those faces appears or disappears
+    for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+      const glm::ivec3 across = local + BLOCK_FACE_NORMALS[face];
+
+      if (across.x >= 0 && across.y >= 0 && across.z >= 0 && across.x < Chunk::SIZE && across.y < Chunk::SIZE &&
+          across.z < Chunk::SIZE) {
+        continue;
+      }
+
+      const glm::ivec3 neighbourCoord = coord + BLOCK_FACE_NORMALS[face];
+      const auto neighbourState = m_renderStates.find(neighbourCoord);
+
+      // Coarse meshes and open faces never look across the border
+      if (neighbourState == m_renderStates.end() || neighbourState->second.meshLod != 0 ||
+          neighbourState->second.meshOpenFaces & faceBit(oppositeFace(static_cast<BlockFace>(face)))) {
+        continue;
+      }
+
+      const BlockType neighbour = m_chunks.getBlock(position + BLOCK_FACE_NORMALS[face]);
+      auto hidesNeighbourFace = [&](const BlockType block) { return isOpaque(block) || block == neighbour; };
+
+      if (isSolid(neighbour) && hidesNeighbourFace(previous) != hidesNeighbourFace(type)) {
+        markDirty(neighbourCoord, priority, time);
+      }
+    }
+
+    // Baked ambient occlusion also sees the block from faces next to it, across edges and corners too
+    if (BAKED_AMBIENT_OCCLUSION && isOpaque(previous) != isOpaque(type)) {
+      for (int z = -1; z <= 1; z++) {
+        for (int y = -1; y <= 1; y++) {
+          for (int x = -1; x <= 1; x++) {
+            const glm::ivec3 neighbourCoord = ChunkMap::toChunkCoord(position + glm::ivec3(x, y, z));
+            const auto neighbourState = m_renderStates.find(neighbourCoord);
+
+            if (neighbourCoord != coord && neighbourState != m_renderStates.end() &&
+                neighbourState->second.meshLod == 0) {
+              markDirty(neighbourCoord, priority, time);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  m_editQueue.clear();
+}
+
+void World::markDirty(const glm::ivec3 &coord, const EditPriority priority, const Clock::time_point editTime) {
+  // Sections left without blocks keep whatever state they had, an empty chunk has nothing to mesh
+  if (const Chunk *chunk = m_chunks.find(coord); !chunk || chunk->isEmpty()) {
+    return;
+  }
+
+  ChunkRenderState &state = m_renderStates[coord];
+  state.dirty = true;
+  state.urgent |= priority == EditPriority::Immediate;
+
+  if (!state.pendingEdit) {
+    state.pendingEdit = editTime;
+  }
+}
+
+void World::retireMesh(ChunkRenderState &state) {
+  if (state.mesh) {
+    m_retiredMeshes.push_back(std::move(state.mesh));
+  }
+}
+
+void World::streamChunks() {
+  int generated = 0;
+
+  while (m_streamCursor < m_columnOffsets.size() && generated < GENERATE_BUDGET_PER_FRAME) {
+    const glm::ivec2 column = glm::ivec2(m_cameraChunk.x, m_cameraChunk.z) + m_columnOffsets[m_streamCursor++];
+
+    if (isColumnLoaded(column.x, column.y)) {
+      continue;
+    }
+
+    for (int y = MIN_CHUNK_Y; y <= MAX_CHUNK_Y; y++) {
+      m_generator.generate(m_chunks.getOrCreate({column.x, y, column.y}));
+    }
+
+    generated++;
+  }
+}
+
+void World::unloadFarChunks() {
+  constexpr int unloadDistance = VIEW_DISTANCE + 1;
+  std::vector<glm::ivec3> farChunks;
+
+  for (const auto &[coord, chunk] : m_chunks) {
+    const int dx = coord.x - m_cameraChunk.x;
+    const int dz = coord.z - m_cameraChunk.z;
+
+    if (dx * dx + dz * dz > unloadDistance * unloadDistance) {
+      farChunks.push_back(coord);
+    }
+  }
+
+  for (const glm::ivec3 &coord : farChunks) {
+    m_chunks.erase(coord);
+
+    if (const auto state = m_renderStates.find(coord); state != m_renderStates.end()) {
+      if (state->second.mesh) {
+        m_changedMeshes.push_back(coord);
+      }
+
+      retireMesh(state->second);
+      m_renderStates.erase(state);
+    }
+  }
+}
+
+void World::selectLods(const glm::vec3 &cameraPosition) {
+  for (const auto &[coord, chunk] : m_chunks) {
+    if (chunk->isEmpty()) {
+      continue;
+    }
+
+    ChunkRenderState &state = m_renderStates[coord];
+    const glm::vec3 center = glm::vec3(chunk->getWorldOrigin()) + glm::vec3(Chunk::SIZE / 2.0f);
+
+    state.distance = glm::length(center - cameraPosition) / static_cast<float>(Chunk::SIZE);
+    state.lod = selectLod(state.distance, state.lod);
+  }
+}
+
+void World::rebuildMeshes() {
+  struct PendingMesh {
+    float distance;
+    glm::ivec3 coord;
+    uint8_t openFaces;
+    bool urgent;
+  };
+
+  std::vector<PendingMesh> pending;
+  std::size_t urgentCount = 0;
+
+  for (const auto &[coord, state] : m_renderStates) {
+    const uint8_t openFaces = openFacesFor(coord, state.lod);
+
+    if (!state.dirty && state.meshLod == state.lod && state.meshOpenFaces == openFaces) {
+      continue;
+    }
+
+    // Wait for the neighbours so the boundary faces are culled (and corners occluded) against real data
+    if (!hasHorizontalNeighbours(coord)) {
+      continue;
+    }
+
+    pending.push_back({state.distance, coord, openFaces, state.urgent});
+    urgentCount += state.urgent;
+  }
+
+  // Urgent sections go first and do not count against the budget
+  const auto budget = std::min(pending.size(), static_cast<std::size_t>(MESH_BUDGET_PER_FRAME) + urgentCount);
+  std::ranges::partial_sort(pending, pending.begin() + static_cast<std::ptrdiff_t>(budget), {},
+                            [](const PendingMesh &mesh) { return std::pair(!mesh.urgent, mesh.distance); });
+
+  for (std::size_t i = 0; i < budget; i++) {
+    const auto &[distance, coord, openFaces, urgent] = pending[i];
+    ChunkRenderState &state = m_renderStates[coord];
+
+    // The previous mesh stays on screen until its replacement is ready, so LOD switches never leave holes
+    ChunkMeshData data = ChunkMesher::build(m_chunks, *m_chunks.find(coord), state.lod, openFaces);
+
+    if (data.indices.empty()) {
+      retireMesh(state);
+    } else if (state.mesh) {
+      state.mesh->update(data);
+    } else {
+      state.mesh = std::make_unique<ChunkMesh>(m_meshPool, coord, data);
+    }
+
+    m_changedMeshes.push_back(coord);
+    state.dirty = false;
+    state.urgent = false;
+
+    if (state.pendingEdit) {
+      m_editedMeshes.push_back(coord);
+    }
+
+    state.meshLod = state.lod;
+    state.meshOpenFaces = openFaces;
+    state.connectivity = data.connectivity;
+    state.solidLayers = data.solidLayers;
+  }
+
+  m_stats.remeshedChunks = budget;
+}
+
+void World::collectVisibleChunks(const glm::vec3 &cameraPosition, const Frustum &frustum) {
+  // Breadth-first walk from the camera chunk that only leaves a chunk through faces connected to the one it came in
+  // by, and never turns back. Chunks behind terrain or on the other side of a cave wall are never reached.
+  m_visibleChunks.clear();
+  m_visibilityQueue.clear();
+  m_visitedChunks.clear();
+
+  glm::ivec3 start = ChunkMap::toChunkCoord(glm::ivec3(glm::floor(cameraPosition)));
+  start.y = std::clamp(start.y, MIN_CHUNK_Y - 1, MAX_CHUNK_Y + 1);
+
+  m_visibilityQueue.push_back({start, -1, 0});
+  m_visitedChunks.insert(start);
+
+  std::size_t meshedChunks = 0;
+  std::size_t frustumCulledChunks = 0;
+
+  for (const auto &[coord, state] : m_renderStates) {
+    if (state.mesh) {
+      meshedChunks++;
+
+      if (!frustum.intersects(chunkBounds(coord))) {
+        frustumCulledChunks++;
+      }
+    }
+  }
+
+  for (std::size_t head = 0; head < m_visibilityQueue.size(); head++) {
+    const VisibilityStep step = m_visibilityQueue[head];
+
+    if (const auto state = m_renderStates.find(step.coord); state != m_renderStates.end() && state->second.mesh) {
+      m_visibleChunks.push_back(step.coord);
+    }
+
+    const VisibilityMask connectivity = connectivityOf(step.coord);
+
+    for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+      const auto exitFace = static_cast<BlockFace>(face);
+
+      if (step.directions & faceBit(oppositeFace(exitFace))) {
+        continue;
+      }
+
+      if (step.enteredFace >= 0 &&
+          !areFacesConnected(connectivity, static_cast<BlockFace>(step.enteredFace), exitFace)) {
+        continue;
+      }
+
+      const glm::ivec3 next = step.coord + BLOCK_FACE_NORMALS[face];
+
+      // Above and below the generated range the search continues through implicit air, so a camera flying over
+      // the terrain still sees it
+      if (next.y < MIN_CHUNK_Y - 1 || next.y > MAX_CHUNK_Y + 1 || !isColumnLoaded(next.x, next.z)) {
+        continue;
+      }
+
+      if (m_visitedChunks.contains(next) || !frustum.intersects(chunkBounds(next))) {
+        continue;
+      }
+
+      m_visitedChunks.insert(next);
+      m_visibilityQueue.push_back(
+          {next, static_cast<int>(oppositeFace(exitFace)), static_cast<uint8_t>(step.directions | faceBit(exitFace))});
+    }
+  }
+
+  m_cullStats.meshedChunks = meshedChunks;
+  m_cullStats.frustumCulledChunks = frustumCulledChunks;
+  // The camera chunk is walked even when it falls outside the frustum, so it may be counted on both sides
+  const std::size_t inFrustumChunks = meshedChunks - frustumCulledChunks;
+  m_cullStats.caveCulledChunks = inFrustumChunks - std::min(inFrustumChunks, m_visibleChunks.size());
+}
+
+void World::collectChunksInFrustum(const Frustum &frustum) {
+  m_visibleChunks.clear();
+  m_cullStats.meshedChunks = 0;
+  m_cullStats.frustumCulledChunks = 0;
+  m_cullStats.caveCulledChunks = 0;
+
+  for (const auto &[coord, state] : m_renderStates) {
+    if (!state.mesh) {
+      continue;
+    }
+
+    m_cullStats.meshedChunks++;
+
+    if (frustum.intersects(chunkBounds(coord))) {
+      m_visibleChunks.push_back(coord);
+    } else {
+      m_cullStats.frustumCulledChunks++;
+    }
+  }
+}
+
+void World::cullOccludedChunks(const Frustum &frustum, FrameArena &arena) {
+  OcclusionCuller &culler = g_occlusionCuller;
+  m_cullStats.occlusionCulledChunks = 0;
+
+  if (!culler.isEnabled()) {
+    return;
+  }
+
+  // The solid slabs at the bottom of nearby chunks stand in for the terrain, nearest first since those cover the
+  // most screen
+  std::pmr::vector<std::pair<float, AABB>> occluders(&arena);
+
+  for (const auto &[coord, state] : m_renderStates) {
+    if (state.solidLayers == 0 || state.distance > OCCLUDER_DISTANCE) {
+      continue;
+    }
+
+    const glm::vec3 origin(coord * Chunk::SIZE);
+    const AABB slab{origin, origin + glm::vec3(Chunk::SIZE, state.solidLayers, Chunk::SIZE)};
+
+    if (frustum.intersects(slab)) {
+      occluders.emplace_back(state.distance, slab);
+    }
+  }
+
+  const auto occluderCount = std::min(occluders.size(), static_cast<std::size_t>(MAX_OCCLUDERS));
+  std::ranges::partial_sort(occluders, occluders.begin() + static_cast<std::ptrdiff_t>(occluderCount), {},
+                            &std::pair<float, AABB>::first);
+
+  for (std::size_t i = 0; i < occluderCount; i++) {
+    culler.addOccluder(occluders[i].second);
+  }
+
+  m_cullStats.occlusionCulledChunks = std::erase_if(m_visibleChunks, [&](const glm::ivec3 &coord) {
+    const glm::vec3 origin(coord * Chunk::SIZE);
+    const AABB &bounds = m_renderStates.at(coord).mesh->getBounds();
+    return !culler.isVisible({bounds.min + origin, bounds.max + origin});
+  });
+}
+
+bool World::isColumnLoaded(const int chunkX, const int chunkZ) const {
+  // Columns are generated as a whole, so the bottom chunk stands for the entire column
+  return m_chunks.find({chunkX, MIN_CHUNK_Y, chunkZ}) != nullptr;
+}
+
+bool World::hasHorizontalNeighbours(const glm::ivec3 &coord) const {
+  if (!isColumnLoaded(coord.x - 1, coord.z) || !isColumnLoaded(coord.x + 1, coord.z) ||
+      !isColumnLoaded(coord.x, coord.z - 1) || !isColumnLoaded(coord.x, coord.z + 1)) {
+    return false;
+  }
+
+  // Baked occlusion samples the diagonal columns too, and nothing remeshes the chunk once they load
+  return !BAKED_AMBIENT_OCCLUSION ||
+         (isColumnLoaded(coord.x - 1, coord.z - 1) && isColumnLoaded(coord.x + 1, coord.z - 1) &&
+          isColumnLoaded(coord.x - 1, coord.z + 1) && isColumnLoaded(coord.x + 1, coord.z + 1));
+}
+
+uint8_t World::openFacesFor(const glm::ivec3 &coord, const int lod) const {
+  if (lod > 0) {
+    return ALL_FACES_MASK;
+  }
+
+  // A full resolution chunk opens the sides it shares with coarser neighbours
+  uint8_t openFaces = 0;
+
+  for (int face = 0; face < BLOCK_FACE_COUNT; face++) {
+    const auto neighbour = m_renderStates.find(coord + BLOCK_FACE_NORMALS[face]);
+
+    if (neighbour != m_renderStates.end() && neighbour->second.lod > 0) {
+      openFaces |= faceBit(static_cast<BlockFace>(face));
+    }
+  }
+
+  return openFaces;
+}
+
+VisibilityMask World::connectivityOf(const glm::ivec3 &coord) const {
+  // Chunks without render state are empty (or outside the generated range) and thus fully connected
+  const auto state = m_renderStates.find(coord);
+  return state != m_renderStates.end() ? state->second.connectivity : ALL_FACES_CONNECTED;
+}
+
+AABB World::chunkBounds(const glm::ivec3 &coord) {
+  const glm::vec3 origin(coord * Chunk::SIZE);
+  return {origin, origin + glm::vec3(Chunk::SIZE)};
+}
+
+} // namespace App
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ChunkMap.h"
+#include "ChunkMeshPool.h"
+#include "ChunkVisibility.h"
+#include "FrameArena.h"
+#include "Frustum.h"
+#include "Mesh.h"
+#include "Renderable.h"
+#include "TerrainGenerator.h"
+
+namespace App {
+
+struct WorldStats {
+  std::size_t loadedChunks = 0;
+  std::size_t remeshedChunks = 0; // This frame
+  std::size_t appliedEdits = 0;   // Since startup
+  float lastEditLatencyMs = 0.0f;
+  float maxEditLatencyMs = 0.0f;
+};
+
+/// What `World::cull` found for one view.
+struct WorldCullStats {
+  std::size_t meshedChunks = 0;
+  std::size_t frustumCulledChunks = 0;
+  std::size_t caveCulledChunks = 0;
+  std::size_t occlusionCulledChunks = 0;
+  std::size_t renderedChunks = 0;
+  std::size_t renderedTriangles = 0;
+  std::array<std::size_t, Chunk::MAX_LOD + 1> renderedChunksPerLod{};
+};
+
+/// A chunk mesh picked by `World::cull`. It survives the next update, the one after that may free it.
+struct ChunkDraw {
+  const ChunkMesh *mesh;
+  glm::ivec3 coord;
+};
+
+enum class EditPriority : uint8_t {
+  Normal,
+  /// Remeshed before the next frame regardless of the meshing budget, for edits the player is looking at.
+  Immediate,
+};
+
+/// Streams chunks around the camera, keeps one mesh per chunk at the LOD its distance calls for and renders them.
+/// Culling only reads the chunks and meshes, so it can run on another thread as long as no update runs meanwhile.
+class World {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  World();
+
+  /// Streams, applies edits and builds meshes, GL thread only.
+  void update(const glm::vec3 &cameraPosition);
+
+  /// Appends the chunks worth drawing for a view to `draws`, and to `drawnEdits` the time of every edit whose mesh
+  /// those draws show for the first time. Also fills the occlusion culler, which must be in its frame already.
+  WorldCullStats cull(const glm::vec3 &cameraPosition, const glm::mat4 &viewProjection, FrameArena &arena,
+                      std::pmr::vector<ChunkDraw> &draws, std::pmr::vector<Clock::time_point> &drawnEdits);
+
+  /// Appends every meshed chunk inside a light's frustum to `casters`. Unlike `cull` nothing is hidden behind terrain,
+  /// a chunk out of sight can still shadow one in sight.
+  void cullShadowCasters(const glm::mat4 &lightViewProjection, std::pmr::vector<ChunkDraw> &casters) const;
+
+  /// Draws what a cull picked, one call per layer, GL thread only.
+  void draw(std::span<const ChunkDraw> draws, const RenderContext &ctx);
+
+  /// Takes the edit latencies once the frame showing them is submitted.
+  void recordEditLatencies(std::span<const Clock::time_point> drawnEdits);
+
+  /// Queues a block change, applied at the start of the next update. Every section touched by the edits of one
+  /// update is remeshed once, however many of its blocks changed. Positions outside loaded chunks are ignored.
+  void setBlock(const glm::ivec3 &worldPos, BlockType type, EditPriority priority = EditPriority::Normal);
+
+  [[nodiscard]] const ChunkMap &getChunks() const {
+    return m_chunks;
+  }
+
+  [[nodiscard]] const WorldStats &getStats() const {
+    return m_stats;
+  }
+
+  /// Chunks whose mesh the last update built, replaced or dropped, for caches of what the meshes looked like.
+  [[nodiscard]] std::span<const glm::ivec3> getChangedMeshes() const {
+    return m_changedMeshes;
+  }
+
+  /// World space box of a chunk.
+  [[nodiscard]] static AABB chunkBounds(const glm::ivec3 &coord);
+
+  /// True once every column around the camera is generated and the last update had no mesh to build.
+  [[nodiscard]] bool isSettled() const {
+    return m_streamCursor >= m_columnOffsets.size() && m_stats.remeshedChunks == 0;
+  }
+
+  [[nodiscard]] bool isCaveCullingEnabled() const {
+    return m_caveCulling;
+  }
+
+  void setCaveCulling(const bool enabled) {
+    m_caveCulling = enabled;
+  }
+
+  /// LOD level for a chunk `distance` chunks away from the camera, sticking to `currentLod` near the boundaries.
+  static int selectLod(float distance, int currentLod);
+
+private:
+  struct BlockEdit {
+    glm::ivec3 position;
+    BlockType type;
+    EditPriority priority;
+    Clock::time_point time;
+  };
+
+  struct ChunkRenderState {
+    std::unique_ptr<ChunkMesh> mesh;
+    int meshLod = -1; // -1 until the first mesh is built
+    uint8_t meshOpenFaces = 0;
+    int lod = -1;
+    float distance = 0.0f;
+    /// Conservatively fully connected until the first mesh reports the real value.
+    VisibilityMask connectivity = ALL_FACES_CONNECTED;
+    int solidLayers = 0;
+    /// Blocks changed since the mesh was built, and whether the new mesh has to skip the meshing queue.
+    bool dirty = false;
+    bool urgent = false;
+    /// Oldest edit not on screen yet.
+    std::optional<Clock::time_point> pendingEdit;
+  };
+
+  struct VisibilityStep {
+    glm::ivec3 coord;
+    int enteredFace;    // -1 for the camera chunk
+    uint8_t directions; // Faces crossed so far, the search never walks back through their opposites
+  };
+
+  ChunkMeshPool m_meshPool; // Outlives the meshes stored in it
+  ChunkMap m_chunks;
+  TerrainGenerator m_generator;
+  ChunkCoordMap<ChunkRenderState> m_renderStates;
+
+  /// Column offsets within the view distance, nearest first.
+  std::vector<glm::ivec2> m_columnOffsets;
+  std::size_t m_streamCursor = 0;
+  glm::ivec3 m_cameraChunk{std::numeric_limits<int>::max()};
+
+  bool m_caveCulling = true;
+  std::vector<glm::ivec3> m_visibleChunks;
+  std::vector<VisibilityStep> m_visibilityQueue;
+  std::unordered_set<glm::ivec3, ChunkCoordHash> m_visitedChunks;
+
+  std::vector<BlockEdit> m_editQueue;
+  std::vector<glm::ivec3> m_editedMeshes; // Rebuilt for an edit, their latency is taken once drawn
+
+  /// Meshes dropped by the last update. A packet culled before it may still draw them, so they live one more update.
+  std::vector<std::unique_ptr<ChunkMesh>> m_retiredMeshes;
+  std::vector<glm::ivec3> m_changedMeshes;
+
+  WorldStats m_stats;
+  WorldCullStats m_cullStats; // Only touched by cull
+
+  void applyEdits();
+  void markDirty(const glm::ivec3 &coord, EditPriority priority, Clock::time_point editTime);
+  void retireMesh(ChunkRenderState &state);
+  void streamChunks();
+  void unloadFarChunks();
+  void selectLods(const glm::vec3 &cameraPosition);
+  void rebuildMeshes();
+  void collectVisibleChunks(const glm::vec3 &cameraPosition, const Frustum &frustum);
+  void collectChunksInFrustum(const Frustum &frustum);
+  void cullOccludedChunks(const Frustum &frustum, FrameArena &arena);
+
+  [[nodiscard]] bool isColumnLoaded(int chunkX, int chunkZ) const;
+  [[nodiscard]] bool hasHorizontalNeighbours(const glm::ivec3 &coord) const;
+  [[nodiscard]] uint8_t openFacesFor(const glm::ivec3 &coord, int lod) const;
+  [[nodiscard]] VisibilityMask connectivityOf(const glm::ivec3 &coord) const;
+};
+
+} // namespace App
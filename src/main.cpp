@@ -23,8 +23,18 @@ SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event) {
 }
 
 SDL_AppResult SDL_AppIterate(void *appstate) {
-  g_time.update();
-  g_window.render();
+  g_profiler.beginFrame();
+
+  {
+    PROFILE_SCOPE("Frame");
+    g_time.update();
+    g_window.render();
+
+    // The events SDL hands over before the next iterate are that frame's input, the wait has to come before them
+    g_framePacer.waitForNextFrame();
+  }
+
+  g_profiler.endFrame();
 
   return SDL_APP_CONTINUE;
 }
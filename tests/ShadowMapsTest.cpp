@@ -0,0 +1,45 @@
+// Checks of ShadowMaps::plan that need no OpenGL context, run by ctest. Returns non-zero on the first failure.
+
+#include <cstdio>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../src/ShadowMaps.h"
+#include "../src/World.h"
+
+using namespace App;
+
+static bool check(const bool condition, const char *what) {
+  if (!condition) {
+    std::fprintf(stderr, "FAILED: %s\n", what);
+  }
+
+  return condition;
+}
+
+/// Terrain is lit by the planned sun direction whether or not it casts shadows, turning them off mustn't move it.
+static bool sunDirectionWithoutShadows() {
+  const World world;
+  Ecs::Registry entities;
+  FrameArena arena(1 << 20);
+  ShadowMaps shadows;
+
+  const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 80.0f, 0.0f), glm::vec3(1.0f, 80.0f, 0.0f), {0.0f, 1.0f, 0.0f});
+  const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, Config::Renderer::NEAR_PLANE,
+                                                Config::Renderer::FAR_PLANE);
+  const glm::vec3 expected = glm::normalize(Config::Renderer::SUN_DIRECTION);
+
+  shadows.setEnabled(true);
+  const glm::vec3 shadowed = shadows.plan(view, projection, world, entities, arena).sunDirection;
+
+  shadows.setEnabled(false);
+  const ShadowFrame unshadowed = shadows.plan(view, projection, world, entities, arena);
+
+  return check(glm::length(shadowed - expected) < 1e-5f, "the sun points at Config::Renderer::SUN_DIRECTION") &&
+         check(!unshadowed.enabled, "disabled shadows plan no cascades") &&
+         check(glm::length(unshadowed.sunDirection - expected) < 1e-5f, "disabled shadows keep the sun direction");
+}
+
+int main() {
+  return sunDirectionWithoutShadows() ? 0 : 1;
+}